@@ -0,0 +1,280 @@
+/*
+Allocator microbenchmarks, built by nob into bin/bench.elf.
+
+Each benchmark times a batch of operations per sample, after a few warm-up
+samples the per operation times are sorted and reported as one csv line:
+    name,param,samples,ops,min_ns,median_ns,p99_ns,mean_ns
+so runs can be diffed or loaded somewhere to catch regressions.
+min, median and mean are over the batch averages, a batch hides its slow
+operations so p99 comes from a second run timing every operation on its own
+(the clock read is included in those times).
+
+    $ ./bin/bench.elf [filter]
+filter only runs the benchmarks whose name contains it.
+*/
+#define BUN_IMPLEMENTATION
+#define BUN_STRIP_PREFIX
+#include "bun.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_WARMUP  8
+#define BENCH_SAMPLES 101
+#define BENCH_BATCH   1024
+
+#define BENCH_LEN(array) (sizeof(array) / sizeof((array)[0]))
+
+typedef struct
+{
+    const char *name;
+    USize param;
+    U32 ops;                        /*operations timed per sample*/
+    double samples[BENCH_SAMPLES];  /*ns per operation*/
+    double *latency;                /*set while every operation is timed on its own*/
+    U32 latency_count;
+} Bench;
+
+typedef USize (*Bench_Proc)(Bench *bench); /*returns the ns taken by bench->ops operations*/
+
+static void *bench_ptrs[BENCH_BATCH];
+static double bench_latency[BENCH_SAMPLES * BENCH_BATCH];
+
+static USize Bench_Now_Ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (USize)ts.tv_sec * 1000000000u + (USize)ts.tv_nsec;
+}
+
+/*
+Run *op* for i in [0, bench->ops), recording each one into bench->latency
+when set, the batch loop is left untouched otherwise.
+*/
+#define BENCH_LOOP(bench, i, op) \
+    do { \
+        if ((bench)->latency == NULL) { for (i = 0; i < (bench)->ops; i++) op; } \
+        else for (i = 0; i < (bench)->ops; i++) \
+        { \
+            USize op_start = Bench_Now_Ns(); \
+            op; \
+            (bench)->latency[(bench)->latency_count++] = (double)(Bench_Now_Ns() - op_start); \
+        } \
+    } while (0)
+
+static int Bench_Compare(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void Bench_Run(const char *filter, const char *name, USize param, U32 ops, Bench_Proc proc)
+{
+    Bench bench;
+    double p99;
+    double mean = 0;
+    U32 i;
+
+    if (filter != NULL && strstr(name, filter) == NULL) return;
+
+    bench.name = name;
+    bench.param = param;
+    bench.ops = ops;
+    bench.latency = NULL;
+    for (i = 0; i < BENCH_WARMUP; i++) proc(&bench);
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        bench.samples[i] = (double)proc(&bench) / (double)ops;
+        mean += bench.samples[i];
+    }
+    mean /= BENCH_SAMPLES;
+    qsort(bench.samples, BENCH_SAMPLES, sizeof(bench.samples[0]), Bench_Compare);
+
+    /*single operation samples already are per operation*/
+    if (ops == 1)
+    {
+        p99 = bench.samples[(BENCH_SAMPLES * 99) / 100];
+    }
+    else
+    {
+        bench.latency = bench_latency;
+        bench.latency_count = 0;
+        for (i = 0; i < BENCH_SAMPLES; i++) proc(&bench);
+        qsort(bench_latency, bench.latency_count, sizeof(bench_latency[0]), Bench_Compare);
+        p99 = bench_latency[((USize)bench.latency_count * 99) / 100];
+    }
+
+    printf("%s,%lu,%d,%u,%.2f,%.2f,%.2f,%.2f\n", name, (unsigned long)param, BENCH_SAMPLES, ops,
+           bench.samples[0],
+           bench.samples[BENCH_SAMPLES / 2],
+           p99,
+           mean);
+    fflush(stdout);
+}
+
+/* -- generic allocator, param is the allocation size -- */
+
+static USize Bench_Libc_Alloc(Bench *bench)
+{
+    USize start, end;
+    U32 i;
+    start = Bench_Now_Ns();
+    BENCH_LOOP(bench, i, bench_ptrs[i] = Allocator_Alloc((U32)bench->param, false, 16, &allocator_libc));
+    end = Bench_Now_Ns();
+    for (i = 0; i < bench->ops; i++) Allocator_Free(bench_ptrs[i], &allocator_libc);
+    return end - start;
+}
+
+static USize Bench_Libc_Alloc_Zeroed(Bench *bench)
+{
+    USize start, end;
+    U32 i;
+    start = Bench_Now_Ns();
+    BENCH_LOOP(bench, i, bench_ptrs[i] = Allocator_Alloc((U32)bench->param, true, 16, &allocator_libc));
+    end = Bench_Now_Ns();
+    for (i = 0; i < bench->ops; i++) Allocator_Free(bench_ptrs[i], &allocator_libc);
+    return end - start;
+}
+
+static USize Bench_Libc_Free(Bench *bench)
+{
+    USize start, end;
+    U32 i;
+    for (i = 0; i < bench->ops; i++) bench_ptrs[i] = Allocator_Alloc((U32)bench->param, false, 16, &allocator_libc);
+    start = Bench_Now_Ns();
+    BENCH_LOOP(bench, i, Allocator_Free(bench_ptrs[i], &allocator_libc));
+    end = Bench_Now_Ns();
+    return end - start;
+}
+
+/* grow every allocation to twice its size */
+static USize Bench_Libc_Resize(Bench *bench)
+{
+    USize start, end;
+    U32 i;
+    for (i = 0; i < bench->ops; i++) bench_ptrs[i] = Allocator_Alloc((U32)bench->param, false, 16, &allocator_libc);
+    start = Bench_Now_Ns();
+    BENCH_LOOP(bench, i, bench_ptrs[i] = Allocator_Resize(bench_ptrs[i], (U32)bench->param * 2, (U32)bench->param, false, 16, &allocator_libc));
+    end = Bench_Now_Ns();
+    for (i = 0; i < bench->ops; i++) Allocator_Free(bench_ptrs[i], &allocator_libc);
+    return end - start;
+}
+
+/* -- arena, param is the allocation size -- */
+
+static Arena bench_arena;
+
+static USize Bench_Arena_Alloc(Bench *bench)
+{
+    USize start, end;
+    U32 i;
+    Arena_Free_All(&bench_arena);
+    start = Bench_Now_Ns();
+    BENCH_LOOP(bench, i, bench_ptrs[i] = Arena_Alloc(bench->param, false, 8, &bench_arena));
+    end = Bench_Now_Ns();
+    return end - start;
+}
+
+static USize Bench_Arena_Alloc_Inline(Bench *bench)
+{
+    USize start, end;
+    U32 i;
+    Arena_Free_All(&bench_arena);
+    start = Bench_Now_Ns();
+    BENCH_LOOP(bench, i, bench_ptrs[i] = Arena_Alloc_Inline(bench->param, false, 8, &bench_arena));
+    end = Bench_Now_Ns();
+    return end - start;
+}
+
+/* -- dynamic arena, param is the number of pools -- */
+
+#define BENCH_POOL_SIZE 4096
+#define BENCH_POOL_FILL (BENCH_POOL_SIZE - 96) /*leaves a gap too small for the timed allocations*/
+#define BENCH_DYNAMIC_SIZE 128
+
+/* an arena with param pools, all full but for a small gap at the end */
+static void Bench_Dynamic_Arena_Fill(Dynamic_Arena *arena, USize pools)
+{
+    USize i;
+    Dynamic_Arena_Init(arena, &allocator_libc, BENCH_POOL_SIZE, false, 8);
+    for (i = 0; i < pools; i++) Dynamic_Arena_Alloc_Push(BENCH_POOL_FILL, false, 8, arena);
+}
+
+static USize Bench_Dynamic_Arena_Push(Bench *bench)
+{
+    Dynamic_Arena arena;
+    USize start, end;
+    U32 i;
+    Bench_Dynamic_Arena_Fill(&arena, bench->param);
+    start = Bench_Now_Ns();
+    BENCH_LOOP(bench, i, bench_ptrs[i] = Dynamic_Arena_Alloc_Push(BENCH_DYNAMIC_SIZE, false, 8, &arena));
+    end = Bench_Now_Ns();
+    Dynamic_Arena_Deinit(&arena);
+    return end - start;
+}
+
+static USize Bench_Dynamic_Arena_Insert(Bench *bench)
+{
+    Dynamic_Arena arena;
+    USize start, end;
+    U32 i;
+    Bench_Dynamic_Arena_Fill(&arena, bench->param);
+    start = Bench_Now_Ns();
+    BENCH_LOOP(bench, i, bench_ptrs[i] = Dynamic_Arena_Alloc_Insert(BENCH_DYNAMIC_SIZE, false, 8, &arena));
+    end = Bench_Now_Ns();
+    Dynamic_Arena_Deinit(&arena);
+    return end - start;
+}
+
+/* -- dynamic arena reset, param is the number of pools, one op per sample -- */
+
+static USize Bench_Dynamic_Arena_Reset(Bench *bench, bool free_pools, bool zero_pools)
+{
+    Dynamic_Arena arena;
+    USize start, end;
+    Bench_Dynamic_Arena_Fill(&arena, bench->param);
+    start = Bench_Now_Ns();
+    if (free_pools) Dynamic_Arena_Free_Pools(&arena, 1, zero_pools);
+    else            Dynamic_Arena_Free_All(&arena, zero_pools);
+    end = Bench_Now_Ns();
+    Dynamic_Arena_Deinit(&arena);
+    return end - start;
+}
+static USize Bench_Dynamic_Arena_Free_All(Bench *bench)        { return Bench_Dynamic_Arena_Reset(bench, false, false); }
+static USize Bench_Dynamic_Arena_Free_All_Zero(Bench *bench)   { return Bench_Dynamic_Arena_Reset(bench, false, true); }
+static USize Bench_Dynamic_Arena_Free_Pools(Bench *bench)      { return Bench_Dynamic_Arena_Reset(bench, true, false); }
+static USize Bench_Dynamic_Arena_Free_Pools_Zero(Bench *bench) { return Bench_Dynamic_Arena_Reset(bench, true, true); }
+
+int main(int argc, char **argv)
+{
+    static const USize sizes[] = { 16, 256, 4096, 65536 };
+    static const USize pool_counts[] = { 1, 8, 64, 512 };
+    const char *filter = argc > 1 ? argv[1] : NULL;
+    U32 i;
+
+    Arena_Init_From_Allocator(&bench_arena, &allocator_libc, BENCH_BATCH * (65536 + 8), false, 8);
+
+    printf("name,param,samples,ops,min_ns,median_ns,p99_ns,mean_ns\n");
+    for (i = 0; i < BENCH_LEN(sizes); i++)
+    {
+        Bench_Run(filter, "libc_alloc",        sizes[i], BENCH_BATCH, Bench_Libc_Alloc);
+        Bench_Run(filter, "libc_alloc_zeroed", sizes[i], BENCH_BATCH, Bench_Libc_Alloc_Zeroed);
+        Bench_Run(filter, "libc_free",         sizes[i], BENCH_BATCH, Bench_Libc_Free);
+        Bench_Run(filter, "libc_resize",       sizes[i], BENCH_BATCH, Bench_Libc_Resize);
+        Bench_Run(filter, "arena_alloc",        sizes[i], BENCH_BATCH, Bench_Arena_Alloc);
+        Bench_Run(filter, "arena_alloc_inline", sizes[i], BENCH_BATCH, Bench_Arena_Alloc_Inline);
+    }
+    for (i = 0; i < BENCH_LEN(pool_counts); i++)
+    {
+        Bench_Run(filter, "dynamic_arena_push",   pool_counts[i], BENCH_BATCH, Bench_Dynamic_Arena_Push);
+        Bench_Run(filter, "dynamic_arena_insert", pool_counts[i], BENCH_BATCH, Bench_Dynamic_Arena_Insert);
+        Bench_Run(filter, "dynamic_arena_free_all",        pool_counts[i], 1, Bench_Dynamic_Arena_Free_All);
+        Bench_Run(filter, "dynamic_arena_free_all_zero",   pool_counts[i], 1, Bench_Dynamic_Arena_Free_All_Zero);
+        Bench_Run(filter, "dynamic_arena_free_pools",      pool_counts[i], 1, Bench_Dynamic_Arena_Free_Pools);
+        Bench_Run(filter, "dynamic_arena_free_pools_zero", pool_counts[i], 1, Bench_Dynamic_Arena_Free_Pools_Zero);
+    }
+
+    Arena_Deinit_From_Allocator(&bench_arena, &allocator_libc);
+    return 0;
+}
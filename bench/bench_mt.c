@@ -0,0 +1,487 @@
+/*
+Multi threaded allocator benchmarks, built by nob into bin/bench_mt.elf (linux).
+
+Patterns:
+    threadtest - each thread allocates a batch of objects and frees them, no sharing.
+    larson     - each thread replaces random objects in a set it holds, the
+                 sets rotate between threads every round so most frees are
+                 of objects allocated by another thread.
+    prodcons   - producer threads allocate messages, their consumer threads
+                 free them (threads are paired, only even counts run).
+Setups:
+    libc         - bun_allocator_libc shared by every thread.
+    numa         - a node local numa allocator shared by every thread.
+    ring_remote  - a ring allocator per thread behind a remote free allocator.
+    arena        - a dynamic arena per thread, reset instead of freed.
+Setups only run the patterns they can do (ring allocators stall on larsons
+random frees, arenas can not take frees at all).
+
+Every run is a forked process, so its rss is not skewed by earlier runs,
+and prints one csv line:
+    pattern,setup,threads,seconds,ops,ops_per_sec,scaling,peak_live_bytes,peak_rss_bytes,fragmentation
+scaling is ops_per_sec over the ops_per_sec of the fewest threads of the
+pattern and setup, fragmentation is peak rss growth over peak live bytes.
+
+    $ ./bin/bench_mt.elf [max_threads] [seconds_per_run]
+*/
+#define BUN_IMPLEMENTATION
+#define BUN_STRIP_PREFIX
+#include "bun.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define BENCH_THREADTEST_BATCH 1024
+#define BENCH_THREADTEST_SIZE  64
+#define BENCH_LARSON_SLOTS     1024
+#define BENCH_LARSON_ROUND     4096 /*replacements per round*/
+#define BENCH_LARSON_MIN_SIZE  16
+#define BENCH_LARSON_MAX_SIZE  512
+#define BENCH_QUEUE_SIZE       1024 /*power of 2*/
+#define BENCH_MESSAGE_SIZE     64
+#define BENCH_MAX_THREADS      256
+
+enum
+{
+    BENCH_THREADTEST = (1<<0),
+    BENCH_LARSON     = (1<<1),
+    BENCH_PRODCONS   = (1<<2),
+};
+
+typedef struct Bench_Thread Bench_Thread;
+
+typedef struct
+{
+    const char *name;
+    U32 patterns; /*patterns the setup can run*/
+    void  (*thread_init)(Bench_Thread *thread);
+    void  (*thread_deinit)(Bench_Thread *thread);
+    void *(*alloc)(Bench_Thread *thread, USize size);
+    void  (*free)(Bench_Thread *owner, void *ptr); /*called from any thread*/
+    void  (*reset)(Bench_Thread *thread);          /*frees everything the thread allocated, NULL if not needed*/
+} Bench_Setup;
+
+typedef struct
+{
+    void *ptr;
+    USize size;
+    Bench_Thread *owner;
+} Bench_Slot;
+
+/* single producer single consumer queue */
+typedef struct
+{
+    void *items[BENCH_QUEUE_SIZE];
+    U32 head; /*written by the producer*/
+    U32 tail; /*written by the consumer*/
+} Bench_Queue;
+
+struct Bench_Thread
+{
+    pthread_t handle;
+    U32 index;
+    const Bench_Setup *setup;
+    U64 rng;
+    USize ops;
+    USize live; /*bytes allocated minus bytes freed by this thread, read by the sampler*/
+
+    Bench_Thread *peer; /*the producer of a consumer*/
+    Bench_Queue *queue;
+
+    Ring_Allocator ring;
+    Allocator ring_allocator;
+    Remote_Free_Allocator remote;
+    Allocator allocator;
+    Dynamic_Arena arena;
+    Byte padding[64];  /*keeps threads off each others cache lines*/
+};
+
+/* results of a run, written by the forked child */
+typedef struct
+{
+    USize ops;
+    double seconds;
+    USize peak_live;
+    USize peak_rss;
+} Bench_Result;
+
+static Bench_Thread bench_threads[BENCH_MAX_THREADS];
+static U32 bench_thread_count;
+static int bench_stop;
+static pthread_barrier_t bench_barrier;
+static Bench_Slot *bench_larson_sets;    /*BENCH_LARSON_SLOTS per thread*/
+static int bench_larson_done;
+
+static USize Bench_Now_Ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (USize)ts.tv_sec * 1000000000u + (USize)ts.tv_nsec;
+}
+
+static USize Bench_Rss(void)
+{
+    unsigned long pages = 0, rss = 0;
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (file == NULL) return 0;
+    if (fscanf(file, "%lu %lu", &pages, &rss) != 2) rss = 0;
+    fclose(file);
+    return (USize)rss * (USize)sysconf(_SC_PAGESIZE);
+}
+
+static U64 Bench_Random(Bench_Thread *thread)
+{
+    thread->rng ^= thread->rng << 13;
+    thread->rng ^= thread->rng >> 7;
+    thread->rng ^= thread->rng << 17;
+    return thread->rng;
+}
+
+static void Bench_Add_Live(Bench_Thread *thread, USize allocated, USize freed)
+{
+    __atomic_store_n(&thread->live, thread->live + allocated - freed, __ATOMIC_RELAXED);
+}
+
+/* -- setups -- */
+
+static void Bench_Nop(Bench_Thread *thread) { (void)thread; }
+
+static void *Bench_Libc_Alloc(Bench_Thread *thread, USize size)
+{
+    (void)thread;
+    return Allocator_Alloc_64(size, false, 16, &allocator_libc);
+}
+static void Bench_Libc_Free(Bench_Thread *owner, void *ptr)
+{
+    (void)owner;
+    Allocator_Free(ptr, &allocator_libc);
+}
+
+static Numa_Allocator bench_numa;
+static Allocator bench_numa_allocator; /*initialised in main*/
+static void *Bench_Numa_Alloc(Bench_Thread *thread, USize size)
+{
+    (void)thread;
+    return Allocator_Alloc_64(size, false, 16, &bench_numa_allocator);
+}
+static void Bench_Numa_Free(Bench_Thread *owner, void *ptr)
+{
+    (void)owner;
+    Allocator_Free(ptr, &bench_numa_allocator);
+}
+
+static void Bench_Ring_Remote_Init(Bench_Thread *thread)
+{
+    Ring_Allocator_Init(&thread->ring, &allocator_libc, 1 << 20);
+    thread->ring_allocator = Ring_Allocator_Interface(&thread->ring);
+    Remote_Free_Allocator_Init(&thread->remote, &thread->ring_allocator);
+    thread->allocator = Remote_Free_Allocator_Interface(&thread->remote);
+}
+static void Bench_Ring_Remote_Deinit(Bench_Thread *thread)
+{
+    Remote_Free_Allocator_Deinit(&thread->remote);
+    Ring_Allocator_Deinit(&thread->ring);
+}
+static void *Bench_Ring_Remote_Alloc(Bench_Thread *thread, USize size)
+{
+    return Allocator_Alloc_64(size, false, 16, &thread->allocator);
+}
+static void Bench_Ring_Remote_Free(Bench_Thread *owner, void *ptr)
+{
+    Allocator_Free(ptr, &owner->allocator);
+}
+
+static void Bench_Arena_Init(Bench_Thread *thread)
+{
+    Dynamic_Arena_Init(&thread->arena, &allocator_libc, 1 << 16, false, 16);
+}
+static void Bench_Arena_Deinit(Bench_Thread *thread)
+{
+    Dynamic_Arena_Deinit(&thread->arena);
+}
+static void *Bench_Arena_Alloc(Bench_Thread *thread, USize size)
+{
+    return Dynamic_Arena_Alloc_Inline(size, false, 16, &thread->arena);
+}
+static void Bench_Arena_Free(Bench_Thread *owner, void *ptr)
+{
+    (void)owner;
+    (void)ptr;
+}
+static void Bench_Arena_Reset(Bench_Thread *thread)
+{
+    Dynamic_Arena_Free_All(&thread->arena, false);
+}
+
+static const Bench_Setup bench_setups[] = {
+    { "libc", BENCH_THREADTEST | BENCH_LARSON | BENCH_PRODCONS,
+      Bench_Nop, Bench_Nop, Bench_Libc_Alloc, Bench_Libc_Free, NULL },
+    { "numa", BENCH_THREADTEST | BENCH_LARSON | BENCH_PRODCONS,
+      Bench_Nop, Bench_Nop, Bench_Numa_Alloc, Bench_Numa_Free, NULL },
+    { "ring_remote", BENCH_THREADTEST | BENCH_PRODCONS,
+      Bench_Ring_Remote_Init, Bench_Ring_Remote_Deinit, Bench_Ring_Remote_Alloc, Bench_Ring_Remote_Free, NULL },
+    { "arena", BENCH_THREADTEST,
+      Bench_Arena_Init, Bench_Arena_Deinit, Bench_Arena_Alloc, Bench_Arena_Free, Bench_Arena_Reset },
+};
+
+/* -- patterns -- */
+
+static bool Bench_Stopped(void)
+{
+    return __atomic_load_n(&bench_stop, __ATOMIC_RELAXED) != 0;
+}
+
+static void Bench_Threadtest(Bench_Thread *thread)
+{
+    const Bench_Setup *setup = thread->setup;
+    void *ptrs[BENCH_THREADTEST_BATCH];
+    U32 i;
+
+    while (!Bench_Stopped())
+    {
+        for (i = 0; i < BENCH_THREADTEST_BATCH; i++) ptrs[i] = setup->alloc(thread, BENCH_THREADTEST_SIZE);
+        Bench_Add_Live(thread, BENCH_THREADTEST_BATCH * BENCH_THREADTEST_SIZE, 0);
+        for (i = 0; i < BENCH_THREADTEST_BATCH; i++) setup->free(thread, ptrs[i]);
+        if (setup->reset != NULL) setup->reset(thread);
+        Bench_Add_Live(thread, 0, BENCH_THREADTEST_BATCH * BENCH_THREADTEST_SIZE);
+        thread->ops += BENCH_THREADTEST_BATCH;
+    }
+}
+
+static void Bench_Larson_Replace(Bench_Thread *thread, Bench_Slot *slot)
+{
+    USize size = BENCH_LARSON_MIN_SIZE + Bench_Random(thread) % (BENCH_LARSON_MAX_SIZE - BENCH_LARSON_MIN_SIZE);
+    USize freed = 0;
+    if (slot->ptr != NULL)
+    {
+        thread->setup->free(slot->owner, slot->ptr);
+        freed = slot->size;
+    }
+    slot->ptr = thread->setup->alloc(thread, size);
+    slot->size = slot->ptr != NULL ? size : 0;
+    slot->owner = thread;
+    Bench_Add_Live(thread, slot->size, freed);
+}
+
+/* the set a thread works on moves to the next thread every round */
+static void Bench_Larson(Bench_Thread *thread)
+{
+    U32 round, i;
+    Bench_Slot *slots = NULL;
+
+    for (round = 0;; round++)
+    {
+        slots = &bench_larson_sets[((thread->index + round) % bench_thread_count) * BENCH_LARSON_SLOTS];
+        for (i = 0; i < BENCH_LARSON_ROUND; i++)
+        {
+            Bench_Larson_Replace(thread, &slots[Bench_Random(thread) % BENCH_LARSON_SLOTS]);
+        }
+        thread->ops += BENCH_LARSON_ROUND;
+
+        /* one thread decides for all of them wether to go on */
+        if (pthread_barrier_wait(&bench_barrier) == PTHREAD_BARRIER_SERIAL_THREAD)
+        {
+            bench_larson_done = Bench_Stopped();
+        }
+        pthread_barrier_wait(&bench_barrier);
+        if (bench_larson_done) break;
+    }
+    for (i = 0; i < BENCH_LARSON_SLOTS; i++)
+    {
+        if (slots[i].ptr == NULL) continue;
+        thread->setup->free(slots[i].owner, slots[i].ptr);
+        Bench_Add_Live(thread, 0, slots[i].size);
+    }
+}
+
+static void Bench_Producer(Bench_Thread *thread)
+{
+    Bench_Queue *queue = thread->queue;
+    U32 head = 0;
+    void *message;
+
+    for (;;)
+    {
+        message = NULL;
+        while (!Bench_Stopped() && (message = thread->setup->alloc(thread, BENCH_MESSAGE_SIZE)) == NULL) sched_yield();
+        while (head - __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE) == BENCH_QUEUE_SIZE) sched_yield();
+        queue->items[head % BENCH_QUEUE_SIZE] = message;
+        __atomic_store_n(&queue->head, ++head, __ATOMIC_RELEASE);
+        if (message == NULL) break; /*NULL tells the consumer to stop*/
+        Bench_Add_Live(thread, BENCH_MESSAGE_SIZE, 0);
+    }
+}
+
+static void Bench_Consumer(Bench_Thread *thread)
+{
+    Bench_Queue *queue = thread->peer->queue;
+    U32 tail = 0;
+    void *message;
+
+    for (;;)
+    {
+        while (__atomic_load_n(&queue->head, __ATOMIC_ACQUIRE) == tail) sched_yield();
+        message = queue->items[tail % BENCH_QUEUE_SIZE];
+        __atomic_store_n(&queue->tail, ++tail, __ATOMIC_RELEASE);
+        if (message == NULL) break;
+        thread->setup->free(thread->peer, message);
+        Bench_Add_Live(thread, 0, BENCH_MESSAGE_SIZE);
+        thread->ops++;
+    }
+}
+
+static U32 bench_pattern;
+
+static void *Bench_Thread_Main(void *arg)
+{
+    Bench_Thread *thread = (Bench_Thread *)arg;
+
+    thread->setup->thread_init(thread);
+    pthread_barrier_wait(&bench_barrier);
+
+    switch (bench_pattern)
+    {
+    case BENCH_THREADTEST: Bench_Threadtest(thread); break;
+    case BENCH_LARSON:     Bench_Larson(thread); break;
+    case BENCH_PRODCONS:
+        if (thread->peer == NULL) Bench_Producer(thread);
+        else                      Bench_Consumer(thread);
+        break;
+    }
+
+    /* other threads may still be freeing into this one */
+    pthread_barrier_wait(&bench_barrier);
+    thread->setup->thread_deinit(thread);
+    return NULL;
+}
+
+static void Bench_Child(U32 pattern, const Bench_Setup *setup, U32 threads, double seconds, Bench_Result *result)
+{
+    USize start, end, base_rss, rss, live;
+    struct timespec tick;
+    U32 i;
+
+    bench_pattern = pattern;
+    bench_thread_count = threads;
+    pthread_barrier_init(&bench_barrier, NULL, threads);
+    if (pattern == BENCH_LARSON)
+    {
+        bench_larson_sets = calloc((USize)threads * BENCH_LARSON_SLOTS, sizeof(Bench_Slot));
+    }
+    for (i = 0; i < threads; i++)
+    {
+        bench_threads[i].index = i;
+        bench_threads[i].setup = setup;
+        bench_threads[i].rng = 0x9E3779B97F4A7C15ull * (i + 1);
+        if (pattern == BENCH_PRODCONS && i % 2 == 0) bench_threads[i].queue = calloc(1, sizeof(Bench_Queue));
+        if (pattern == BENCH_PRODCONS && i % 2 == 1) bench_threads[i].peer = &bench_threads[i - 1];
+    }
+
+    base_rss = Bench_Rss();
+    start = Bench_Now_Ns();
+    for (i = 0; i < threads; i++) pthread_create(&bench_threads[i].handle, NULL, Bench_Thread_Main, &bench_threads[i]);
+
+    tick.tv_sec = 0;
+    tick.tv_nsec = 5000000;
+    while ((double)(Bench_Now_Ns() - start) / 1e9 < seconds)
+    {
+        nanosleep(&tick, NULL);
+        for (live = 0, i = 0; i < threads; i++) live += __atomic_load_n(&bench_threads[i].live, __ATOMIC_RELAXED);
+        rss = Bench_Rss();
+        if ((S64)live > (S64)result->peak_live) result->peak_live = live;
+        if (rss > base_rss && rss - base_rss > result->peak_rss) result->peak_rss = rss - base_rss;
+    }
+    __atomic_store_n(&bench_stop, 1, __ATOMIC_RELAXED);
+
+    for (i = 0; i < threads; i++) pthread_join(bench_threads[i].handle, NULL);
+    end = Bench_Now_Ns();
+    for (i = 0; i < threads; i++) result->ops += bench_threads[i].ops;
+    result->seconds = (double)(end - start) / 1e9;
+}
+
+/* 1, 2, 4... and max_threads last, max_threads + 1 when done */
+static U32 Bench_Next_Threads(U32 threads, U32 max_threads)
+{
+    if (threads == max_threads) return max_threads + 1;
+    return MIN(threads * 2, max_threads);
+}
+
+static const char *Bench_Pattern_Name(U32 pattern)
+{
+    switch (pattern)
+    {
+    case BENCH_THREADTEST: return "threadtest";
+    case BENCH_LARSON:     return "larson";
+    case BENCH_PRODCONS:   return "prodcons";
+    }
+    return "";
+}
+
+int main(int argc, char **argv)
+{
+    static const U32 patterns[] = { BENCH_THREADTEST, BENCH_LARSON, BENCH_PRODCONS };
+    Bench_Result *result;
+    U32 max_threads = (U32)sysconf(_SC_NPROCESSORS_ONLN);
+    double seconds = 0.5;
+    U32 p, s, threads;
+
+    if (argc > 1) max_threads = (U32)atoi(argv[1]);
+    if (argc > 2) seconds = atof(argv[2]);
+    if (max_threads < 2) max_threads = 2;
+    if (max_threads > BENCH_MAX_THREADS) max_threads = BENCH_MAX_THREADS;
+
+    Numa_Allocator_Init(&bench_numa, NUMA_NODE_LOCAL);
+    bench_numa_allocator = Numa_Allocator_Interface(&bench_numa);
+
+    result = mmap(NULL, sizeof(*result), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (result == MAP_FAILED) return 1;
+
+    printf("pattern,setup,threads,seconds,ops,ops_per_sec,scaling,peak_live_bytes,peak_rss_bytes,fragmentation\n");
+    for (p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++)
+    {
+        for (s = 0; s < sizeof(bench_setups) / sizeof(bench_setups[0]); s++)
+        {
+            double base = 0;
+            if (!(bench_setups[s].patterns & patterns[p])) continue;
+
+            for (threads = 1; threads <= max_threads; threads = Bench_Next_Threads(threads, max_threads))
+            {
+                double ops_per_sec;
+                pid_t child;
+                int status;
+
+                if (patterns[p] == BENCH_PRODCONS && threads % 2 != 0) continue;
+
+                memset(result, 0, sizeof(*result));
+                fflush(stdout);
+                child = fork();
+                if (child < 0) return 1;
+                if (child == 0)
+                {
+                    Bench_Child(patterns[p], &bench_setups[s], threads, seconds, result);
+                    _exit(0);
+                }
+                if (waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                {
+                    fprintf(stderr, "%s,%s,%u: run failed\n", Bench_Pattern_Name(patterns[p]), bench_setups[s].name, threads);
+                    continue;
+                }
+
+                ops_per_sec = (double)result->ops / result->seconds;
+                if (base == 0) base = ops_per_sec;
+                printf("%s,%s,%u,%.3f,%lu,%.0f,%.2f,%lu,%lu,%.2f\n",
+                       Bench_Pattern_Name(patterns[p]), bench_setups[s].name, threads, result->seconds,
+                       (unsigned long)result->ops, ops_per_sec, ops_per_sec / base,
+                       (unsigned long)result->peak_live, (unsigned long)result->peak_rss,
+                       result->peak_live != 0 ? (double)result->peak_rss / (double)result->peak_live : 0.0);
+            }
+        }
+    }
+    munmap(result, sizeof(*result));
+    return 0;
+}
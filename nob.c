@@ -6,6 +6,8 @@
 #define TEST_DIR "test/"
 #define BIN_DIR "bin/"
 #define SRC_DIR "src/"
+#define SHIM_DIR "shim/"
+#define BENCH_DIR "bench/"
 
 #if defined(__GNUC__)
 #   define CC "gcc"
@@ -24,6 +26,37 @@ void build_bun_lib( Nob_Cmd *cmd )
 void build_test_bin( Nob_Cmd *cmd )
 {
     nob_cmd_append( cmd, CC, TEST_DIR"test.c", "-I"INC_DIR, "--std=c89", "-ggdb", "-o", BIN_DIR"test.elf" );
+#if defined(__linux__)
+    nob_cmd_append( cmd, "-lpthread" ); /* parallel zeroing helper threads */
+#endif
+}
+
+/* the tests again, with every allocation going through the call site profiler */
+void build_test_profile_bin( Nob_Cmd *cmd )
+{
+    nob_cmd_append( cmd, CC, TEST_DIR"test.c", "-I"INC_DIR, "--std=c89", "-ggdb", "-DBUN_PROFILE_CALLSITES", "-o", BIN_DIR"test_profile.elf" );
+#if defined(__linux__)
+    nob_cmd_append( cmd, "-lpthread" );
+#endif
+}
+void build_bench_bin( Nob_Cmd *cmd )
+{
+    nob_cmd_append( cmd, CC, BENCH_DIR"bench.c", "-I"INC_DIR, "--std=c89", "-O2", "-o", BIN_DIR"bench.elf" );
+#if defined(__linux__)
+    nob_cmd_append( cmd, "-lpthread" );
+#endif
+}
+
+/* multi threaded benchmarks, linux only */
+void build_bench_mt_bin( Nob_Cmd *cmd )
+{
+    nob_cmd_append( cmd, CC, BENCH_DIR"bench_mt.c", "-I"INC_DIR, "--std=c89", "-O2", "-o", BIN_DIR"bench_mt.elf", "-lpthread" );
+}
+
+/* LD_PRELOAD-able malloc replacement, glibc only */
+void build_shim_lib( Nob_Cmd *cmd )
+{
+    nob_cmd_append( cmd, CC, "-shared", "-fPIC", "-O2", SHIM_DIR"malloc_shim.c", "-I"INC_DIR, "--std=c89", "-o", LIB_DIR"libbun_malloc.so", "-lpthread" );
 }
 
 bool path_has_single_char_extension_len(const char *path, size_t path_len, char extension)
@@ -160,6 +193,38 @@ int main(int argc, char **argv)
     build_test_bin( &cmd );
     if (!nob_cmd_run_sync_and_reset( &cmd )) return 1;
 
+    build_test_profile_bin( &cmd );
+    if (!nob_cmd_run_sync_and_reset( &cmd )) return 1;
+
+    build_bench_bin( &cmd );
+    if (!nob_cmd_run_sync_and_reset( &cmd )) return 1;
+
+#if defined(__linux__)
+    build_bench_mt_bin( &cmd );
+    if (!nob_cmd_run_sync_and_reset( &cmd )) return 1;
+
+    build_shim_lib( &cmd );
+    if (!nob_cmd_run_sync_and_reset( &cmd )) return 1;
+#endif
+
+    /* ./nob bench [filter] runs the benchmarks after building */
+    if (argc > 1 && strcmp(argv[1], "bench") == 0)
+    {
+        nob_cmd_append( &cmd, BIN_DIR"bench.elf" );
+        if (argc > 2) nob_cmd_append( &cmd, argv[2] );
+        if (!nob_cmd_run_sync_and_reset( &cmd )) return 1;
+    }
+#if defined(__linux__)
+    /* ./nob bench_mt [max_threads] [seconds_per_run] */
+    if (argc > 1 && strcmp(argv[1], "bench_mt") == 0)
+    {
+        nob_cmd_append( &cmd, BIN_DIR"bench_mt.elf" );
+        if (argc > 2) nob_cmd_append( &cmd, argv[2] );
+        if (argc > 3) nob_cmd_append( &cmd, argv[3] );
+        if (!nob_cmd_run_sync_and_reset( &cmd )) return 1;
+    }
+#endif
+
     nob_cmd_free(cmd);
     return 0;
 }
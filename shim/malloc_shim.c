@@ -0,0 +1,314 @@
+/*
+Malloc interposition shim, routes a whole process through a Bun allocator.
+
+    $ ./nob
+    $ BUN_SHIM_ALLOCATOR=arena LD_PRELOAD=lib/libbun_malloc.so ./program
+
+BUN_SHIM_ALLOCATOR picks the allocator on the first allocation:
+    system - glibc behind a Bun_Allocator, the cost of the shim itself (default).
+    numa   - Bun_Numa_Allocator on the node of the allocating thread,
+             small blocks come from per node chunks, large ones are mapped.
+    arena  - one locked Bun_Dynamic_Arena, free is a no-op.
+             For short lived batch processes that allocate and exit.
+             calloc zeroes after the lock is dropped, zeroing large blocks
+             may start helper threads which allocate themselves.
+
+realloc goes through Bun_Allocator_Resize (Bun_Dynamic_Arena_Resize for the
+arena), malloc_trim releases nothing and mallinfo only reports the arena.
+
+Every block has a 16 byte header in front holding its size and where the
+underlying allocation starts, for realloc, malloc_usable_size and over
+aligned blocks. glibc only, the real malloc is reached through __libc_*.
+*/
+#define BUN_IMPLEMENTATION
+#include "bun.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <unistd.h>
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void  __libc_free(void *ptr);
+
+#define SHIM__HEADER_SIZE 16
+#define SHIM__ALIGN       16
+
+typedef struct
+{
+    void *base;  /*start of the allocation from the backing allocator*/
+    size_t size; /*size asked for*/
+} Shim__Header;
+
+enum
+{
+    SHIM__SYSTEM,
+    SHIM__NUMA,
+    SHIM__ARENA,
+};
+
+static pthread_mutex_t shim_lock = PTHREAD_MUTEX_INITIALIZER;
+static int shim_initialised;
+static int shim_kind;
+static Bun_Allocator shim_system;
+static Bun_Numa_Allocator shim_numa;
+static Bun_Allocator shim_allocator;
+static Bun_Dynamic_Arena shim_arena;
+
+/*
+glibc as a Bun_Allocator, the libc allocator of bun.h would call back into the shim.
+*/
+static void *Shim__System_Proc64(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode,
+                                 Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size)
+{
+    void *ptr;
+    (void)allocator_data; (void)alignment; (void)old_size; /*glibc blocks are 16 byte aligned*/
+
+    switch (mode)
+    {
+        case BUN_ALLOCATOR_MODE_ALLOC:
+        case BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED:
+            ptr = (mode == BUN_ALLOCATOR_MODE_ALLOC) ? __libc_calloc(size, 1) : __libc_malloc(size);
+            if (ptr == NULL && allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY;
+            return ptr;
+        case BUN_ALLOCATOR_MODE_FREE:
+            __libc_free(old_memory);
+            return old_memory;
+        case BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED:
+            ptr = __libc_realloc(old_memory, size);
+            if (ptr == NULL && allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY;
+            return ptr;
+        default:
+            if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED;
+            return NULL;
+    }
+}
+
+static void Shim__Init(void)
+{
+    const char *name;
+
+    pthread_mutex_lock(&shim_lock);
+    if (!shim_initialised)
+    {
+        shim_system = (Bun_Allocator){
+            .proc64 = &Shim__System_Proc64,
+            .implemented_modes = BUN_ALLOCATOR_MODE_ALLOC | BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED | BUN_ALLOCATOR_MODE_FREE
+                               | BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED,
+        };
+        shim_allocator = shim_system;
+        shim_kind = SHIM__SYSTEM;
+
+        name = getenv("BUN_SHIM_ALLOCATOR");
+        if (name != NULL && strcmp(name, "numa") == 0)
+        {
+            Bun_Numa_Allocator_Init(&shim_numa, BUN_NUMA_NODE_LOCAL);
+            shim_allocator = Bun_Numa_Allocator_Interface(&shim_numa);
+            shim_kind = SHIM__NUMA;
+        }
+        else if (name != NULL && strcmp(name, "arena") == 0
+             &&  Bun_Dynamic_Arena_Init(&shim_arena, &shim_system, 1 << 20, false, SHIM__ALIGN))
+        {
+            shim_kind = SHIM__ARENA;
+        }
+        __atomic_store_n(&shim_initialised, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&shim_lock);
+}
+
+static void *Shim__Alloc(size_t size, size_t alignment, bool zeroed)
+{
+    size_t extra = SHIM__HEADER_SIZE + ((alignment > SHIM__ALIGN) ? alignment - SHIM__ALIGN : 0);
+    Shim__Header *header;
+    Bun_Byte *base;
+    uintptr_t ptr;
+
+    if (!__atomic_load_n(&shim_initialised, __ATOMIC_ACQUIRE)) Shim__Init();
+    if (size > (size_t)-1 - extra)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    if (shim_kind == SHIM__ARENA)
+    {
+        /*zeroing under the lock would deadlock if it starts helper threads*/
+        pthread_mutex_lock(&shim_lock);
+        base = Bun_Dynamic_Arena_Alloc_Push(size + extra, false, SHIM__ALIGN, &shim_arena);
+        pthread_mutex_unlock(&shim_lock);
+        if (base != NULL && zeroed) Bun_Memory_Zero(base, size + extra);
+    }
+    else base = Bun_Allocator_Alloc_64(size + extra, zeroed, SHIM__ALIGN, &shim_allocator);
+    if (base == NULL)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    ptr = Bun_Align_Formula((uintptr_t)base + SHIM__HEADER_SIZE, (Bun_U32)alignment);
+    header = (Shim__Header *)ptr - 1;
+    header->base = base;
+    header->size = size;
+    return (void *)ptr;
+}
+
+static Shim__Header *Shim__Header_Of(void *ptr)
+{
+    return (Shim__Header *)ptr - 1;
+}
+
+static void *Shim__Aligned(size_t alignment, size_t size)
+{
+    if (alignment == 0 || alignment & (alignment - 1) || alignment > (Bun_U32)-1)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+    return Shim__Alloc(size, alignment, false);
+}
+
+void *malloc(size_t size)
+{
+    return Shim__Alloc(size, SHIM__ALIGN, false);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    if (size && count > (size_t)-1 / size)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return Shim__Alloc(count * size, SHIM__ALIGN, true);
+}
+
+void free(void *ptr)
+{
+    if (ptr == NULL || shim_kind == SHIM__ARENA) return;
+    Bun_Allocator_Free(Shim__Header_Of(ptr)->base, &shim_allocator);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    Shim__Header *header;
+    Bun_Byte *base;
+    void *new_ptr;
+
+    if (ptr == NULL) return malloc(size);
+    if (size == 0)
+    {
+        free(ptr);
+        return NULL;
+    }
+    header = Shim__Header_Of(ptr);
+    if (size <= header->size) return ptr;
+
+    /*over aligned blocks have padding in front that may change, move them by hand*/
+    if ((Bun_Byte *)ptr != (Bun_Byte *)header->base + SHIM__HEADER_SIZE)
+    {
+        new_ptr = Shim__Alloc(size, SHIM__ALIGN, false);
+        if (new_ptr == NULL) return NULL;
+        memcpy(new_ptr, ptr, header->size);
+        free(ptr);
+        return new_ptr;
+    }
+    if (size > (size_t)-1 - SHIM__HEADER_SIZE)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    /*the header moves along with the block*/
+    if (shim_kind == SHIM__ARENA)
+    {
+        pthread_mutex_lock(&shim_lock);
+        base = Bun_Dynamic_Arena_Resize(header->base, size + SHIM__HEADER_SIZE, header->size + SHIM__HEADER_SIZE,
+                                        false, SHIM__ALIGN, &shim_arena);
+        pthread_mutex_unlock(&shim_lock);
+    }
+    else base = Bun_Allocator_Resize_64(header->base, size + SHIM__HEADER_SIZE, header->size + SHIM__HEADER_SIZE,
+                                        false, SHIM__ALIGN, &shim_allocator);
+    if (base == NULL)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    header = (Shim__Header *)(base + SHIM__HEADER_SIZE) - 1;
+    header->base = base;
+    header->size = size;
+    return base + SHIM__HEADER_SIZE;
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    void *ptr;
+
+    if (alignment < sizeof(void *) || alignment & (alignment - 1)) return EINVAL;
+    ptr = Shim__Aligned(alignment, size);
+    if (ptr == NULL) return ENOMEM;
+    *memptr = ptr;
+    return 0;
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    return Shim__Aligned(alignment, size);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    return Shim__Aligned(alignment, size);
+}
+
+void *valloc(size_t size)
+{
+    return Shim__Aligned((size_t)sysconf(_SC_PAGESIZE), size);
+}
+
+void *pvalloc(size_t size)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+
+    if (size > (size_t)-1 - page_size)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+    /*rounded up to whole pages, at least one*/
+    size = (size) ? (size + page_size - 1) & ~(page_size - 1) : page_size;
+    return Shim__Aligned(page_size, size);
+}
+
+size_t malloc_usable_size(void *ptr)
+{
+    return (ptr != NULL) ? Shim__Header_Of(ptr)->size : 0;
+}
+
+int malloc_trim(size_t pad)
+{
+    (void)pad;
+    return 0;
+}
+
+struct mallinfo mallinfo(void)
+{
+    struct mallinfo info;
+    Bun_Dynamic_Arena_Stats stats;
+
+    memset(&info, 0, sizeof(info));
+    if (__atomic_load_n(&shim_initialised, __ATOMIC_ACQUIRE) && shim_kind == SHIM__ARENA)
+    {
+        pthread_mutex_lock(&shim_lock);
+        stats = Bun_Dynamic_Arena_Get_Stats(&shim_arena);
+        pthread_mutex_unlock(&shim_lock);
+        info.arena    = (int)stats.reserved;
+        info.uordblks = (int)stats.live;
+        info.fordblks = (int)(stats.reserved - stats.live);
+    }
+    return info;
+}
@@ -16,8 +16,23 @@ Provides:
     S8-64         - signed type aliases.
     String        - String with length.
     Allocator     - A generic allocator interface.
+    Fallback/Segregator/Bucketizer_Allocator - Allocators combining other allocators.
+    Ring_Allocator - A circular allocator for allocations freed in about FIFO order.
+    Stack_Allocator - A LIFO allocator freeing and resizing its newest allocation.
+    Remote_Free_Allocator - Lock free frees from other threads into a single threaded allocator.
+    Timed_Allocator - Allocator wrapper recording per mode latency histograms.
     Arena         - A fixed size arena.
     Dynamic_Arena - A dynamically sized arena.
+    Compact_Arena - A compacting arena of objects reached through handles.
+    File_Arena    - A file backed arena, mapped back in at startup.
+    Shared_Arena  - A shared memory arena for passing data between processes.
+    Snapshot_Arena - An arena with copy on write snapshots and rollback.
+    Numa          - NUMA node placement for allocators and arenas.
+    Offset_Ptr    - 32 bit self/base relative pointers for arena data.
+    Pool          - Typed object pools and arenas generated by BUN_POOL_DEFINE(T).
+    Pool_Cache    - Process wide cache of arena pools.
+    Profile       - Opt in per call site allocation profiling (BUN_PROFILE_CALLSITES).
+    Zero          - Streaming and multithreaded zeroing of large ranges.
 
 Usage:
     Single header lib:
@@ -27,7 +42,7 @@ Usage:
         {
             //...
         }
-    cc main.c -I<path-to-bun.h-dir>
+    cc main.c -I<path-to-bun.h-dir> -lpthread
 
     Static Lib:
         #include "bun.h"
@@ -35,7 +50,14 @@ Usage:
         {
             //...
         }
-    cc main.c -I<path-to-bun.h-dir> -L<path-to-bun.a-dir> -lbun
+    cc main.c -I<path-to-bun.h-dir> -L<path-to-bun.a-dir> -lbun -lpthread
+
+    On linux the implementation defines _GNU_SOURCE, so include bun.h before
+    any system header where BUN_IMPLEMENTATION is defined (or compile with
+    -D_GNU_SOURCE).
+
+    On unix the implementation uses pthreads, -lpthread can be dropped where
+    libc includes it (glibc 2.34+) or with BUN_NO_THREADS defined.
 
 DISCLAIMER:
     This is not thoroughly tested, it may have horrible memory bugs that
@@ -1,5 +1,21 @@
+/*
+Platform apis (mmap, syscall, pthreads...) are hidden by --std=c89,
+so ask for them before the first system header is seen.
+A system header included before bun.h has already fixed the feature set:
+in strict mode nothing past c89 is declared and the build would fail deep
+in the implementation, so stop here. Otherwise the default set covers all
+but memfd_create and mremap, which fall back to shm objects and malloc.
+*/
+#if defined(BUN_IMPLEMENTATION) && defined(__linux__) && !defined(_GNU_SOURCE)
+#    if defined(_FEATURES_H) && defined(__STRICT_ANSI__) && !defined(_DEFAULT_SOURCE) && !defined(_BSD_SOURCE)
+#        error "bun.h: a system header was included before the implementation, include bun.h first or compile with -D_GNU_SOURCE"
+#    endif
+#    define _GNU_SOURCE
+#endif
+
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 typedef int8_t   Bun_S8;
 typedef int16_t  Bun_S16;
@@ -18,6 +34,10 @@ typedef long double Bun_F128;
 
 typedef Bun_U8 Bun_Byte;
 
+/*size of memory, as wide as a pointer so it is 64 bit on 64 bit platforms*/
+typedef uintptr_t Bun_USize;
+#define BUN_USIZE_MAX UINTPTR_MAX
+
 
 #ifdef BUN_STRIP_PREFIX
 #    define S8 Bun_S8
@@ -34,4 +54,6 @@ typedef Bun_U8 Bun_Byte;
 #    define F64 Bun_F64
 #    define F128 Bun_F128
 #    define Byte Bun_Byte
+#    define USize Bun_USize
+#    define USIZE_MAX BUN_USIZE_MAX
 #endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,64 @@
+/*
+Compiler specific keywords, needed by headers that come before macros.h
+and kept even with BUN_NO_MACROS.
+*/
+/*c89 has no inline, every compiler we care about has its own spelling*/
+#if defined(__GNUC__) || defined(__clang__)
+#    define BUN_INLINE static __inline__ __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#    define BUN_INLINE static __forceinline
+#else
+#    define BUN_INLINE static
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#    define BUN_LIKELY(cond)   __builtin_expect(!!(cond), 1)
+#    define BUN_UNLIKELY(cond) __builtin_expect(!!(cond), 0)
+#else
+#    define BUN_LIKELY(cond)   (cond)
+#    define BUN_UNLIKELY(cond) (cond)
+#endif
+
+/*for static functions in headers that a user may never call*/
+#if defined(__GNUC__) || defined(__clang__)
+#    define BUN_MAYBE_UNUSED __attribute__((unused))
+#else
+#    define BUN_MAYBE_UNUSED
+#endif
+
+/*
+Atomics for the library's lock free paths, with the GCC/clang __atomic
+builtins when there are any. Other compilers get plain accesses, which are
+only correct single threaded (and single process for shared arenas).
+    LOAD/STORE          - acquire/release, _RELAXED for counters and caches.
+    ADD/SUB             - relaxed, yield the old value.
+    EXCHANGE            - acquire/release, the old value is stored into *old*.
+    CAS                 - strong, acquire/release, *expected* gets the current value on failure.
+*/
+#if defined(__GNUC__) || defined(__clang__)
+#    define BUN_ATOMICS
+#    define BUN_ATOMIC_LOAD(ptr)                 __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#    define BUN_ATOMIC_LOAD_RELAXED(ptr)         __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#    define BUN_ATOMIC_STORE(ptr, value)         __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#    define BUN_ATOMIC_STORE_RELAXED(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELAXED)
+#    define BUN_ATOMIC_ADD(ptr, value)           __atomic_fetch_add(ptr, value, __ATOMIC_RELAXED)
+#    define BUN_ATOMIC_SUB(ptr, value)           __atomic_fetch_sub(ptr, value, __ATOMIC_RELAXED)
+#    define BUN_ATOMIC_EXCHANGE(ptr, value, old) ((old) = __atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL))
+#    define BUN_ATOMIC_CAS(ptr, expected, value) __atomic_compare_exchange_n(ptr, expected, value, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+#    define BUN_ATOMIC_LOAD(ptr)                 (*(ptr))
+#    define BUN_ATOMIC_LOAD_RELAXED(ptr)         (*(ptr))
+#    define BUN_ATOMIC_STORE(ptr, value)         (*(ptr) = (value))
+#    define BUN_ATOMIC_STORE_RELAXED(ptr, value) (*(ptr) = (value))
+#    define BUN_ATOMIC_ADD(ptr, value)           ((*(ptr) += (value)) - (value))
+#    define BUN_ATOMIC_SUB(ptr, value)           ((*(ptr) -= (value)) + (value))
+#    define BUN_ATOMIC_EXCHANGE(ptr, value, old) ((old) = *(ptr), *(ptr) = (value))
+#    define BUN_ATOMIC_CAS(ptr, expected, value) ((*(ptr) == *(expected)) ? (*(ptr) = (value), true) : (*(expected) = *(ptr), false))
+#endif
+
+#ifdef BUN_STRIP_PREFIX
+#    define INLINE BUN_INLINE
+#    define LIKELY BUN_LIKELY
+#    define UNLIKELY BUN_UNLIKELY
+#    define MAYBE_UNUSED BUN_MAYBE_UNUSED
+#endif /*ifdef BUN_STRIP_PREFIX*/
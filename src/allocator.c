@@ -1,164 +1,423 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <string.h>
+#if defined(__linux__)
+#    include <sys/mman.h>
+#    include <unistd.h>
+/*mremap is only declared with _GNU_SOURCE, large blocks stay in malloc without it*/
+#    if defined(MREMAP_MAYMOVE)
+#        define BUN_ALLOCATOR__MREMAP
+#    endif
+#endif
+#if defined(BUN_ALLOCATOR__MREMAP) && !defined(BUN_NO_THREADS)
+#    define BUN_ALLOCATOR__MAP_THREADS
+#    include <pthread.h>
+#endif
 
-void *Bun_Allocator_Alloc(Bun_U32 size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator)
+/*
+Call proc64 when the allocator has one, otherwise proc when the sizes fit it.
+*/
+static void *Bun_Allocator__Call(Bun_Allocator *allocator, Bun_Allocator_Mode mode, Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size)
 {
-    if (!allocator) return NULL;
-    Bun_Allocator_Mode mode = (zeroed) ? BUN_ALLOCATOR_MODE_ALLOC : BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED;
-
     if (mode &~ allocator->implemented_modes)
     {
         allocator->error = BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED;
         return NULL;
     }
+    if (allocator->proc64 != NULL)
+        return allocator->proc64(&allocator->data, &allocator->error, mode, size, alignment, old_memory, old_size);
+
+    if (size > (Bun_U32)-1 || old_size > (Bun_U32)-1)
+    {
+        allocator->error = BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+    return allocator->proc(&allocator->data, &allocator->error, mode, (Bun_U32)size, alignment, old_memory, (Bun_U32)old_size);
+}
+
+void *(Bun_Allocator_Alloc)(Bun_U32 size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator)
+{
+    return (Bun_Allocator_Alloc_64)(size, zeroed, alignment, allocator);
+}
+void *(Bun_Allocator_Alloc_64)(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator)
+{
+    if (!allocator) return NULL;
+    Bun_Allocator_Mode mode = (zeroed) ? BUN_ALLOCATOR_MODE_ALLOC : BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED;
+
+    if (BUN_ALLOCATOR__USE_OPS(allocator, alloc, mode))
+        return allocator->ops->alloc(&allocator->data, &allocator->error, size, zeroed, alignment);
+    return Bun_Allocator__Call(allocator, mode, size, alignment, NULL, 0);
+}
+bool (Bun_Allocator_Free)(void *ptr, Bun_Allocator *allocator)
+{
+    if (!allocator) return NULL;
+
+    if (BUN_ALLOCATOR__USE_OPS(allocator, free, BUN_ALLOCATOR_MODE_FREE))
+        return allocator->ops->free(&allocator->data, &allocator->error, ptr);
+    return Bun_Allocator__Call(allocator, BUN_ALLOCATOR_MODE_FREE, 0, 0, ptr, 0) != NULL;
+
+}
+bool (Bun_Allocator_Free_all)(Bun_Allocator *allocator)
+{
+    if (!allocator) return NULL;
+
+    return Bun_Allocator__Call(allocator, BUN_ALLOCATOR_MODE_FREE_ALL, 0, 0, NULL, 0) != NULL;
+}
+bool Bun_Allocator_Owns(void *ptr, Bun_Allocator *allocator)
+{
+    if (!allocator || ptr == NULL) return false;
 
-    return allocator->proc( &allocator->data, &allocator->error,
-                            mode,
-                            size,
-                            alignment,
-                            NULL,
-                            0
-                          );
+    return Bun_Allocator__Call(allocator, BUN_ALLOCATOR_MODE_OWNS, 0, 0, ptr, 0) != NULL;
+}
+void *(Bun_Allocator_Resize)(void *ptr, Bun_U32 size, Bun_U32 old_size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator)
+{
+    return (Bun_Allocator_Resize_64)(ptr, size, old_size, zeroed, alignment, allocator);
 }
-bool Bun_Allocator_Free(void *ptr, Bun_Allocator *allocator)
+void *(Bun_Allocator_Resize_64)(void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator)
 {
     if (!allocator) return NULL;
+    Bun_Allocator_Mode mode = (zeroed) ? BUN_ALLOCATOR_MODE_RESIZE : BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED;
+
+    if (BUN_ALLOCATOR__USE_OPS(allocator, resize, mode))
+        return allocator->ops->resize(&allocator->data, &allocator->error, ptr, size, old_size, zeroed, alignment);
+    return Bun_Allocator__Call(allocator, mode, size, alignment, ptr, old_size);
+}
 
-    if (BUN_ALLOCATOR_MODE_FREE &~ allocator->implemented_modes)
+void *Bun_Allocator__Result(Bun_Allocator *allocator, Bun_Allocator_Error *allocator_error, void *ptr)
+{
+    if (ptr == NULL && allocator_error != NULL) *allocator_error = (allocator != NULL) ? allocator->error : BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT;
+    return ptr;
+}
+
+#ifdef BUN_ALLOCATOR__MREMAP
+/*
+Blocks of BUN_ALLOCATOR_LIBC_MAP_THRESHOLD bytes and more are mapped, so they
+grow with mremap instead of a copy and fresh pages come zeroed.
+The block starts at the second page of its mapping, with this header at the
+end of the first one. Every mapped block is registered in a hash table keyed
+by its address, a pointer is only treated as mapped when it is found there,
+nothing outside the mappings is ever read.
+*/
+#define BUN_ALLOCATOR__MAP_BUCKETS 64
+
+typedef struct Bun_Allocator__Map_Header Bun_Allocator__Map_Header;
+struct Bun_Allocator__Map_Header
+{
+    Bun_Allocator__Map_Header *next; /*next block in the same bucket*/
+    uintptr_t map_size;              /*header page included*/
+};
+
+static struct
+{
+    uintptr_t count; /*blocks registered, written under the lock*/
+    Bun_Allocator__Map_Header *buckets[BUN_ALLOCATOR__MAP_BUCKETS];
+#ifdef BUN_ALLOCATOR__MAP_THREADS
+    pthread_mutex_t lock;
+#endif
+} bun_allocator__maps = {
+    0,
+    {0},
+#ifdef BUN_ALLOCATOR__MAP_THREADS
+    PTHREAD_MUTEX_INITIALIZER,
+#endif
+};
+
+static uintptr_t Bun_Allocator__Page_Size(void)
+{
+    static uintptr_t page_size;
+    uintptr_t result = BUN_ATOMIC_LOAD_RELAXED(&page_size);
+    if (result == 0)
     {
-        allocator->error = BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED;
-        return false;
+        result = (uintptr_t)sysconf(_SC_PAGESIZE);
+        BUN_ATOMIC_STORE_RELAXED(&page_size, result);
     }
+    return result;
+}
 
-    return allocator->proc( &allocator->data, &allocator->error,
-                            BUN_ALLOCATOR_MODE_FREE,
-                            0,
-                            0,
-                            ptr,
-                            0
-                          ) != NULL;
+static Bun_Allocator__Map_Header **Bun_Allocator__Map_Bucket(void *ptr)
+{
+    uintptr_t page = (uintptr_t)ptr / Bun_Allocator__Page_Size();
+    return &bun_allocator__maps.buckets[(page ^ page >> 6 ^ page >> 12) % BUN_ALLOCATOR__MAP_BUCKETS];
+}
 
+static void Bun_Allocator__Map_Register(void *ptr)
+{
+    Bun_Allocator__Map_Header *header = (Bun_Allocator__Map_Header *)ptr - 1;
+    Bun_Allocator__Map_Header **bucket = Bun_Allocator__Map_Bucket(ptr);
+
+#ifdef BUN_ALLOCATOR__MAP_THREADS
+    pthread_mutex_lock(&bun_allocator__maps.lock);
+#endif
+    header->next = *bucket;
+    *bucket = header;
+    BUN_ATOMIC_STORE_RELAXED(&bun_allocator__maps.count, bun_allocator__maps.count + 1);
+#ifdef BUN_ALLOCATOR__MAP_THREADS
+    pthread_mutex_unlock(&bun_allocator__maps.lock);
+#endif
 }
-bool Bun_Allocator_Free_all(Bun_Allocator *allocator)
+
+/*
+Take a mapped block out of the table.
+RETURN:
+    its header, or NULL if ptr is not a mapped block (a malloc block)
+*/
+static Bun_Allocator__Map_Header *Bun_Allocator__Map_Unregister(void *ptr)
 {
-    if (!allocator) return NULL;
+    Bun_Allocator__Map_Header *header = (Bun_Allocator__Map_Header *)ptr - 1;
+    Bun_Allocator__Map_Header *found = NULL;
+    Bun_Allocator__Map_Header **link;
+
+    /*mapped blocks are page aligned, and most programs never have one*/
+    if ((uintptr_t)ptr & (Bun_Allocator__Page_Size() - 1)) return NULL;
+    if (BUN_ATOMIC_LOAD_RELAXED(&bun_allocator__maps.count) == 0) return NULL;
 
-    if (BUN_ALLOCATOR_MODE_FREE_ALL &~ allocator->implemented_modes)
+#ifdef BUN_ALLOCATOR__MAP_THREADS
+    pthread_mutex_lock(&bun_allocator__maps.lock);
+#endif
+    for (link = Bun_Allocator__Map_Bucket(ptr); *link != NULL; link = &(*link)->next)
     {
-        allocator->error = BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED;
+        if (*link != header) continue;
+        found = header;
+        *link = header->next;
+        BUN_ATOMIC_STORE_RELAXED(&bun_allocator__maps.count, bun_allocator__maps.count - 1);
+        break;
+    }
+#ifdef BUN_ALLOCATOR__MAP_THREADS
+    pthread_mutex_unlock(&bun_allocator__maps.lock);
+#endif
+    return found;
+}
+
+/*write the header of a fresh mapping and register it, RETURN: its block*/
+static void *Bun_Allocator__Map_Block(void *map, uintptr_t map_size)
+{
+    Bun_Byte *ptr = (Bun_Byte *)map + Bun_Allocator__Page_Size();
+    ((Bun_Allocator__Map_Header *)ptr - 1)->map_size = map_size;
+    Bun_Allocator__Map_Register(ptr);
+    return ptr;
+}
+
+/*RETURN: size of the mapping for a block of *size* bytes, 0 on overflow*/
+static uintptr_t Bun_Allocator__Map_Size(Bun_USize size)
+{
+    uintptr_t map_size = Bun_Align_Formula(size, (Bun_U32)Bun_Allocator__Page_Size());
+    if (map_size == 0 || map_size > UINTPTR_MAX - Bun_Allocator__Page_Size()) return 0;
+    return map_size + Bun_Allocator__Page_Size();
+}
+
+static void *Bun_Allocator__Map(Bun_Allocator_Error *allocator_error, Bun_USize size)
+{
+    uintptr_t map_size = Bun_Allocator__Map_Size(size);
+    void *map = (map_size) ? mmap(NULL, map_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0) : MAP_FAILED;
+
+    if (map == MAP_FAILED)
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY;
         return NULL;
     }
+    return Bun_Allocator__Map_Block(map, map_size);
+}
 
-    return allocator->proc( &allocator->data, &allocator->error,
-                            BUN_ALLOCATOR_MODE_FREE_ALL,
-                            0,
-                            0,
-                            NULL,
-                            0
-                          ) != NULL;
+static void Bun_Allocator__Unmap(void *ptr, Bun_Allocator__Map_Header *header)
+{
+    munmap((Bun_Byte *)ptr - Bun_Allocator__Page_Size(), header->map_size);
 }
-void *Bun_Allocator_Resize(void *ptr, Bun_U32 size, Bun_U32 old_size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator)
+
+/*
+Remap a mapped block taken out of the table, the kernel moves the pages
+instead of copying them and pages past the old mapping come zeroed.
+*/
+static void *Bun_Allocator__Remap(Bun_Allocator_Error *allocator_error, void *old_memory, Bun_Allocator__Map_Header *header, Bun_USize size, Bun_USize old_size, bool zeroed)
 {
-    if (!allocator) return NULL;
-    Bun_Allocator_Mode mode = (zeroed) ? BUN_ALLOCATOR_MODE_RESIZE : BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED;
+    uintptr_t map_size = Bun_Allocator__Map_Size(size);
+    uintptr_t old_map_size = header->map_size;
+    uintptr_t old_capacity = old_map_size - Bun_Allocator__Page_Size();
+    void *map = MAP_FAILED;
 
-    if (mode &~ allocator->implemented_modes)
+    if (map_size) map = mremap((Bun_Byte *)old_memory - Bun_Allocator__Page_Size(), old_map_size, map_size, MREMAP_MAYMOVE);
+    if (map == MAP_FAILED)
     {
-        allocator->error = BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED;
+        Bun_Allocator__Map_Register(old_memory);
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY;
         return NULL;
     }
+    old_memory = Bun_Allocator__Map_Block(map, map_size);
 
-    return allocator->proc( &allocator->data, &allocator->error,
-                            mode,
-                            size,
-                            alignment, /*byte*/
-                            ptr,
-                            old_size
-                          );
+    /*only the part of the old mapping past old_size can hold stale bytes*/
+    if (zeroed && size > old_size && old_size < old_capacity)
+        memset((Bun_Byte *)old_memory + old_size, 0, ((size < old_capacity) ? size : old_capacity) - old_size);
+    return old_memory;
 }
+#endif /*ifdef BUN_ALLOCATOR__MREMAP*/
 
-void *Bun_Allocator_Libc_Proc(void *allocator_data,
+/*
+The libc allocator, one function per operation, used as its ops and by its procs.
+*/
+static void *Bun_Allocator__Libc_Alloc(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_USize size, bool zeroed, Bun_U32 alignment)
+{
+    uintptr_t aligned_size = Bun_Align_Formula(size, alignment);
+    void *ptr;
+
+    (void)allocator_data;
+
+    if (aligned_size < size)
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY;
+        return NULL;
+    }
+#ifdef BUN_ALLOCATOR__MREMAP
+    /*fresh pages are always zero*/
+    if (aligned_size >= BUN_ALLOCATOR_LIBC_MAP_THRESHOLD) return Bun_Allocator__Map(allocator_error, aligned_size);
+#endif
+    if (zeroed) ptr = calloc( aligned_size, 1 );
+    else        ptr = malloc( aligned_size );
+    if (ptr == NULL && allocator_error != NULL)
+    {
+        *allocator_error = (errno == ENOMEM) ? BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY : BUN_ALLOCATOR_ERROR_UNKNOWN;
+    }
+    return ptr;
+}
+static bool Bun_Allocator__Libc_Free(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr)
+{
+#ifdef BUN_ALLOCATOR__MREMAP
+    Bun_Allocator__Map_Header *header;
+#endif
+
+    (void)allocator_data;
+    if (ptr == NULL)
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_POINTER;
+        return false;
+    }
+#ifdef BUN_ALLOCATOR__MREMAP
+    header = Bun_Allocator__Map_Unregister(ptr);
+    if (header != NULL)
+    {
+        Bun_Allocator__Unmap(ptr, header);
+        return true;
+    }
+#endif
+    free(ptr);
+    return true;
+}
+static void *Bun_Allocator__Libc_Resize(void *allocator_data, Bun_Allocator_Error *allocator_error, void *old_memory, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment)
+{
+    uintptr_t aligned_size = Bun_Align_Formula(size, alignment);
+    void *ptr;
+#ifdef BUN_ALLOCATOR__MREMAP
+    Bun_Allocator__Map_Header *header;
+#endif
+
+    (void)allocator_data;
+    if (old_memory == NULL || size == 0 || (zeroed && old_size == 0))
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+    if (aligned_size < size)
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY;
+        return NULL;
+    }
+
+#ifdef BUN_ALLOCATOR__MREMAP
+    header = Bun_Allocator__Map_Unregister(old_memory);
+    if (header != NULL)
+        return Bun_Allocator__Remap(allocator_error, old_memory, header, aligned_size, old_size, zeroed);
+
+    /*
+    growing past the threshold, move to a mapping once so later growth is a
+    remap, only when old_size says how much to copy, realloc knows otherwise
+    */
+    if (aligned_size >= BUN_ALLOCATOR_LIBC_MAP_THRESHOLD && old_size != 0)
+    {
+        ptr = Bun_Allocator__Map(allocator_error, aligned_size);
+        if (ptr == NULL) return NULL;
+        memcpy(ptr, old_memory, (old_size < size) ? old_size : size);
+        free(old_memory);
+        return ptr;
+    }
+#endif
+
+    ptr = realloc( old_memory, aligned_size );
+
+    if (ptr == NULL)
+    {
+        if (allocator_error != NULL)
+        {
+            *allocator_error = (errno == ENOMEM) ? BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY : BUN_ALLOCATOR_ERROR_UNKNOWN;
+        }
+        return NULL;
+    }
+
+    /* zero */
+    if (zeroed && size > old_size)
+        Bun_Memory_Zero((Bun_Byte *)ptr + old_size, size - old_size);
+
+    return ptr;
+}
+
+void *Bun_Allocator_Libc_Proc64(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode, Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size);
+static const Bun_Allocator_Ops bun_allocator_libc_ops = {
+    .proc64 = &Bun_Allocator_Libc_Proc64,
+    .alloc  = &Bun_Allocator__Libc_Alloc,
+    .free   = &Bun_Allocator__Libc_Free,
+    .resize = &Bun_Allocator__Libc_Resize,
+};
+
+void *Bun_Allocator_Libc_Proc64(void *allocator_data,
                           Bun_Allocator_Error *allocator_error,
                           Bun_Allocator_Mode mode,
-                          Bun_U32 size,
+                          Bun_USize size,
                           Bun_U32 alignment,
                           void *old_memory,
-                          Bun_U32 old_size
+                          Bun_USize old_size
                           )
 {
-    void * ptr;
     switch (mode)
     {
         case BUN_ALLOCATOR_MODE_ALLOC:
         case BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED:
-            if (mode == BUN_ALLOCATOR_MODE_ALLOC) ptr = calloc( Bun_Align_Formula(size, alignment), 1 );
-            else                              ptr = malloc( Bun_Align_Formula(size, alignment) );
-            if (ptr == NULL && allocator_error != NULL)
-            {
-                *allocator_error = (errno == ENOMEM) ? BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY : BUN_ALLOCATOR_ERROR_UNKNOWN;
-            }
-            return ptr;
+            return Bun_Allocator__Libc_Alloc(allocator_data, allocator_error, size, mode == BUN_ALLOCATOR_MODE_ALLOC, alignment);
         case BUN_ALLOCATOR_MODE_FREE:
-            if (old_memory == NULL)
-            {
-                if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_POINTER;
-                return NULL;
-            }
-            free(old_memory);
-            return old_memory;
+            return (Bun_Allocator__Libc_Free(allocator_data, allocator_error, old_memory)) ? old_memory : NULL;
         case BUN_ALLOCATOR_MODE_FREE_ALL:
             return NULL; /*unimplemented*/
         case BUN_ALLOCATOR_MODE_RESIZE:
-            if (old_size == 0)
-            {
-                if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT;
-                return NULL;
-            }
-            /* fallthrough */
         case BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED:
-            if (old_memory == NULL || size == 0)
-            {
-                if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT;
-                return NULL;
-            }
-            if (old_memory == NULL)
-            {
-                if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_POINTER;
-                return NULL;
-            }
-
-            ptr = realloc( old_memory, Bun_Align_Formula(size, alignment) );
-
-            if (ptr == NULL)
-            {
-                if (allocator_error != NULL)
-                {
-                    *allocator_error = (errno == ENOMEM) ? BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY : BUN_ALLOCATOR_ERROR_UNKNOWN;
-                }
-                return NULL;
-            }
-
-            /* zero */
-            if (mode == BUN_ALLOCATOR_MODE_RESIZE && size > old_size)
-                memset(ptr + old_size, 0, size - old_size);
-
-            return ptr;
+            return Bun_Allocator__Libc_Resize(allocator_data, allocator_error, old_memory, size, old_size, mode == BUN_ALLOCATOR_MODE_RESIZE, alignment);
         default:
             if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED;
             return NULL;
     }
 }
 
+void *Bun_Allocator_Libc_Proc(void *allocator_data,
+                          Bun_Allocator_Error *allocator_error,
+                          Bun_Allocator_Mode mode,
+                          Bun_U32 size,
+                          Bun_U32 alignment,
+                          void *old_memory,
+                          Bun_U32 old_size
+                          )
+{
+    return Bun_Allocator_Libc_Proc64(allocator_data, allocator_error, mode, size, alignment, old_memory, old_size);
+}
+
 
 uintptr_t Bun_Align_Formula( uintptr_t size, Bun_U32 alignment)
 {
-    uintptr_t result = size + (uintptr_t)alignment-1;
+    uintptr_t result;
+    if (alignment <= 1) return size;
+    if (size > UINTPTR_MAX - ((uintptr_t)alignment-1)) return 0; /*overflow*/
+    result = size + (uintptr_t)alignment-1;
     return result - result % (uintptr_t)alignment;
 }
 
 Bun_Allocator bun_allocator_libc = (Bun_Allocator){
     .proc = &Bun_Allocator_Libc_Proc,
+    .proc64 = &Bun_Allocator_Libc_Proc64,
+    .ops = &bun_allocator_libc_ops,
     .implemented_modes = BUN_ALLOCATOR_MODE_ALLOC
                        | BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED
                        | BUN_ALLOCATOR_MODE_FREE
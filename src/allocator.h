@@ -23,6 +23,7 @@ enum
     BUN_ALLOCATOR_MODE_FREE_ALL          = (1<<3),
     BUN_ALLOCATOR_MODE_RESIZE            = (1<<4),
     BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED = (1<<5),
+    BUN_ALLOCATOR_MODE_OWNS              = (1<<6), /*returns old_memory if it was allocated by the allocator, else NULL*/
 };
 typedef void *(*Bun_Allocator_Proc)(
                                 void *allocator_data,
@@ -33,6 +34,34 @@ typedef void *(*Bun_Allocator_Proc)(
                                 void *old_memory,
                                 Bun_U32 old_size
                                );
+/*
+Same as Bun_Allocator_Proc with sizes as wide as a pointer, for allocations of 4GB and more.
+*/
+typedef void *(*Bun_Allocator_Proc64)(
+                                void *allocator_data,
+                                Bun_Allocator_Error *allocator_error,
+                                Bun_Allocator_Mode mode,
+                                Bun_USize size,
+                                Bun_U32 alignment,
+                                void *old_memory,
+                                Bun_USize old_size
+                               );
+/*
+Optional direct entry points of an allocator, one per operation, so hot code
+skips the procs switch. allocator_data is the same &allocator->data the proc
+gets. Any entry may be NULL, the proc is used for it.
+The ops belong to *proc64*, they are only used while the allocator still has
+that proc64 and implements the mode, so a copy with its procs overridden or
+modes masked goes through its own procs.
+*/
+typedef struct
+{
+    Bun_Allocator_Proc64 proc64; /*proc the ops are a shortcut of*/
+    void *(*alloc)(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_USize size, bool zeroed, Bun_U32 alignment);
+    bool  (*free)(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr);
+    void *(*resize)(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment);
+} Bun_Allocator_Ops;
+
 typedef struct
 {
     Bun_Allocator_Proc proc;
@@ -40,23 +69,84 @@ typedef struct
     Bun_Allocator_Mode implemented_modes;
     void *data;
     Bun_Allocator_Error error;
+
+    Bun_Allocator_Proc64 proc64; /*optional, used for every call when set, proc is then only a fallback for older code*/
+    const Bun_Allocator_Ops *ops; /*optional, preferred over the procs when set and owned by proc64*/
 } Bun_Allocator;
 
+/*internal, true when the ops of *allocator* may stand in for its procs in *mode**/
+#define BUN_ALLOCATOR__USE_OPS(allocator, entry, mode) \
+    ((allocator)->ops != NULL && (allocator)->ops->entry != NULL \
+  && (allocator)->ops->proc64 == (allocator)->proc64 && ((allocator)->implemented_modes & (mode)))
+
+/*internal, used by allocators wrapping another to pass its result through, copying its error on failure*/
+void *Bun_Allocator__Result(Bun_Allocator *allocator, Bun_Allocator_Error *allocator_error, void *ptr);
+
 
 void *Bun_Allocator_Alloc(Bun_U32 size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator);
 bool Bun_Allocator_Free(void *ptr, Bun_Allocator *allocator);
 bool Bun_Allocator_Free_all(Bun_Allocator *allocator);
+/*
+RETURN:
+    true if ptr was allocated by *allocator*, false if not or the allocator does not implement OWNS
+*/
+bool Bun_Allocator_Owns(void *ptr, Bun_Allocator *allocator);
 void *Bun_Allocator_Resize(void *ptr, Bun_U32 size, Bun_U32 old_size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator);
+/*
+Bun_Allocator_Alloc and Bun_Allocator_Resize with 64 bit sizes.
+Allocators without a proc64 fail sizes over 4GB with BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT.
+*/
+void *Bun_Allocator_Alloc_64(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator);
+void *Bun_Allocator_Resize_64(void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator);
+
+/*
+Inline versions of Bun_Allocator_Alloc_64, Bun_Allocator_Free and
+Bun_Allocator_Resize_64, calling straight into the allocators ops when it has them.
+*/
+BUN_INLINE void *Bun_Allocator_Alloc_Inline(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator)
+{
+    if (BUN_LIKELY(BUN_ALLOCATOR__USE_OPS(allocator, alloc, (zeroed) ? BUN_ALLOCATOR_MODE_ALLOC : BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED)))
+        return allocator->ops->alloc(&allocator->data, &allocator->error, size, zeroed, alignment);
+    return Bun_Allocator_Alloc_64(size, zeroed, alignment, allocator);
+}
+BUN_INLINE bool Bun_Allocator_Free_Inline(void *ptr, Bun_Allocator *allocator)
+{
+    if (BUN_LIKELY(BUN_ALLOCATOR__USE_OPS(allocator, free, BUN_ALLOCATOR_MODE_FREE)))
+        return allocator->ops->free(&allocator->data, &allocator->error, ptr);
+    return Bun_Allocator_Free(ptr, allocator);
+}
+BUN_INLINE void *Bun_Allocator_Resize_Inline(void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator)
+{
+    if (BUN_LIKELY(BUN_ALLOCATOR__USE_OPS(allocator, resize, (zeroed) ? BUN_ALLOCATOR_MODE_RESIZE : BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED)))
+        return allocator->ops->resize(&allocator->data, &allocator->error, ptr, size, old_size, zeroed, alignment);
+    return Bun_Allocator_Resize_64(ptr, size, old_size, zeroed, alignment, allocator);
+}
 
 /*
 Align to nearest *alignment* forward
+RETURN:
+    aligned size, or 0 if it does not fit a uintptr_t
 */
 uintptr_t Bun_Align_Formula( uintptr_t size, Bun_U32 alignment);
 
+/*
+Blocks of this many bytes and more are mapped straight from the os by
+bun_allocator_libc on linux, so resizing them is an mremap with no copy and
+zeroed growth gets fresh zero pages instead of a memset. The allocator keeps
+a table of its mapped blocks to tell them apart from malloc blocks.
+NOTE: blocks from bun_allocator_libc are not always malloc blocks, never pass
+      them to free() or realloc(), only to the allocator.
+A block resized past the threshold with an old_size of 0 stays a malloc block.
+*/
+#ifndef BUN_ALLOCATOR_LIBC_MAP_THRESHOLD
+#define BUN_ALLOCATOR_LIBC_MAP_THRESHOLD (1 << 20)
+#endif
+
 extern Bun_Allocator bun_allocator_libc;
 
 #ifdef BUN_STRIP_PREFIX
 #    define ALLOCATOR_DEFAULT_ALIGN BUN_ALLOCATOR_DEFAULT_ALIGN
+#    define ALLOCATOR_LIBC_MAP_THRESHOLD BUN_ALLOCATOR_LIBC_MAP_THRESHOLD
 #    define Allocator_Error Bun_Allocator_Error
 #        define ALLOCATOR_ERROR_NONE                 BUN_ALLOCATOR_ERROR_NONE 
 #        define ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED 
@@ -72,12 +162,21 @@ extern Bun_Allocator bun_allocator_libc;
 #        define ALLOCATOR_MODE_FREE_ALL          BUN_ALLOCATOR_MODE_FREE_ALL 
 #        define ALLOCATOR_MODE_RESIZE            BUN_ALLOCATOR_MODE_RESIZE 
 #        define ALLOCATOR_MODE_RESIZE_NON_ZEROED BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED 
+#        define ALLOCATOR_MODE_OWNS              BUN_ALLOCATOR_MODE_OWNS 
 #    define Allocator_Proc Bun_Allocator_Proc
+#    define Allocator_Proc64 Bun_Allocator_Proc64
+#    define Allocator_Ops Bun_Allocator_Ops
 #    define Allocator Bun_Allocator
 #    define Allocator_Alloc Bun_Allocator_Alloc
 #    define Allocator_Free Bun_Allocator_Free
 #    define Allocator_Free_all Bun_Allocator_Free_all
+#    define Allocator_Owns Bun_Allocator_Owns
 #    define Allocator_Resize Bun_Allocator_Resize
+#    define Allocator_Alloc_64 Bun_Allocator_Alloc_64
+#    define Allocator_Resize_64 Bun_Allocator_Resize_64
+#    define Allocator_Alloc_Inline Bun_Allocator_Alloc_Inline
+#    define Allocator_Free_Inline Bun_Allocator_Free_Inline
+#    define Allocator_Resize_Inline Bun_Allocator_Resize_Inline
 #    define Allocator_NEW Bun_Allocator_NEW
 #    define Align_Formula Bun_Align_Formula
 #    define allocator_libc bun_allocator_libc
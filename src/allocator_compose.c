@@ -0,0 +1,345 @@
+/*modes a combinator can pass through, it implements the ones all its allocators do*/
+#define BUN_ALLOCATOR_COMPOSE__MODES ( BUN_ALLOCATOR_MODE_ALLOC | BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED \
+                                     | BUN_ALLOCATOR_MODE_FREE                                        \
+                                     | BUN_ALLOCATOR_MODE_RESIZE | BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED \
+                                     | BUN_ALLOCATOR_MODE_OWNS )
+
+static bool Bun_Allocator_Compose__Free_In(Bun_Allocator *allocator, Bun_Allocator_Error *allocator_error, void *ptr)
+{
+    if (Bun_Allocator_Free_Inline(ptr, allocator)) return true;
+    if (allocator_error != NULL) *allocator_error = allocator->error;
+    return false;
+}
+
+/*
+Resize in place when *to* is the allocator ptr came from, otherwise move the
+allocation to *to*, freeing it in *from*.
+*/
+static void *Bun_Allocator_Compose__Resize_Into(Bun_Allocator *from, Bun_Allocator *to, Bun_Allocator_Error *allocator_error, void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment)
+{
+    void *new_ptr;
+
+    if (to == NULL) return Bun_Allocator__Result(NULL, allocator_error, NULL);
+    if (from == to)
+        return Bun_Allocator__Result(to, allocator_error, (Bun_Allocator_Resize_Inline)(ptr, size, old_size, zeroed, alignment, to));
+
+    new_ptr = (Bun_Allocator_Alloc_Inline)(size, false, alignment, to);
+    if (new_ptr == NULL) return Bun_Allocator__Result(to, allocator_error, NULL);
+    memcpy(new_ptr, ptr, (old_size < size) ? old_size : size);
+    if (zeroed && size > old_size) memset((Bun_Byte *)new_ptr + old_size, 0, size - old_size);
+    (Bun_Allocator_Free_Inline)(ptr, from);
+    return new_ptr;
+}
+
+static Bun_Allocator_Mode Bun_Allocator_Compose__Modes(Bun_Allocator **allocators, Bun_U32 count)
+{
+    Bun_Allocator_Mode modes = BUN_ALLOCATOR_COMPOSE__MODES;
+    Bun_U32 i;
+    for (i = 0; i < count; i++) modes &= allocators[i]->implemented_modes;
+    return modes;
+}
+
+/*
+The proc of every combinator, the operations are passed in.
+*/
+static void *Bun_Allocator_Compose__Proc(const Bun_Allocator_Ops *ops,
+                                         bool (*owns)(void *allocator_data, void *ptr),
+                                         void *allocator_data,
+                                         Bun_Allocator_Error *allocator_error,
+                                         Bun_Allocator_Mode mode,
+                                         Bun_USize size,
+                                         Bun_U32 alignment,
+                                         void *old_memory,
+                                         Bun_USize old_size
+                                         )
+{
+    switch (mode)
+    {
+        case BUN_ALLOCATOR_MODE_ALLOC:
+        case BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED:
+            return ops->alloc(allocator_data, allocator_error, size, mode == BUN_ALLOCATOR_MODE_ALLOC, alignment);
+        case BUN_ALLOCATOR_MODE_FREE:
+            return (ops->free(allocator_data, allocator_error, old_memory)) ? old_memory : NULL;
+        case BUN_ALLOCATOR_MODE_RESIZE:
+        case BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED:
+            return ops->resize(allocator_data, allocator_error, old_memory, size, old_size, mode == BUN_ALLOCATOR_MODE_RESIZE, alignment);
+        case BUN_ALLOCATOR_MODE_OWNS:
+            return (owns(allocator_data, old_memory)) ? old_memory : NULL;
+        default:
+            if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED;
+            return NULL;
+    }
+}
+
+
+/* Fallback */
+
+static Bun_Allocator *Bun_Fallback_Allocator__Owner(Bun_Fallback_Allocator *fallback, void *ptr)
+{
+    return (Bun_Allocator_Owns(ptr, fallback->primary)) ? fallback->primary : fallback->secondary;
+}
+
+static bool Bun_Fallback_Allocator__Owns(void *allocator_data, void *ptr)
+{
+    Bun_Fallback_Allocator *fallback = *(Bun_Fallback_Allocator **)allocator_data;
+    return Bun_Allocator_Owns(ptr, fallback->primary) || Bun_Allocator_Owns(ptr, fallback->secondary);
+}
+
+static void *Bun_Fallback_Allocator__Alloc(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_USize size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Fallback_Allocator *fallback = *(Bun_Fallback_Allocator **)allocator_data;
+    void *ptr = (Bun_Allocator_Alloc_Inline)(size, zeroed, alignment, fallback->primary);
+
+    if (BUN_LIKELY(ptr != NULL)) return ptr;
+    return Bun_Allocator__Result(fallback->secondary, allocator_error,
+                                 (Bun_Allocator_Alloc_Inline)(size, zeroed, alignment, fallback->secondary));
+}
+
+static bool Bun_Fallback_Allocator__Free(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr)
+{
+    Bun_Fallback_Allocator *fallback = *(Bun_Fallback_Allocator **)allocator_data;
+    return Bun_Allocator_Compose__Free_In(Bun_Fallback_Allocator__Owner(fallback, ptr), allocator_error, ptr);
+}
+
+static void *Bun_Fallback_Allocator__Resize(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Fallback_Allocator *fallback = *(Bun_Fallback_Allocator **)allocator_data;
+    Bun_Allocator *owner = Bun_Fallback_Allocator__Owner(fallback, ptr);
+    void *new_ptr = (Bun_Allocator_Resize_Inline)(ptr, size, old_size, zeroed, alignment, owner);
+
+    /*primary is out of room, move to secondary*/
+    if (new_ptr == NULL && owner == fallback->primary)
+        return Bun_Allocator_Compose__Resize_Into(owner, fallback->secondary, allocator_error, ptr, size, old_size, zeroed, alignment);
+    return Bun_Allocator__Result(owner, allocator_error, new_ptr);
+}
+
+void *Bun_Fallback_Allocator_Proc64(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode, Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size);
+static const Bun_Allocator_Ops bun_fallback_allocator_ops = {
+    .proc64 = &Bun_Fallback_Allocator_Proc64,
+    .alloc  = &Bun_Fallback_Allocator__Alloc,
+    .free   = &Bun_Fallback_Allocator__Free,
+    .resize = &Bun_Fallback_Allocator__Resize,
+};
+
+void *Bun_Fallback_Allocator_Proc64(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode,
+                                    Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size)
+{
+    return Bun_Allocator_Compose__Proc(&bun_fallback_allocator_ops, &Bun_Fallback_Allocator__Owns,
+                                       allocator_data, allocator_error, mode, size, alignment, old_memory, old_size);
+}
+void *Bun_Fallback_Allocator_Proc(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode,
+                                  Bun_U32 size, Bun_U32 alignment, void *old_memory, Bun_U32 old_size)
+{
+    return Bun_Fallback_Allocator_Proc64(allocator_data, allocator_error, mode, size, alignment, old_memory, old_size);
+}
+
+bool Bun_Fallback_Allocator_Init(Bun_Fallback_Allocator *fallback, Bun_Allocator *primary, Bun_Allocator *secondary)
+{
+    memset(fallback, 0, sizeof(*fallback));
+    if (primary == NULL || secondary == NULL || !(primary->implemented_modes & BUN_ALLOCATOR_MODE_OWNS)) return false;
+    fallback->primary   = primary;
+    fallback->secondary = secondary;
+    return true;
+}
+
+Bun_Allocator Bun_Fallback_Allocator_Interface(Bun_Fallback_Allocator *fallback)
+{
+    Bun_Allocator *allocators[2];
+    allocators[0] = fallback->primary;
+    allocators[1] = fallback->secondary;
+    return (Bun_Allocator){
+        .proc = &Bun_Fallback_Allocator_Proc,
+        .proc64 = &Bun_Fallback_Allocator_Proc64,
+        .ops = &bun_fallback_allocator_ops,
+        .implemented_modes = Bun_Allocator_Compose__Modes(allocators, 2),
+        .data = fallback,
+        .error = 0,
+    };
+}
+
+
+/* Segregator */
+
+static Bun_Allocator *Bun_Segregator_Allocator__Owner(Bun_Segregator_Allocator *segregator, void *ptr)
+{
+    if (segregator->small->implemented_modes & BUN_ALLOCATOR_MODE_OWNS)
+        return (Bun_Allocator_Owns(ptr, segregator->small)) ? segregator->small : segregator->large;
+    return (Bun_Allocator_Owns(ptr, segregator->large)) ? segregator->large : segregator->small;
+}
+
+static bool Bun_Segregator_Allocator__Owns(void *allocator_data, void *ptr)
+{
+    Bun_Segregator_Allocator *segregator = *(Bun_Segregator_Allocator **)allocator_data;
+    return Bun_Allocator_Owns(ptr, segregator->small) || Bun_Allocator_Owns(ptr, segregator->large);
+}
+
+static void *Bun_Segregator_Allocator__Alloc(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_USize size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Segregator_Allocator *segregator = *(Bun_Segregator_Allocator **)allocator_data;
+    Bun_Allocator *allocator = (size <= segregator->threshold) ? segregator->small : segregator->large;
+    return Bun_Allocator__Result(allocator, allocator_error, (Bun_Allocator_Alloc_Inline)(size, zeroed, alignment, allocator));
+}
+
+static bool Bun_Segregator_Allocator__Free(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr)
+{
+    Bun_Segregator_Allocator *segregator = *(Bun_Segregator_Allocator **)allocator_data;
+    return Bun_Allocator_Compose__Free_In(Bun_Segregator_Allocator__Owner(segregator, ptr), allocator_error, ptr);
+}
+
+static void *Bun_Segregator_Allocator__Resize(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Segregator_Allocator *segregator = *(Bun_Segregator_Allocator **)allocator_data;
+    return Bun_Allocator_Compose__Resize_Into(Bun_Segregator_Allocator__Owner(segregator, ptr),
+                                              (size <= segregator->threshold) ? segregator->small : segregator->large,
+                                              allocator_error, ptr, size, old_size, zeroed, alignment);
+}
+
+void *Bun_Segregator_Allocator_Proc64(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode, Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size);
+static const Bun_Allocator_Ops bun_segregator_allocator_ops = {
+    .proc64 = &Bun_Segregator_Allocator_Proc64,
+    .alloc  = &Bun_Segregator_Allocator__Alloc,
+    .free   = &Bun_Segregator_Allocator__Free,
+    .resize = &Bun_Segregator_Allocator__Resize,
+};
+
+void *Bun_Segregator_Allocator_Proc64(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode,
+                                      Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size)
+{
+    return Bun_Allocator_Compose__Proc(&bun_segregator_allocator_ops, &Bun_Segregator_Allocator__Owns,
+                                       allocator_data, allocator_error, mode, size, alignment, old_memory, old_size);
+}
+void *Bun_Segregator_Allocator_Proc(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode,
+                                    Bun_U32 size, Bun_U32 alignment, void *old_memory, Bun_U32 old_size)
+{
+    return Bun_Segregator_Allocator_Proc64(allocator_data, allocator_error, mode, size, alignment, old_memory, old_size);
+}
+
+bool Bun_Segregator_Allocator_Init(Bun_Segregator_Allocator *segregator, Bun_USize threshold, Bun_Allocator *small, Bun_Allocator *large)
+{
+    memset(segregator, 0, sizeof(*segregator));
+    if (small == NULL || large == NULL
+    || !((small->implemented_modes | large->implemented_modes) & BUN_ALLOCATOR_MODE_OWNS)
+    ) return false;
+    segregator->threshold = threshold;
+    segregator->small     = small;
+    segregator->large     = large;
+    return true;
+}
+
+Bun_Allocator Bun_Segregator_Allocator_Interface(Bun_Segregator_Allocator *segregator)
+{
+    Bun_Allocator *allocators[2];
+    allocators[0] = segregator->small;
+    allocators[1] = segregator->large;
+    return (Bun_Allocator){
+        .proc = &Bun_Segregator_Allocator_Proc,
+        .proc64 = &Bun_Segregator_Allocator_Proc64,
+        .ops = &bun_segregator_allocator_ops,
+        .implemented_modes = Bun_Allocator_Compose__Modes(allocators, 2),
+        .data = segregator,
+        .error = 0,
+    };
+}
+
+
+/* Bucketizer */
+
+/*RETURN: allocator of the bucket *size* falls in, NULL if past the last one*/
+static Bun_Allocator *Bun_Bucketizer_Allocator__Route(Bun_Bucketizer_Allocator *bucketizer, Bun_USize size)
+{
+    Bun_U32 i;
+    for (i = 0; i < bucketizer->count; i++)
+        if (size <= bucketizer->max_sizes[i]) return bucketizer->allocators[i];
+    return NULL;
+}
+
+static Bun_Allocator *Bun_Bucketizer_Allocator__Owner(Bun_Bucketizer_Allocator *bucketizer, void *ptr)
+{
+    Bun_U32 i;
+    for (i = 0; i + 1 < bucketizer->count; i++)
+        if (Bun_Allocator_Owns(ptr, bucketizer->allocators[i])) return bucketizer->allocators[i];
+    return bucketizer->allocators[bucketizer->count - 1];
+}
+
+static bool Bun_Bucketizer_Allocator__Owns(void *allocator_data, void *ptr)
+{
+    Bun_Bucketizer_Allocator *bucketizer = *(Bun_Bucketizer_Allocator **)allocator_data;
+    Bun_U32 i;
+    for (i = 0; i < bucketizer->count; i++)
+        if (Bun_Allocator_Owns(ptr, bucketizer->allocators[i])) return true;
+    return false;
+}
+
+static void *Bun_Bucketizer_Allocator__Alloc(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_USize size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Bucketizer_Allocator *bucketizer = *(Bun_Bucketizer_Allocator **)allocator_data;
+    Bun_Allocator *allocator = Bun_Bucketizer_Allocator__Route(bucketizer, size);
+
+    if (allocator == NULL) return Bun_Allocator__Result(NULL, allocator_error, NULL);
+    return Bun_Allocator__Result(allocator, allocator_error, (Bun_Allocator_Alloc_Inline)(size, zeroed, alignment, allocator));
+}
+
+static bool Bun_Bucketizer_Allocator__Free(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr)
+{
+    Bun_Bucketizer_Allocator *bucketizer = *(Bun_Bucketizer_Allocator **)allocator_data;
+    return Bun_Allocator_Compose__Free_In(Bun_Bucketizer_Allocator__Owner(bucketizer, ptr), allocator_error, ptr);
+}
+
+static void *Bun_Bucketizer_Allocator__Resize(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Bucketizer_Allocator *bucketizer = *(Bun_Bucketizer_Allocator **)allocator_data;
+    return Bun_Allocator_Compose__Resize_Into(Bun_Bucketizer_Allocator__Owner(bucketizer, ptr),
+                                              Bun_Bucketizer_Allocator__Route(bucketizer, size),
+                                              allocator_error, ptr, size, old_size, zeroed, alignment);
+}
+
+void *Bun_Bucketizer_Allocator_Proc64(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode, Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size);
+static const Bun_Allocator_Ops bun_bucketizer_allocator_ops = {
+    .proc64 = &Bun_Bucketizer_Allocator_Proc64,
+    .alloc  = &Bun_Bucketizer_Allocator__Alloc,
+    .free   = &Bun_Bucketizer_Allocator__Free,
+    .resize = &Bun_Bucketizer_Allocator__Resize,
+};
+
+void *Bun_Bucketizer_Allocator_Proc64(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode,
+                                      Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size)
+{
+    return Bun_Allocator_Compose__Proc(&bun_bucketizer_allocator_ops, &Bun_Bucketizer_Allocator__Owns,
+                                       allocator_data, allocator_error, mode, size, alignment, old_memory, old_size);
+}
+void *Bun_Bucketizer_Allocator_Proc(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode,
+                                    Bun_U32 size, Bun_U32 alignment, void *old_memory, Bun_U32 old_size)
+{
+    return Bun_Bucketizer_Allocator_Proc64(allocator_data, allocator_error, mode, size, alignment, old_memory, old_size);
+}
+
+bool Bun_Bucketizer_Allocator_Init(Bun_Bucketizer_Allocator *bucketizer, Bun_U32 count, const Bun_USize *max_sizes, Bun_Allocator **allocators)
+{
+    Bun_U32 i;
+
+    memset(bucketizer, 0, sizeof(*bucketizer));
+    if (count == 0 || count > BUN_BUCKETIZER_MAX_BUCKETS) return false;
+    for (i = 0; i < count; i++)
+    {
+        if (allocators[i] == NULL
+        || (i > 0 && max_sizes[i] <= max_sizes[i - 1])
+        || (i + 1 < count && !(allocators[i]->implemented_modes & BUN_ALLOCATOR_MODE_OWNS))
+        ) return false;
+        bucketizer->max_sizes[i]  = max_sizes[i];
+        bucketizer->allocators[i] = allocators[i];
+    }
+    bucketizer->count = count;
+    return true;
+}
+
+Bun_Allocator Bun_Bucketizer_Allocator_Interface(Bun_Bucketizer_Allocator *bucketizer)
+{
+    return (Bun_Allocator){
+        .proc = &Bun_Bucketizer_Allocator_Proc,
+        .proc64 = &Bun_Bucketizer_Allocator_Proc64,
+        .ops = &bun_bucketizer_allocator_ops,
+        .implemented_modes = Bun_Allocator_Compose__Modes(bucketizer->allocators, bucketizer->count),
+        .data = bucketizer,
+        .error = 0,
+    };
+}
@@ -0,0 +1,90 @@
+/*
+Allocators built out of other allocators, each one is a Bun_Allocator
+itself so they nest into allocation hierarchies without custom procs.
+
+Fallback   - allocate from primary, from secondary when primary fails.
+Segregator - sizes up to a threshold from small, bigger ones from large.
+Bucketizer - an allocator per size range, sizes past the last range fail.
+
+FREE and RESIZE need to find the allocator a pointer came from, which is
+done with BUN_ALLOCATOR_MODE_OWNS, so the allocators asked (see each Init)
+have to implement it. Allocations resized across allocators are moved.
+    Bun_Fallback_Allocator fallback;
+    Bun_Allocator allocator;
+    Bun_Fallback_Allocator_Init(&fallback, &ring_allocator, &bun_allocator_libc);
+    allocator = Bun_Fallback_Allocator_Interface(&fallback);
+*/
+
+#define BUN_BUCKETIZER_MAX_BUCKETS 16
+
+typedef struct
+{
+    Bun_Allocator *primary;   /*has to implement OWNS*/
+    Bun_Allocator *secondary;
+} Bun_Fallback_Allocator;
+
+typedef struct
+{
+    Bun_USize threshold;  /*largest size allocated from small*/
+    Bun_Allocator *small;
+    Bun_Allocator *large;
+} Bun_Segregator_Allocator;
+
+typedef struct
+{
+    Bun_U32 count;
+    Bun_USize max_sizes[BUN_BUCKETIZER_MAX_BUCKETS]; /*ascending, largest size of each bucket*/
+    Bun_Allocator *allocators[BUN_BUCKETIZER_MAX_BUCKETS];
+} Bun_Bucketizer_Allocator;
+
+/*
+ARGS:
+    fallback  - uninitialised fallback allocator.
+    primary   - allocator tried first, has to implement OWNS.
+    secondary - allocator used when primary fails.
+RETURN:
+    true on success, false if primary does not implement OWNS
+*/
+bool Bun_Fallback_Allocator_Init(Bun_Fallback_Allocator *fallback, Bun_Allocator *primary, Bun_Allocator *secondary);
+/*
+ARGS:
+    segregator - uninitialised segregator allocator.
+    threshold  - sizes up to and including it go to small.
+    small      - allocator for small sizes.
+    large      - allocator for large sizes.
+RETURN:
+    true on success, false if neither small nor large implement OWNS
+*/
+bool Bun_Segregator_Allocator_Init(Bun_Segregator_Allocator *segregator, Bun_USize threshold, Bun_Allocator *small, Bun_Allocator *large);
+/*
+ARGS:
+    bucketizer - uninitialised bucketizer allocator.
+    count      - number of buckets, at most BUN_BUCKETIZER_MAX_BUCKETS.
+    max_sizes  - largest size of each bucket, ascending.
+    allocators - allocator of each bucket, all but the last one have to implement OWNS.
+RETURN:
+    true on success, false on invalid arguments
+*/
+bool Bun_Bucketizer_Allocator_Init(Bun_Bucketizer_Allocator *bucketizer, Bun_U32 count, const Bun_USize *max_sizes, Bun_Allocator **allocators);
+
+/*
+Get the generic allocator interface of a combinator, it must outlive the returned allocator.
+implements ALLOC, ALLOC_NON_ZEROED, FREE, RESIZE and RESIZE_NON_ZEROED, as
+far as the allocators it is made of do, and OWNS if they all do.
+*/
+Bun_Allocator Bun_Fallback_Allocator_Interface(Bun_Fallback_Allocator *fallback);
+Bun_Allocator Bun_Segregator_Allocator_Interface(Bun_Segregator_Allocator *segregator);
+Bun_Allocator Bun_Bucketizer_Allocator_Interface(Bun_Bucketizer_Allocator *bucketizer);
+
+#ifdef BUN_STRIP_PREFIX
+#    define BUCKETIZER_MAX_BUCKETS BUN_BUCKETIZER_MAX_BUCKETS
+#    define Fallback_Allocator Bun_Fallback_Allocator
+#    define Segregator_Allocator Bun_Segregator_Allocator
+#    define Bucketizer_Allocator Bun_Bucketizer_Allocator
+#    define Fallback_Allocator_Init Bun_Fallback_Allocator_Init
+#    define Segregator_Allocator_Init Bun_Segregator_Allocator_Init
+#    define Bucketizer_Allocator_Init Bun_Bucketizer_Allocator_Init
+#    define Fallback_Allocator_Interface Bun_Fallback_Allocator_Interface
+#    define Segregator_Allocator_Interface Bun_Segregator_Allocator_Interface
+#    define Bucketizer_Allocator_Interface Bun_Bucketizer_Allocator_Interface
+#endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,177 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(BUN_NO_THREADS)
+#    define BUN_REMOTE_FREE__THREADS
+#    include <pthread.h>
+#endif
+
+static uintptr_t Bun_Remote_Free__Thread_Id(void)
+{
+#ifdef BUN_REMOTE_FREE__THREADS
+    return (uintptr_t)pthread_self();
+#else
+    return 0;
+#endif
+}
+
+static bool Bun_Remote_Free__Check_Owner(Bun_Remote_Free_Allocator *remote, Bun_Allocator_Error *allocator_error)
+{
+    if (remote->owner == Bun_Remote_Free__Thread_Id()) return true;
+    if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT;
+    return false;
+}
+
+Bun_USize Bun_Remote_Free_Allocator_Drain(Bun_Remote_Free_Allocator *remote)
+{
+    Bun_USize count = 0;
+    void *block, *next, *oldest = NULL;
+
+    BUN_ATOMIC_EXCHANGE(&remote->remote, NULL, block);
+    /*the list is newest first, free in the order the frees were made*/
+    for (; block != NULL; block = next)
+    {
+        next = *(void **)block;
+        *(void **)block = oldest;
+        oldest = block;
+    }
+    for (block = oldest; block != NULL; block = next)
+    {
+        next = *(void **)block;
+        (Bun_Allocator_Free_Inline)(block, remote->allocator);
+        count++;
+    }
+    remote->remote_frees += count;
+    return count;
+}
+
+static void *Bun_Remote_Free__Alloc(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_USize size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Remote_Free_Allocator *remote = *(Bun_Remote_Free_Allocator **)allocator_data;
+
+    if (!Bun_Remote_Free__Check_Owner(remote, allocator_error)) return NULL;
+    if (BUN_UNLIKELY(BUN_ATOMIC_LOAD_RELAXED(&remote->remote) != NULL))
+        Bun_Remote_Free_Allocator_Drain(remote);
+
+    if (size < sizeof(void *)) size = sizeof(void *);
+    return Bun_Allocator__Result(remote->allocator, allocator_error,
+                                 (Bun_Allocator_Alloc_Inline)(size, zeroed, alignment, remote->allocator));
+}
+
+static bool Bun_Remote_Free__Free(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr)
+{
+    Bun_Remote_Free_Allocator *remote = *(Bun_Remote_Free_Allocator **)allocator_data;
+    void *head;
+
+    if (ptr == NULL)
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_POINTER;
+        return false;
+    }
+    if (remote->owner == Bun_Remote_Free__Thread_Id())
+    {
+        if (Bun_Allocator_Free_Inline(ptr, remote->allocator)) return true;
+        if (allocator_error != NULL) *allocator_error = remote->allocator->error;
+        return false;
+    }
+
+    head = BUN_ATOMIC_LOAD_RELAXED(&remote->remote);
+    do *(void **)ptr = head;
+    while (!BUN_ATOMIC_CAS(&remote->remote, &head, ptr));
+    return true;
+}
+
+static void *Bun_Remote_Free__Resize(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Remote_Free_Allocator *remote = *(Bun_Remote_Free_Allocator **)allocator_data;
+
+    if (!Bun_Remote_Free__Check_Owner(remote, allocator_error)) return NULL;
+    if (size < sizeof(void *)) size = sizeof(void *);
+    return Bun_Allocator__Result(remote->allocator, allocator_error,
+                                 (Bun_Allocator_Resize_Inline)(ptr, size, old_size, zeroed, alignment, remote->allocator));
+}
+
+void *Bun_Remote_Free_Allocator_Proc64(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode, Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size);
+static const Bun_Allocator_Ops bun_remote_free_allocator_ops = {
+    .proc64 = &Bun_Remote_Free_Allocator_Proc64,
+    .alloc  = &Bun_Remote_Free__Alloc,
+    .free   = &Bun_Remote_Free__Free,
+    .resize = &Bun_Remote_Free__Resize,
+};
+
+void *Bun_Remote_Free_Allocator_Proc64(void *allocator_data,
+                          Bun_Allocator_Error *allocator_error,
+                          Bun_Allocator_Mode mode,
+                          Bun_USize size,
+                          Bun_U32 alignment,
+                          void *old_memory,
+                          Bun_USize old_size
+                          )
+{
+    Bun_Remote_Free_Allocator *remote = *(Bun_Remote_Free_Allocator **)allocator_data;
+    void *pending;
+
+    switch (mode)
+    {
+        case BUN_ALLOCATOR_MODE_ALLOC:
+        case BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED:
+            return Bun_Remote_Free__Alloc(allocator_data, allocator_error, size, mode == BUN_ALLOCATOR_MODE_ALLOC, alignment);
+        case BUN_ALLOCATOR_MODE_FREE:
+            return (Bun_Remote_Free__Free(allocator_data, allocator_error, old_memory)) ? old_memory : NULL;
+        case BUN_ALLOCATOR_MODE_FREE_ALL:
+            if (!Bun_Remote_Free__Check_Owner(remote, allocator_error)) return NULL;
+            /*the pending blocks go with everything else*/
+            BUN_ATOMIC_EXCHANGE(&remote->remote, NULL, pending);
+            (void)pending;
+            if (Bun_Allocator_Free_all(remote->allocator)) return remote;
+            return Bun_Allocator__Result(remote->allocator, allocator_error, NULL);
+        case BUN_ALLOCATOR_MODE_RESIZE:
+        case BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED:
+            return Bun_Remote_Free__Resize(allocator_data, allocator_error, old_memory, size, old_size, mode == BUN_ALLOCATOR_MODE_RESIZE, alignment);
+        case BUN_ALLOCATOR_MODE_OWNS:
+            if (!Bun_Remote_Free__Check_Owner(remote, allocator_error)) return NULL;
+            return (Bun_Allocator_Owns(old_memory, remote->allocator)) ? old_memory : NULL;
+        default:
+            if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED;
+            return NULL;
+    }
+}
+
+void *Bun_Remote_Free_Allocator_Proc(void *allocator_data,
+                          Bun_Allocator_Error *allocator_error,
+                          Bun_Allocator_Mode mode,
+                          Bun_U32 size,
+                          Bun_U32 alignment,
+                          void *old_memory,
+                          Bun_U32 old_size
+                          )
+{
+    return Bun_Remote_Free_Allocator_Proc64(allocator_data, allocator_error, mode, size, alignment, old_memory, old_size);
+}
+
+void Bun_Remote_Free_Allocator_Init(Bun_Remote_Free_Allocator *remote, Bun_Allocator *allocator)
+{
+    memset(remote, 0, sizeof(*remote));
+    remote->allocator = allocator;
+    remote->owner = Bun_Remote_Free__Thread_Id();
+}
+
+void Bun_Remote_Free_Allocator_Deinit(Bun_Remote_Free_Allocator *remote)
+{
+    Bun_Remote_Free_Allocator_Drain(remote);
+    memset(remote, 0, sizeof(*remote));
+}
+
+void Bun_Remote_Free_Allocator_Claim(Bun_Remote_Free_Allocator *remote)
+{
+    remote->owner = Bun_Remote_Free__Thread_Id();
+}
+
+Bun_Allocator Bun_Remote_Free_Allocator_Interface(Bun_Remote_Free_Allocator *remote)
+{
+    return (Bun_Allocator){
+        .proc = &Bun_Remote_Free_Allocator_Proc,
+        .proc64 = &Bun_Remote_Free_Allocator_Proc64,
+        .ops = &bun_remote_free_allocator_ops,
+        .implemented_modes = remote->allocator->implemented_modes,
+        .data = remote,
+        .error = 0,
+    };
+}
@@ -0,0 +1,75 @@
+/*
+Remote free allocator, lets other threads free into a single threaded allocator.
+
+Wraps an allocator owned by one thread (a ring or pool allocator, an
+arena...). The owner allocates and frees through it as usual, frees from any
+other thread are pushed onto a lock free list instead of touching the
+allocator. The owner takes the whole list in one atomic exchange and frees
+it in bulk, in the order the frees happened, on its next allocation that
+finds it non empty (checking is a single load) or on
+Bun_Remote_Free_Allocator_Drain.
+NOTE: remote frees come in whatever order the other threads make them, so
+      allocators needing a set free order (a stack allocator) can not be wrapped.
+
+Freed blocks are linked through their first bytes, so allocations are at
+least pointer sized. Only the owner may allocate, resize, free all or ask
+OWNS, and no other thread may be freeing during a free all.
+    Bun_Remote_Free_Allocator remote;
+    Bun_Allocator allocator;
+    Bun_Remote_Free_Allocator_Init(&remote, &ring_allocator);
+    allocator = Bun_Remote_Free_Allocator_Interface(&remote);
+    ...hand pointers to a consumer thread that frees them with &allocator
+*/
+
+typedef struct
+{
+    Bun_Allocator *allocator; /*only ever called by the owner*/
+    void *remote;             /*blocks freed by other threads, not freed yet*/
+    uintptr_t owner;          /*id of the owning thread*/
+    Bun_USize remote_frees;   /*blocks freed by other threads so far*/
+} Bun_Remote_Free_Allocator;
+
+/*
+Initialise a remote free allocator owned by the calling thread.
+
+ARGS:
+    remote    - uninitialised remote free allocator.
+    allocator - the allocator to wrap, must outlive the remote free allocator.
+*/
+void Bun_Remote_Free_Allocator_Init(Bun_Remote_Free_Allocator *remote, Bun_Allocator *allocator);
+/*
+Free the pending remote frees, other threads must be done freeing.
+*/
+void Bun_Remote_Free_Allocator_Deinit(Bun_Remote_Free_Allocator *remote);
+/*
+Make the calling thread the owner, when handing an allocator to another
+thread. The old owner must not use it anymore, and the hand off has to
+synchronise with the threads freeing (a mutex, a thread start...).
+*/
+void Bun_Remote_Free_Allocator_Claim(Bun_Remote_Free_Allocator *remote);
+/*
+Free every block other threads freed so far, only called by the owner.
+
+RETURN:
+    number of blocks freed
+*/
+Bun_USize Bun_Remote_Free_Allocator_Drain(Bun_Remote_Free_Allocator *remote);
+/*
+Get the generic allocator interface of a remote free allocator.
+implements the modes of the wrapped allocator, errors of the wrapped
+allocator are copied. Calls other then FREE from other threads fail with
+BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT.
+
+ARGS:
+    remote - an initialised remote free allocator, must outlive the returned allocator.
+*/
+Bun_Allocator Bun_Remote_Free_Allocator_Interface(Bun_Remote_Free_Allocator *remote);
+
+#ifdef BUN_STRIP_PREFIX
+#    define Remote_Free_Allocator Bun_Remote_Free_Allocator
+#    define Remote_Free_Allocator_Init Bun_Remote_Free_Allocator_Init
+#    define Remote_Free_Allocator_Deinit Bun_Remote_Free_Allocator_Deinit
+#    define Remote_Free_Allocator_Claim Bun_Remote_Free_Allocator_Claim
+#    define Remote_Free_Allocator_Drain Bun_Remote_Free_Allocator_Drain
+#    define Remote_Free_Allocator_Interface Bun_Remote_Free_Allocator_Interface
+#endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,266 @@
+/*
+Header at the start of every block, blocks start 16 byte aligned and are a
+multiple of 16 long. When the allocation is aligned past the header a copy
+of it sits right before the allocation, so the block start is always at
+allocation - offset. The ends of the buffer skipped when wrapping are blocks
+with offset 0 that are freed from the start.
+*/
+typedef struct
+{
+    Bun_U64 size;   /*bytes of the whole block*/
+    Bun_U32 offset; /*from the block start to the allocation*/
+    Bun_U32 freed;
+} Bun_Ring_Allocator__Header;
+
+#define BUN_RING_ALLOCATOR__BLOCK_ALIGN 16
+
+/*
+RETURN:
+    size of a block at *at* fitting *size* bytes aligned to *alignment*, 0 if it can not fit anywhere
+*/
+static Bun_USize Bun_Ring_Allocator__Block_Size(Bun_Ring_Allocator *ring, Bun_USize at, Bun_USize size, Bun_U32 alignment, Bun_U32 *offset)
+{
+    uintptr_t start = (uintptr_t)ring->buffer + at;
+    uintptr_t ptr = Bun_Align_Formula(start + sizeof(Bun_Ring_Allocator__Header), alignment);
+
+    if (ptr == 0 || ptr - start > (Bun_U32)-1 || size > ring->capacity) return 0;
+    *offset = (Bun_U32)(ptr - start);
+    return Bun_Align_Formula(*offset + size, BUN_RING_ALLOCATOR__BLOCK_ALIGN);
+}
+
+static void Bun_Ring_Allocator__Set_Header(Bun_Byte *start, Bun_USize size, Bun_U32 offset)
+{
+    Bun_Ring_Allocator__Header header;
+    header.size   = size;
+    header.offset = offset;
+    header.freed  = 0;
+    *(Bun_Ring_Allocator__Header *)start = header;
+    if (offset > sizeof(header)) *((Bun_Ring_Allocator__Header *)(start + offset) - 1) = header;
+}
+
+/*
+RETURN:
+    header of a live allocation, NULL if ptr can not be one
+*/
+static Bun_Ring_Allocator__Header *Bun_Ring_Allocator__Find(Bun_Ring_Allocator *ring, void *ptr)
+{
+    Bun_Ring_Allocator__Header *header;
+
+    if ((uintptr_t)ptr < (uintptr_t)ring->buffer + sizeof(*header)
+    ||  (uintptr_t)ptr > (uintptr_t)ring->buffer + ring->capacity
+    ||  (uintptr_t)ptr % BUN_RING_ALLOCATOR__BLOCK_ALIGN
+    ) return NULL;
+
+    header = (Bun_Ring_Allocator__Header *)ptr - 1;
+    if (header->offset < sizeof(*header) || header->offset > (uintptr_t)ptr - (uintptr_t)ring->buffer) return NULL;
+    header = (Bun_Ring_Allocator__Header *)((Bun_Byte *)ptr - header->offset);
+    return (header->freed) ? NULL : header;
+}
+
+static void *Bun_Ring_Allocator__Alloc(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_USize size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Ring_Allocator *ring = *(Bun_Ring_Allocator **)allocator_data;
+    Bun_Ring_Allocator__Header *skip;
+    Bun_USize block, end;
+    Bun_U32 offset;
+    Bun_Byte *ptr;
+
+    /*allocations have to stay 16 byte aligned for free to find them, which only powers of two keep*/
+    if (alignment & (alignment - 1))
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+    /*empty, start over at the front for the most room*/
+    if (ring->used == 0) ring->head = ring->tail = 0;
+    end = (ring->head >= ring->tail && ring->used < ring->capacity) ? ring->capacity : ring->tail;
+
+    block = Bun_Ring_Allocator__Block_Size(ring, ring->head, size, alignment, &offset);
+    if (block == 0 || block > end - ring->head)
+    {
+        /*skip the rest of the buffer and wrap to the front*/
+        if (end != ring->capacity) goto Error_Exit;
+        block = Bun_Ring_Allocator__Block_Size(ring, 0, size, alignment, &offset);
+        if (block == 0 || block > ring->tail) goto Error_Exit;
+
+        skip = (Bun_Ring_Allocator__Header *)(ring->buffer + ring->head);
+        skip->size   = ring->capacity - ring->head;
+        skip->offset = 0;
+        skip->freed  = 1;
+        ring->used  += ring->capacity - ring->head;
+        ring->head   = 0;
+    }
+
+    Bun_Ring_Allocator__Set_Header(ring->buffer + ring->head, block, offset);
+    ptr = ring->buffer + ring->head + offset;
+    ring->head += block;
+    ring->used += block;
+    if (ring->head == ring->capacity) ring->head = 0;
+
+    if (zeroed) memset(ptr, 0, size);
+    return ptr;
+
+Error_Exit:
+    if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY;
+    return NULL;
+}
+
+static bool Bun_Ring_Allocator__Free(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr)
+{
+    Bun_Ring_Allocator *ring = *(Bun_Ring_Allocator **)allocator_data;
+    Bun_Ring_Allocator__Header *header = Bun_Ring_Allocator__Find(ring, ptr);
+
+    if (header == NULL)
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_POINTER;
+        return false;
+    }
+    header->freed = 1;
+
+    /*move the tail past every freed block, out of order frees are picked up here*/
+    while (ring->used)
+    {
+        header = (Bun_Ring_Allocator__Header *)(ring->buffer + ring->tail);
+        if (!header->freed) break;
+        ring->used -= header->size;
+        ring->tail += header->size;
+        if (ring->tail == ring->capacity) ring->tail = 0;
+    }
+    return true;
+}
+
+static void *Bun_Ring_Allocator__Resize(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Ring_Allocator *ring = *(Bun_Ring_Allocator **)allocator_data;
+    Bun_Ring_Allocator__Header *header;
+    Bun_USize start, block, limit;
+    void *new_ptr;
+
+    if (ptr == NULL || size == 0)
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+    header = Bun_Ring_Allocator__Find(ring, ptr);
+    if (header == NULL)
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_POINTER;
+        return NULL;
+    }
+    if (old_size > header->size - header->offset) old_size = header->size - header->offset;
+
+    /*still fits the block, or the block is the newest and can grow into the free space after it*/
+    start = (Bun_Byte *)header - ring->buffer;
+    block = Bun_Align_Formula(header->offset + size, BUN_RING_ALLOCATOR__BLOCK_ALIGN);
+    limit = (ring->head > ring->tail) ? ring->capacity : ring->tail;
+    if (block != 0
+    && (block <= header->size || (start + header->size == ring->head && block <= limit - start))
+    )
+    {
+        if (start + header->size == ring->head)
+        {
+            ring->used += block - header->size;
+            ring->head = start + block;
+            if (ring->head == ring->capacity) ring->head = 0;
+            Bun_Ring_Allocator__Set_Header((Bun_Byte *)header, block, header->offset);
+        }
+        if (zeroed && size > old_size) memset((Bun_Byte *)ptr + old_size, 0, size - old_size);
+        return ptr;
+    }
+
+    new_ptr = Bun_Ring_Allocator__Alloc(allocator_data, allocator_error, size, false, alignment);
+    if (new_ptr == NULL) return NULL;
+    memcpy(new_ptr, ptr, (old_size < size) ? old_size : size);
+    if (zeroed && size > old_size) memset((Bun_Byte *)new_ptr + old_size, 0, size - old_size);
+    Bun_Ring_Allocator__Free(allocator_data, allocator_error, ptr);
+    return new_ptr;
+}
+
+void *Bun_Ring_Allocator_Proc64(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode, Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size);
+static const Bun_Allocator_Ops bun_ring_allocator_ops = {
+    .proc64 = &Bun_Ring_Allocator_Proc64,
+    .alloc  = &Bun_Ring_Allocator__Alloc,
+    .free   = &Bun_Ring_Allocator__Free,
+    .resize = &Bun_Ring_Allocator__Resize,
+};
+
+void *Bun_Ring_Allocator_Proc64(void *allocator_data,
+                          Bun_Allocator_Error *allocator_error,
+                          Bun_Allocator_Mode mode,
+                          Bun_USize size,
+                          Bun_U32 alignment,
+                          void *old_memory,
+                          Bun_USize old_size
+                          )
+{
+    Bun_Ring_Allocator *ring = *(Bun_Ring_Allocator **)allocator_data;
+
+    switch (mode)
+    {
+        case BUN_ALLOCATOR_MODE_ALLOC:
+        case BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED:
+            return Bun_Ring_Allocator__Alloc(allocator_data, allocator_error, size, mode == BUN_ALLOCATOR_MODE_ALLOC, alignment);
+        case BUN_ALLOCATOR_MODE_FREE:
+            return (Bun_Ring_Allocator__Free(allocator_data, allocator_error, old_memory)) ? old_memory : NULL;
+        case BUN_ALLOCATOR_MODE_FREE_ALL:
+            ring->head = ring->tail = ring->used = 0;
+            return ring->buffer;
+        case BUN_ALLOCATOR_MODE_RESIZE:
+        case BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED:
+            return Bun_Ring_Allocator__Resize(allocator_data, allocator_error, old_memory, size, old_size, mode == BUN_ALLOCATOR_MODE_RESIZE, alignment);
+        case BUN_ALLOCATOR_MODE_OWNS:
+            return ((uintptr_t)old_memory >= (uintptr_t)ring->buffer && (uintptr_t)old_memory < (uintptr_t)ring->buffer + ring->capacity) ? old_memory : NULL;
+        default:
+            if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED;
+            return NULL;
+    }
+}
+
+void *Bun_Ring_Allocator_Proc(void *allocator_data,
+                          Bun_Allocator_Error *allocator_error,
+                          Bun_Allocator_Mode mode,
+                          Bun_U32 size,
+                          Bun_U32 alignment,
+                          void *old_memory,
+                          Bun_U32 old_size
+                          )
+{
+    return Bun_Ring_Allocator_Proc64(allocator_data, allocator_error, mode, size, alignment, old_memory, old_size);
+}
+
+bool Bun_Ring_Allocator_Init(Bun_Ring_Allocator *ring, Bun_Allocator *allocator, Bun_USize capacity)
+{
+    memset(ring, 0, sizeof(*ring));
+    capacity = Bun_Align_Formula(capacity, BUN_RING_ALLOCATOR__BLOCK_ALIGN);
+    if (capacity == 0) return false;
+
+    ring->buffer = (Bun_Allocator_Alloc_64)(capacity, false, BUN_RING_ALLOCATOR__BLOCK_ALIGN, allocator);
+    if (ring->buffer == NULL) return false;
+    ring->capacity  = capacity;
+    ring->allocator = allocator;
+    return true;
+}
+
+void Bun_Ring_Allocator_Deinit(Bun_Ring_Allocator *ring)
+{
+    if (ring->buffer != NULL) (Bun_Allocator_Free)(ring->buffer, ring->allocator);
+    memset(ring, 0, sizeof(*ring));
+}
+
+Bun_Allocator Bun_Ring_Allocator_Interface(Bun_Ring_Allocator *ring)
+{
+    return (Bun_Allocator){
+        .proc = &Bun_Ring_Allocator_Proc,
+        .proc64 = &Bun_Ring_Allocator_Proc64,
+        .ops = &bun_ring_allocator_ops,
+        .implemented_modes = BUN_ALLOCATOR_MODE_ALLOC
+                           | BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED
+                           | BUN_ALLOCATOR_MODE_FREE
+                           | BUN_ALLOCATOR_MODE_FREE_ALL
+                           | BUN_ALLOCATOR_MODE_RESIZE
+                           | BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED
+                           | BUN_ALLOCATOR_MODE_OWNS,
+        .data = ring,
+        .error = 0,
+    };
+}
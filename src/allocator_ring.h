@@ -0,0 +1,59 @@
+/*
+Ring allocator, a circular buffer for allocations freed in about the order
+they were made (messages, queue entries, per frame data).
+
+Allocations are bumped at the head, freeing the oldest live allocation
+moves the tail past it and past every later allocation already freed, so
+frees out of order are only recorded until the ones before them are gone.
+Memory is bounded by the buffer, allocating fails once the head would run
+into the tail.
+
+Each allocation has a 16 byte header in front, not thread safe. Alignments
+must be powers of two, others fail with BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT.
+    Bun_Ring_Allocator ring;
+    Bun_Allocator allocator;
+    Bun_Ring_Allocator_Init(&ring, &bun_allocator_libc, 1 << 20);
+    allocator = Bun_Ring_Allocator_Interface(&ring);
+*/
+
+typedef struct
+{
+    Bun_Byte *buffer;
+    Bun_USize capacity;
+    Bun_USize head; /*offset of the next allocation*/
+    Bun_USize tail; /*offset of the oldest allocation not freed*/
+    Bun_USize used; /*bytes between tail and head, headers, padding and skipped ends included*/
+    Bun_Allocator *allocator;
+} Bun_Ring_Allocator;
+
+/*
+Initialise a ring allocator with a buffer from *allocator*.
+
+ARGS:
+    ring      - uninitialised ring allocator.
+    allocator - allocator for the buffer, must outlive the ring allocator.
+    capacity  - size in bytes of the buffer, rounded up to 16.
+RETURN:
+    true on success, false on failure
+*/
+bool Bun_Ring_Allocator_Init(Bun_Ring_Allocator *ring, Bun_Allocator *allocator, Bun_USize capacity);
+/*
+Free the buffer, every allocation is invalidated.
+*/
+void Bun_Ring_Allocator_Deinit(Bun_Ring_Allocator *ring);
+/*
+Get the generic allocator interface of a ring allocator.
+implements ALLOC, ALLOC_NON_ZEROED, FREE, FREE_ALL, RESIZE, RESIZE_NON_ZEROED and OWNS.
+Resizing the newest allocation is done in place when there is room.
+
+ARGS:
+    ring - an initialised ring allocator, must outlive the returned allocator.
+*/
+Bun_Allocator Bun_Ring_Allocator_Interface(Bun_Ring_Allocator *ring);
+
+#ifdef BUN_STRIP_PREFIX
+#    define Ring_Allocator Bun_Ring_Allocator
+#    define Ring_Allocator_Init Bun_Ring_Allocator_Init
+#    define Ring_Allocator_Deinit Bun_Ring_Allocator_Deinit
+#    define Ring_Allocator_Interface Bun_Ring_Allocator_Interface
+#endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,199 @@
+#ifndef NDEBUG
+#    define BUN_STACK_ALLOCATOR__CHECKS
+#    include <assert.h>
+#endif
+
+/*
+Header right before every allocation, restoring offset and top pops it.
+With checks on it also holds a hash of the other fields to catch overwrites.
+*/
+typedef struct
+{
+    Bun_USize prev_offset;
+    Bun_USize prev_top;
+#ifdef BUN_STACK_ALLOCATOR__CHECKS
+    Bun_USize check;
+#endif
+} Bun_Stack_Allocator__Header;
+
+#define BUN_STACK_ALLOCATOR__CHECK(header) \
+    ((header)->prev_offset * 0x9e3779b9u ^ (header)->prev_top ^ (Bun_USize)0x5354414bu) /*"STAK"*/
+
+static void *Bun_Stack_Allocator__Alloc(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_USize size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Stack_Allocator *stack = *(Bun_Stack_Allocator **)allocator_data;
+    Bun_Stack_Allocator__Header header;
+    uintptr_t ptr;
+
+    /*the header is stored unaligned when the allocation is less aligned then it*/
+    ptr = Bun_Align_Formula((uintptr_t)stack->buffer + stack->offset + sizeof(header), alignment);
+    if (ptr == 0 || size > stack->capacity || ptr - (uintptr_t)stack->buffer > stack->capacity - size)
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY;
+        return NULL;
+    }
+
+    header.prev_offset = stack->offset;
+    header.prev_top    = stack->top;
+#ifdef BUN_STACK_ALLOCATOR__CHECKS
+    header.check       = BUN_STACK_ALLOCATOR__CHECK(&header);
+#endif
+    memcpy((Bun_Stack_Allocator__Header *)ptr - 1, &header, sizeof(header));
+    stack->top    = ptr - (uintptr_t)stack->buffer;
+    stack->offset = stack->top + size;
+
+    if (zeroed) memset((void *)ptr, 0, size);
+    return (void *)ptr;
+}
+
+/*
+RETURN:
+    true if ptr is the top allocation
+*/
+static bool Bun_Stack_Allocator__Is_Top(Bun_Stack_Allocator *stack, Bun_Allocator_Error *allocator_error, void *ptr)
+{
+    if (stack->top != 0 && ptr == stack->buffer + stack->top) return true;
+    if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_POINTER;
+    return false;
+}
+
+static bool Bun_Stack_Allocator__Free(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr)
+{
+    Bun_Stack_Allocator *stack = *(Bun_Stack_Allocator **)allocator_data;
+    Bun_Stack_Allocator__Header header;
+
+    if (!Bun_Stack_Allocator__Is_Top(stack, allocator_error, ptr))
+    {
+#ifdef BUN_STACK_ALLOCATOR__CHECKS
+        assert(!"stack allocator: free out of LIFO order");
+#endif
+        return false;
+    }
+
+    memcpy(&header, (Bun_Stack_Allocator__Header *)ptr - 1, sizeof(header));
+#ifdef BUN_STACK_ALLOCATOR__CHECKS
+    assert(header.check == BUN_STACK_ALLOCATOR__CHECK(&header) && "stack allocator: header overwritten");
+#endif
+    stack->offset = header.prev_offset;
+    stack->top    = header.prev_top;
+    return true;
+}
+
+static void *Bun_Stack_Allocator__Resize(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Stack_Allocator *stack = *(Bun_Stack_Allocator **)allocator_data;
+    (void)alignment; /*resizing never moves*/
+
+    if (ptr == NULL || size == 0)
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+
+    if (Bun_Stack_Allocator__Is_Top(stack, NULL, ptr))
+    {
+        if (size > stack->capacity - stack->top)
+        {
+            if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY;
+            return NULL;
+        }
+        old_size = stack->offset - stack->top;
+        stack->offset = stack->top + size;
+    }
+    else if (size > old_size)
+    {
+        if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_POINTER;
+        return NULL;
+    }
+
+    if (zeroed && size > old_size) memset((Bun_Byte *)ptr + old_size, 0, size - old_size);
+    return ptr;
+}
+
+void *Bun_Stack_Allocator_Proc64(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode, Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size);
+static const Bun_Allocator_Ops bun_stack_allocator_ops = {
+    .proc64 = &Bun_Stack_Allocator_Proc64,
+    .alloc  = &Bun_Stack_Allocator__Alloc,
+    .free   = &Bun_Stack_Allocator__Free,
+    .resize = &Bun_Stack_Allocator__Resize,
+};
+
+void *Bun_Stack_Allocator_Proc64(void *allocator_data,
+                          Bun_Allocator_Error *allocator_error,
+                          Bun_Allocator_Mode mode,
+                          Bun_USize size,
+                          Bun_U32 alignment,
+                          void *old_memory,
+                          Bun_USize old_size
+                          )
+{
+    Bun_Stack_Allocator *stack = *(Bun_Stack_Allocator **)allocator_data;
+
+    switch (mode)
+    {
+        case BUN_ALLOCATOR_MODE_ALLOC:
+        case BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED:
+            return Bun_Stack_Allocator__Alloc(allocator_data, allocator_error, size, mode == BUN_ALLOCATOR_MODE_ALLOC, alignment);
+        case BUN_ALLOCATOR_MODE_FREE:
+            return (Bun_Stack_Allocator__Free(allocator_data, allocator_error, old_memory)) ? old_memory : NULL;
+        case BUN_ALLOCATOR_MODE_FREE_ALL:
+            stack->offset = stack->top = 0;
+            return stack->buffer;
+        case BUN_ALLOCATOR_MODE_RESIZE:
+        case BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED:
+            return Bun_Stack_Allocator__Resize(allocator_data, allocator_error, old_memory, size, old_size, mode == BUN_ALLOCATOR_MODE_RESIZE, alignment);
+        case BUN_ALLOCATOR_MODE_OWNS:
+            return ((uintptr_t)old_memory >= (uintptr_t)stack->buffer && (uintptr_t)old_memory < (uintptr_t)stack->buffer + stack->capacity) ? old_memory : NULL;
+        default:
+            if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED;
+            return NULL;
+    }
+}
+
+void *Bun_Stack_Allocator_Proc(void *allocator_data,
+                          Bun_Allocator_Error *allocator_error,
+                          Bun_Allocator_Mode mode,
+                          Bun_U32 size,
+                          Bun_U32 alignment,
+                          void *old_memory,
+                          Bun_U32 old_size
+                          )
+{
+    return Bun_Stack_Allocator_Proc64(allocator_data, allocator_error, mode, size, alignment, old_memory, old_size);
+}
+
+bool Bun_Stack_Allocator_Init(Bun_Stack_Allocator *stack, Bun_Allocator *allocator, Bun_USize capacity)
+{
+    memset(stack, 0, sizeof(*stack));
+    if (capacity == 0) return false;
+
+    stack->buffer = (Bun_Allocator_Alloc_64)(capacity, false, BUN_ALLOCATOR_DEFAULT_ALIGN, allocator);
+    if (stack->buffer == NULL) return false;
+    stack->capacity  = capacity;
+    stack->allocator = allocator;
+    return true;
+}
+
+void Bun_Stack_Allocator_Deinit(Bun_Stack_Allocator *stack)
+{
+    if (stack->buffer != NULL) (Bun_Allocator_Free)(stack->buffer, stack->allocator);
+    memset(stack, 0, sizeof(*stack));
+}
+
+Bun_Allocator Bun_Stack_Allocator_Interface(Bun_Stack_Allocator *stack)
+{
+    return (Bun_Allocator){
+        .proc = &Bun_Stack_Allocator_Proc,
+        .proc64 = &Bun_Stack_Allocator_Proc64,
+        .ops = &bun_stack_allocator_ops,
+        .implemented_modes = BUN_ALLOCATOR_MODE_ALLOC
+                           | BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED
+                           | BUN_ALLOCATOR_MODE_FREE
+                           | BUN_ALLOCATOR_MODE_FREE_ALL
+                           | BUN_ALLOCATOR_MODE_RESIZE
+                           | BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED
+                           | BUN_ALLOCATOR_MODE_OWNS,
+        .data = stack,
+        .error = 0,
+    };
+}
@@ -0,0 +1,58 @@
+/*
+Stack allocator, a fixed buffer where only the newest allocation is freed.
+
+Like an arena allocations are bumped from the start of the buffer, but each
+one has a header recording where the stack was before it, so FREE pops the
+top allocation and RESIZE grows or shrinks it in place.
+Freeing anything but the top is an error, caught with an assert unless
+NDEBUG is defined (the headers are also checked for overwrites then), and
+only reported through the allocator error otherwise.
+
+Not thread safe.
+    Bun_Stack_Allocator stack;
+    Bun_Allocator allocator;
+    Bun_Stack_Allocator_Init(&stack, &bun_allocator_libc, 1 << 16);
+    allocator = Bun_Stack_Allocator_Interface(&stack);
+*/
+
+typedef struct
+{
+    Bun_Byte *buffer;
+    Bun_USize capacity;
+    Bun_USize offset; /*end of the top allocation*/
+    Bun_USize top;    /*offset of the top allocation, 0 when empty*/
+    Bun_Allocator *allocator;
+} Bun_Stack_Allocator;
+
+/*
+Initialise a stack allocator with a buffer from *allocator*.
+
+ARGS:
+    stack     - uninitialised stack allocator.
+    allocator - allocator for the buffer, must outlive the stack allocator.
+    capacity  - size in bytes of the buffer.
+RETURN:
+    true on success, false on failure
+*/
+bool Bun_Stack_Allocator_Init(Bun_Stack_Allocator *stack, Bun_Allocator *allocator, Bun_USize capacity);
+/*
+Free the buffer, every allocation is invalidated.
+*/
+void Bun_Stack_Allocator_Deinit(Bun_Stack_Allocator *stack);
+/*
+Get the generic allocator interface of a stack allocator.
+implements ALLOC, ALLOC_NON_ZEROED, FREE, FREE_ALL, RESIZE, RESIZE_NON_ZEROED and OWNS.
+FREE only takes the top allocation, RESIZE grows only the top allocation
+and shrinks any other one without giving the memory back.
+
+ARGS:
+    stack - an initialised stack allocator, must outlive the returned allocator.
+*/
+Bun_Allocator Bun_Stack_Allocator_Interface(Bun_Stack_Allocator *stack);
+
+#ifdef BUN_STRIP_PREFIX
+#    define Stack_Allocator Bun_Stack_Allocator
+#    define Stack_Allocator_Init Bun_Stack_Allocator_Init
+#    define Stack_Allocator_Deinit Bun_Stack_Allocator_Deinit
+#    define Stack_Allocator_Interface Bun_Stack_Allocator_Interface
+#endif /*ifdef BUN_STRIP_PREFIX*/
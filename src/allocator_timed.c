@@ -0,0 +1,370 @@
+#if defined(__unix__) || defined(__APPLE__)
+#    define BUN_TIMED__CLOCK_GETTIME
+#endif
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#    define BUN_TIMED__RDTSC
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+#    define BUN_TIMED__CNTVCT
+#endif
+#include <time.h>
+
+#define BUN_LATENCY__SUB_COUNT (1u << BUN_LATENCY_SUB_BITS)
+#define BUN_LATENCY__EMPTY_MIN ((Bun_U64)-1)
+
+/*ns = ticks * mult >> BUN_TIMED__MULT_SHIFT, small enough that a 24MHz counter can not overflow it*/
+#define BUN_TIMED__MULT_SHIFT 24
+#define BUN_TIMED__CALIBRATE_NS 5000000u
+
+static Bun_U64 bun_timed__mult;
+
+static const char *bun_timed__mode_names[BUN_TIMED_ALLOCATOR_MODES] = {
+    "alloc", "alloc_non_zeroed", "free", "free_all", "resize", "resize_non_zeroed", "owns",
+};
+
+/* -- histograms -- */
+
+static Bun_U32 Bun_Latency__Bucket(Bun_U64 ns)
+{
+    Bun_U32 exponent;
+
+    if (ns < BUN_LATENCY__SUB_COUNT) return (Bun_U32)ns;
+    if ((ns >> BUN_LATENCY_MAX_EXPONENT) != 0) return BUN_LATENCY_BUCKETS - 1;
+    /*shift leaving ns in [SUB_COUNT, 2*SUB_COUNT)*/
+#if defined(__GNUC__) || defined(__clang__)
+    exponent = 63 - __builtin_clzll(ns) - BUN_LATENCY_SUB_BITS;
+#else
+    for (exponent = 0; (ns >> exponent) >= 2*BUN_LATENCY__SUB_COUNT; exponent++);
+#endif
+    return ((exponent + 1) << BUN_LATENCY_SUB_BITS) + (Bun_U32)(ns >> exponent) - BUN_LATENCY__SUB_COUNT;
+}
+
+/*
+RETURN:
+    the largest value that lands in bucket
+*/
+static Bun_U64 Bun_Latency__Bucket_Max(Bun_U32 bucket)
+{
+    Bun_U32 exponent;
+    Bun_U64 low;
+
+    if (bucket < 2*BUN_LATENCY__SUB_COUNT) return bucket;
+    exponent = (bucket >> BUN_LATENCY_SUB_BITS) - 1;
+    low = (Bun_U64)((bucket & (BUN_LATENCY__SUB_COUNT - 1)) + BUN_LATENCY__SUB_COUNT) << exponent;
+    return low + ((Bun_U64)1 << exponent) - 1;
+}
+
+void Bun_Latency_Histogram_Reset(Bun_Latency_Histogram *histogram)
+{
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->min_ns = BUN_LATENCY__EMPTY_MIN;
+}
+
+void Bun_Latency_Histogram_Record(Bun_Latency_Histogram *histogram, Bun_U64 ns)
+{
+    Bun_U64 old;
+
+    BUN_ATOMIC_ADD(&histogram->buckets[Bun_Latency__Bucket(ns)], 1);
+    BUN_ATOMIC_ADD(&histogram->count, 1);
+    BUN_ATOMIC_ADD(&histogram->sum_ns, ns);
+    old = BUN_ATOMIC_LOAD_RELAXED(&histogram->min_ns);
+    while (ns < old && !BUN_ATOMIC_CAS(&histogram->min_ns, &old, ns));
+    old = BUN_ATOMIC_LOAD_RELAXED(&histogram->max_ns);
+    while (ns > old && !BUN_ATOMIC_CAS(&histogram->max_ns, &old, ns));
+}
+
+void Bun_Latency_Histogram_Merge(Bun_Latency_Histogram *into, const Bun_Latency_Histogram *from)
+{
+    Bun_U32 i;
+
+    into->count += from->count;
+    into->sum_ns += from->sum_ns;
+    if (from->min_ns < into->min_ns) into->min_ns = from->min_ns;
+    if (from->max_ns > into->max_ns) into->max_ns = from->max_ns;
+    for (i = 0; i < BUN_LATENCY_BUCKETS; i++) into->buckets[i] += from->buckets[i];
+}
+
+Bun_U64 Bun_Latency_Histogram_Percentile(const Bun_Latency_Histogram *histogram, double percentile)
+{
+    double exact = (double)histogram->count * percentile / 100.0;
+    Bun_U64 rank = (Bun_U64)exact, seen = 0;
+    Bun_U32 i;
+
+    if (histogram->count == 0) return 0;
+    if ((double)rank < exact) rank++;
+    if (rank == 0) rank = 1;
+    if (rank > histogram->count) rank = histogram->count;
+
+    for (i = 0; i < BUN_LATENCY_BUCKETS; i++)
+    {
+        seen += histogram->buckets[i];
+        if (seen >= rank) break;
+    }
+    /*the last bucket is open ended*/
+    if (i >= BUN_LATENCY_BUCKETS - 1) return histogram->max_ns;
+    return (Bun_Latency__Bucket_Max(i) < histogram->max_ns) ? Bun_Latency__Bucket_Max(i) : histogram->max_ns;
+}
+
+/* -- clock -- */
+
+static Bun_U64 Bun_Timed__Now_Ns(void)
+{
+#ifdef BUN_TIMED__CLOCK_GETTIME
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (Bun_U64)now.tv_sec*1000000000ull + (Bun_U64)now.tv_nsec;
+#else
+    return (Bun_U64)clock() * (1000000000ull / CLOCKS_PER_SEC);
+#endif
+}
+
+static Bun_U64 Bun_Timed__Ticks(void)
+{
+#if defined(BUN_TIMED__RDTSC)
+    Bun_U32 low, high;
+    __asm__ __volatile__("rdtsc" : "=a"(low), "=d"(high));
+    return ((Bun_U64)high << 32) | low;
+#elif defined(BUN_TIMED__CNTVCT)
+    Bun_U64 ticks;
+    __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0" : "=r"(ticks) : : "memory");
+    return ticks;
+#else
+    return Bun_Timed__Now_Ns();
+#endif
+}
+
+/*
+Count ticks over a few ms of the monotonic clock, done once, threads racing
+on the first call just both calibrate.
+*/
+static Bun_U64 Bun_Timed__Mult(void)
+{
+    Bun_U64 mult = BUN_ATOMIC_LOAD_RELAXED(&bun_timed__mult);
+#if defined(BUN_TIMED__RDTSC) || defined(BUN_TIMED__CNTVCT)
+    Bun_U64 start_ns, start_ticks, ns, ticks;
+
+    if (BUN_LIKELY(mult != 0)) return mult;
+    start_ns = Bun_Timed__Now_Ns();
+    start_ticks = Bun_Timed__Ticks();
+    do ns = Bun_Timed__Now_Ns() - start_ns;
+    while (ns < BUN_TIMED__CALIBRATE_NS);
+    ticks = Bun_Timed__Ticks() - start_ticks;
+    mult = (ticks == 0) ? ((Bun_U64)1 << BUN_TIMED__MULT_SHIFT) : (ns << BUN_TIMED__MULT_SHIFT) / ticks;
+    if (mult == 0) mult = 1;
+#else
+    if (BUN_LIKELY(mult != 0)) return mult;
+    mult = (Bun_U64)1 << BUN_TIMED__MULT_SHIFT;
+#endif
+    BUN_ATOMIC_STORE_RELAXED(&bun_timed__mult, mult);
+    return mult;
+}
+
+static Bun_U64 Bun_Timed__Ticks_To_Ns(Bun_U64 ticks)
+{
+    Bun_U64 mult = Bun_Timed__Mult();
+    Bun_U64 low = ticks & (((Bun_U64)1 << BUN_TIMED__MULT_SHIFT) - 1);
+    return (ticks >> BUN_TIMED__MULT_SHIFT) * mult + ((low * mult) >> BUN_TIMED__MULT_SHIFT);
+}
+
+/* -- allocator -- */
+
+static void Bun_Timed__Record(Bun_Timed_Allocator *timed, Bun_U32 mode_index, Bun_U64 start)
+{
+    Bun_U64 ticks = Bun_Timed__Ticks() - start;
+    /*the counter can step back when a thread migrates between unsynced cores*/
+    if ((Bun_S64)ticks < 0) ticks = 0;
+    Bun_Latency_Histogram_Record(&timed->histograms[mode_index], Bun_Timed__Ticks_To_Ns(ticks));
+}
+
+static void *Bun_Timed__Alloc(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_USize size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Timed_Allocator *timed = *(Bun_Timed_Allocator **)allocator_data;
+    Bun_U64 start = Bun_Timed__Ticks();
+    void *ptr = (Bun_Allocator_Alloc_Inline)(size, zeroed, alignment, timed->allocator);
+
+    Bun_Timed__Record(timed, (zeroed) ? 0 : 1, start);
+    return Bun_Allocator__Result(timed->allocator, allocator_error, ptr);
+}
+
+static bool Bun_Timed__Free(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr)
+{
+    Bun_Timed_Allocator *timed = *(Bun_Timed_Allocator **)allocator_data;
+    Bun_U64 start = Bun_Timed__Ticks();
+    bool freed = (Bun_Allocator_Free_Inline)(ptr, timed->allocator);
+
+    Bun_Timed__Record(timed, 2, start);
+    if (!freed && allocator_error != NULL) *allocator_error = timed->allocator->error;
+    return freed;
+}
+
+static void *Bun_Timed__Resize(void *allocator_data, Bun_Allocator_Error *allocator_error, void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment)
+{
+    Bun_Timed_Allocator *timed = *(Bun_Timed_Allocator **)allocator_data;
+    Bun_U64 start = Bun_Timed__Ticks();
+    void *new_ptr = (Bun_Allocator_Resize_Inline)(ptr, size, old_size, zeroed, alignment, timed->allocator);
+
+    Bun_Timed__Record(timed, (zeroed) ? 4 : 5, start);
+    return Bun_Allocator__Result(timed->allocator, allocator_error, new_ptr);
+}
+
+void *Bun_Timed_Allocator_Proc64(void *allocator_data, Bun_Allocator_Error *allocator_error, Bun_Allocator_Mode mode, Bun_USize size, Bun_U32 alignment, void *old_memory, Bun_USize old_size);
+static const Bun_Allocator_Ops bun_timed_allocator_ops = {
+    .proc64 = &Bun_Timed_Allocator_Proc64,
+    .alloc  = &Bun_Timed__Alloc,
+    .free   = &Bun_Timed__Free,
+    .resize = &Bun_Timed__Resize,
+};
+
+void *Bun_Timed_Allocator_Proc64(void *allocator_data,
+                          Bun_Allocator_Error *allocator_error,
+                          Bun_Allocator_Mode mode,
+                          Bun_USize size,
+                          Bun_U32 alignment,
+                          void *old_memory,
+                          Bun_USize old_size
+                          )
+{
+    Bun_Timed_Allocator *timed = *(Bun_Timed_Allocator **)allocator_data;
+    Bun_U64 start;
+    bool result;
+
+    switch (mode)
+    {
+        case BUN_ALLOCATOR_MODE_ALLOC:
+        case BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED:
+            return Bun_Timed__Alloc(allocator_data, allocator_error, size, mode == BUN_ALLOCATOR_MODE_ALLOC, alignment);
+        case BUN_ALLOCATOR_MODE_FREE:
+            return (Bun_Timed__Free(allocator_data, allocator_error, old_memory)) ? old_memory : NULL;
+        case BUN_ALLOCATOR_MODE_FREE_ALL:
+            start = Bun_Timed__Ticks();
+            result = (Bun_Allocator_Free_all)(timed->allocator);
+            Bun_Timed__Record(timed, 3, start);
+            return Bun_Allocator__Result(timed->allocator, allocator_error, (result) ? timed : NULL);
+        case BUN_ALLOCATOR_MODE_RESIZE:
+        case BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED:
+            return Bun_Timed__Resize(allocator_data, allocator_error, old_memory, size, old_size, mode == BUN_ALLOCATOR_MODE_RESIZE, alignment);
+        case BUN_ALLOCATOR_MODE_OWNS:
+            start = Bun_Timed__Ticks();
+            result = Bun_Allocator_Owns(old_memory, timed->allocator);
+            Bun_Timed__Record(timed, 6, start);
+            return (result) ? old_memory : NULL;
+        default:
+            if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED;
+            return NULL;
+    }
+}
+
+void *Bun_Timed_Allocator_Proc(void *allocator_data,
+                          Bun_Allocator_Error *allocator_error,
+                          Bun_Allocator_Mode mode,
+                          Bun_U32 size,
+                          Bun_U32 alignment,
+                          void *old_memory,
+                          Bun_U32 old_size
+                          )
+{
+    return Bun_Timed_Allocator_Proc64(allocator_data, allocator_error, mode, size, alignment, old_memory, old_size);
+}
+
+void Bun_Timed_Allocator_Init(Bun_Timed_Allocator *timed, Bun_Allocator *allocator, const char *name)
+{
+    Bun_U32 i;
+
+    timed->allocator = allocator;
+    timed->name = name;
+    for (i = 0; i < BUN_TIMED_ALLOCATOR_MODES; i++) Bun_Latency_Histogram_Reset(&timed->histograms[i]);
+    Bun_Timed__Mult();
+}
+
+/*
+Copy a histogram that may be recorded into, emptying it when reset.
+*/
+static void Bun_Timed__Copy(Bun_Latency_Histogram *live, Bun_Latency_Histogram *histogram, bool reset)
+{
+    Bun_U32 i;
+
+    if (reset)
+    {
+        BUN_ATOMIC_EXCHANGE(&live->count, 0, histogram->count);
+        BUN_ATOMIC_EXCHANGE(&live->sum_ns, 0, histogram->sum_ns);
+        BUN_ATOMIC_EXCHANGE(&live->min_ns, BUN_LATENCY__EMPTY_MIN, histogram->min_ns);
+        BUN_ATOMIC_EXCHANGE(&live->max_ns, 0, histogram->max_ns);
+        for (i = 0; i < BUN_LATENCY_BUCKETS; i++) BUN_ATOMIC_EXCHANGE(&live->buckets[i], 0, histogram->buckets[i]);
+    }
+    else
+    {
+        histogram->count  = BUN_ATOMIC_LOAD_RELAXED(&live->count);
+        histogram->sum_ns = BUN_ATOMIC_LOAD_RELAXED(&live->sum_ns);
+        histogram->min_ns = BUN_ATOMIC_LOAD_RELAXED(&live->min_ns);
+        histogram->max_ns = BUN_ATOMIC_LOAD_RELAXED(&live->max_ns);
+        for (i = 0; i < BUN_LATENCY_BUCKETS; i++) histogram->buckets[i] = BUN_ATOMIC_LOAD_RELAXED(&live->buckets[i]);
+    }
+}
+
+void Bun_Timed_Allocator_Snapshot(Bun_Timed_Allocator *timed, Bun_Latency_Histogram *histograms, bool reset)
+{
+    Bun_U32 i;
+    for (i = 0; i < BUN_TIMED_ALLOCATOR_MODES; i++) Bun_Timed__Copy(&timed->histograms[i], &histograms[i], reset);
+}
+
+void Bun_Timed_Allocator_Reset(Bun_Timed_Allocator *timed)
+{
+    Bun_Latency_Histogram *live;
+    Bun_U32 i, j;
+
+    for (i = 0; i < BUN_TIMED_ALLOCATOR_MODES; i++)
+    {
+        live = &timed->histograms[i];
+        BUN_ATOMIC_STORE_RELAXED(&live->count, 0);
+        BUN_ATOMIC_STORE_RELAXED(&live->sum_ns, 0);
+        BUN_ATOMIC_STORE_RELAXED(&live->min_ns, BUN_LATENCY__EMPTY_MIN);
+        BUN_ATOMIC_STORE_RELAXED(&live->max_ns, 0);
+        for (j = 0; j < BUN_LATENCY_BUCKETS; j++) BUN_ATOMIC_STORE_RELAXED(&live->buckets[j], 0);
+    }
+}
+
+Bun_U32 Bun_Timed_Allocator_Report(Bun_Timed_Allocator *timed, char *buffer, Bun_U32 buffer_size)
+{
+    Bun_String_Buffer text = Bun_String_Buffer_From(buffer, buffer_size);
+    Bun_Latency_Histogram histogram;
+    Bun_U32 i;
+
+    for (i = 0; i < BUN_TIMED_ALLOCATOR_MODES; i++)
+    {
+        Bun_Timed__Copy(&timed->histograms[i], &histogram, false);
+        if (histogram.count == 0) continue;
+
+        Bun_String_Buffer_Append(&text, (timed->name != NULL) ? timed->name : "allocator");
+        Bun_String_Buffer_Append(&text, " ");
+        Bun_String_Buffer_Append(&text, bun_timed__mode_names[i]);
+        Bun_String_Buffer_Append(&text, " count=");
+        Bun_String_Buffer_Append_U64(&text, histogram.count);
+        Bun_String_Buffer_Append(&text, " mean_ns=");
+        Bun_String_Buffer_Append_U64(&text, histogram.sum_ns / histogram.count);
+        Bun_String_Buffer_Append(&text, " min_ns=");
+        Bun_String_Buffer_Append_U64(&text, histogram.min_ns);
+        Bun_String_Buffer_Append(&text, " p50_ns=");
+        Bun_String_Buffer_Append_U64(&text, Bun_Latency_Histogram_Percentile(&histogram, 50));
+        Bun_String_Buffer_Append(&text, " p90_ns=");
+        Bun_String_Buffer_Append_U64(&text, Bun_Latency_Histogram_Percentile(&histogram, 90));
+        Bun_String_Buffer_Append(&text, " p99_ns=");
+        Bun_String_Buffer_Append_U64(&text, Bun_Latency_Histogram_Percentile(&histogram, 99));
+        Bun_String_Buffer_Append(&text, " p999_ns=");
+        Bun_String_Buffer_Append_U64(&text, Bun_Latency_Histogram_Percentile(&histogram, 99.9));
+        Bun_String_Buffer_Append(&text, " max_ns=");
+        Bun_String_Buffer_Append_U64(&text, histogram.max_ns);
+        Bun_String_Buffer_Append(&text, "\n");
+    }
+    return (text.overflow) ? 0 : text.len;
+}
+
+Bun_Allocator Bun_Timed_Allocator_Interface(Bun_Timed_Allocator *timed)
+{
+    return (Bun_Allocator){
+        .proc = &Bun_Timed_Allocator_Proc,
+        .proc64 = &Bun_Timed_Allocator_Proc64,
+        .ops = &bun_timed_allocator_ops,
+        .implemented_modes = timed->allocator->implemented_modes,
+        .data = timed,
+        .error = 0,
+    };
+}
@@ -0,0 +1,131 @@
+/*
+Timed allocator, records the latency of every call into another allocator.
+
+Each operation is timed with the cpu cycle counter (rdtsc on x86,
+cntvct_el0 on arm64, the monotonic clock elsewhere), converted to ns with a
+multiplier calibrated once against the monotonic clock, and recorded into a
+log linear histogram of its mode. Tails like a dynamic arena creating a
+pool, growing its pools array or glibc hitting mmap show up as p99/p999
+instead of disappearing into totals:
+    Bun_Timed_Allocator timed;
+    Bun_Allocator allocator;
+    Bun_Dynamic_Arena arena;
+    Bun_Timed_Allocator_Init(&timed, &bun_allocator_libc, "pools");
+    allocator = Bun_Timed_Allocator_Interface(&timed);
+    Bun_Dynamic_Arena_Init(&arena, &allocator, 4096, false, 8);
+    ...
+    Bun_Timed_Allocator_Report(&timed, buffer, sizeof(buffer));
+
+Recording is lock free, so a timed allocator may be shared by threads when
+the wrapped allocator is thread safe, or be kept per thread and the
+snapshots merged with Bun_Latency_Histogram_Merge.
+*/
+
+/*values below 2^SUB_BITS ns get a bucket each, every power of two above is split in 2^SUB_BITS buckets*/
+#define BUN_LATENCY_SUB_BITS 4
+/*latencies of 2^MAX_EXPONENT ns (about 18 minutes) and above land in the last bucket*/
+#define BUN_LATENCY_MAX_EXPONENT 40
+#define BUN_LATENCY_BUCKETS ((BUN_LATENCY_MAX_EXPONENT - BUN_LATENCY_SUB_BITS + 1) << BUN_LATENCY_SUB_BITS)
+
+/*one histogram per allocator mode, histograms[i] holds mode (1<<i)*/
+#define BUN_TIMED_ALLOCATOR_MODES 7
+
+typedef struct
+{
+    Bun_U64 count;
+    Bun_U64 sum_ns;
+    Bun_U64 min_ns;   /*(Bun_U64)-1 while empty*/
+    Bun_U64 max_ns;
+    Bun_U64 buckets[BUN_LATENCY_BUCKETS];
+} Bun_Latency_Histogram;
+
+typedef struct
+{
+    Bun_Allocator *allocator;
+    const char *name;         /*used by Bun_Timed_Allocator_Report*/
+    Bun_Latency_Histogram histograms[BUN_TIMED_ALLOCATOR_MODES];
+} Bun_Timed_Allocator;
+
+/*
+Empty a histogram, not atomic.
+*/
+void Bun_Latency_Histogram_Reset(Bun_Latency_Histogram *histogram);
+/*
+Record one latency, safe to call from several threads at once.
+*/
+void Bun_Latency_Histogram_Record(Bun_Latency_Histogram *histogram, Bun_U64 ns);
+/*
+Add the values of from to into, for combining snapshots of per thread
+histograms. into must not be recorded into at the same time.
+*/
+void Bun_Latency_Histogram_Merge(Bun_Latency_Histogram *into, const Bun_Latency_Histogram *from);
+/*
+ARGS:
+    percentile - 0 to 100, 99.9 for p999.
+
+RETURN:
+    upper bound in ns of the bucket holding the percentile, within 1/16 of
+    the real value and never above max_ns. 0 if the histogram is empty.
+*/
+Bun_U64 Bun_Latency_Histogram_Percentile(const Bun_Latency_Histogram *histogram, double percentile);
+
+/*
+Initialise a timed allocator, the first one calibrates the cycle counter
+which takes a few ms.
+
+ARGS:
+    timed     - uninitialised timed allocator.
+    allocator - the allocator to time, must outlive the timed allocator.
+    name      - name in reports, may be NULL.
+*/
+void Bun_Timed_Allocator_Init(Bun_Timed_Allocator *timed, Bun_Allocator *allocator, const char *name);
+/*
+Copy the histograms of every mode, while other threads may be recording.
+Each value is read atomically but not the histogram as a whole, so count
+can be off from the bucket total by the calls in flight.
+
+ARGS:
+    histograms - BUN_TIMED_ALLOCATOR_MODES histograms, indexed like timed->histograms.
+    reset      - empty the histograms as they are read, so the next
+                 snapshot only has what happened since this one.
+*/
+void Bun_Timed_Allocator_Snapshot(Bun_Timed_Allocator *timed, Bun_Latency_Histogram *histograms, bool reset);
+/*
+Empty every histogram, while other threads may be recording.
+*/
+void Bun_Timed_Allocator_Reset(Bun_Timed_Allocator *timed);
+/*
+Write a line per mode that was called:
+    <name> <mode> count= mean_ns= min_ns= p50_ns= p90_ns= p99_ns= p999_ns= max_ns=
+
+RETURN:
+    length written, 0 if the buffer is too small.
+*/
+Bun_U32 Bun_Timed_Allocator_Report(Bun_Timed_Allocator *timed, char *buffer, Bun_U32 buffer_size);
+/*
+Get the generic allocator interface of a timed allocator.
+implements the modes of the wrapped allocator, errors of the wrapped
+allocator are copied.
+
+ARGS:
+    timed - an initialised timed allocator, must outlive the returned allocator.
+*/
+Bun_Allocator Bun_Timed_Allocator_Interface(Bun_Timed_Allocator *timed);
+
+#ifdef BUN_STRIP_PREFIX
+#    define LATENCY_SUB_BITS BUN_LATENCY_SUB_BITS
+#    define LATENCY_MAX_EXPONENT BUN_LATENCY_MAX_EXPONENT
+#    define LATENCY_BUCKETS BUN_LATENCY_BUCKETS
+#    define TIMED_ALLOCATOR_MODES BUN_TIMED_ALLOCATOR_MODES
+#    define Latency_Histogram Bun_Latency_Histogram
+#    define Latency_Histogram_Reset Bun_Latency_Histogram_Reset
+#    define Latency_Histogram_Record Bun_Latency_Histogram_Record
+#    define Latency_Histogram_Merge Bun_Latency_Histogram_Merge
+#    define Latency_Histogram_Percentile Bun_Latency_Histogram_Percentile
+#    define Timed_Allocator Bun_Timed_Allocator
+#    define Timed_Allocator_Init Bun_Timed_Allocator_Init
+#    define Timed_Allocator_Snapshot Bun_Timed_Allocator_Snapshot
+#    define Timed_Allocator_Reset Bun_Timed_Allocator_Reset
+#    define Timed_Allocator_Report Bun_Timed_Allocator_Report
+#    define Timed_Allocator_Interface Bun_Timed_Allocator_Interface
+#endif /*ifdef BUN_STRIP_PREFIX*/
@@ -1,74 +1,149 @@
 #include <string.h>
 
-void Bun_Arena_Init_From_Allocator(Bun_Arena *arena, Bun_Allocator *allocator, Bun_U32 buffer_size, bool zeroed, Bun_U32 alignment)
+void Bun_Arena_Init_From_Allocator(Bun_Arena *arena, Bun_Allocator *allocator, Bun_USize buffer_size, bool zeroed, Bun_U32 alignment)
 {
-    arena->buffer = Bun_Allocator_Alloc(buffer_size, zeroed, alignment, allocator);
+    arena->buffer = (Bun_Allocator_Alloc_64)(buffer_size, zeroed, alignment, allocator);
     arena->buffer_size = buffer_size;
     arena->offset = 0;
+    arena->flags = 0;
+    arena->padding = 0;
+    arena->abandoned = 0;
 }
-void Bun_Arena_Deinit_From_Allocator(Bun_Arena *arena, Bun_Allocator *allocator)
+void (Bun_Arena_Deinit_From_Allocator)(Bun_Arena *arena, Bun_Allocator *allocator)
 {
-    Bun_Allocator_Free(arena->buffer, allocator);
+    (Bun_Allocator_Free)(arena->buffer, allocator);
     memset( arena, 0, sizeof(arena) );
 }
-void *Bun_Arena_Alloc(Bun_U32 size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena)
+
+/*
+Bump allocate from a single arena/pool, writing the size header when enabled.
+RETURN:
+    Pointer to allocated memory or NULL when it does not fit
+*/
+static void *Bun_Arena__Push(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena)
 {
-    uintptr_t current_pointer, offset;
+    uintptr_t current_pointer, offset, header_size;
     void *ptr;
 
-    current_pointer = (uintptr_t)arena->buffer + (uintptr_t)arena->offset;
-    current_pointer = (uintptr_t)Bun_Align_Formula(current_pointer, alignment);
+    if (arena->buffer == NULL) return NULL;
+
+    header_size = (arena->flags & BUN_ARENA_FLAG_SIZE_HEADER) ? sizeof(Bun_Arena_Size_Header) : 0;
+    if (header_size && size > (Bun_Arena_Size_Header)-1) return NULL;
+
+    current_pointer = (uintptr_t)arena->buffer + arena->offset + header_size;
+    current_pointer = Bun_Align_Formula(current_pointer, alignment);
+    if (current_pointer == 0) return NULL; /*alignment overflowed*/
     offset = current_pointer - (uintptr_t)arena->buffer;
 
-    if ( offset + size > arena->buffer_size ) return NULL;
+    if ( offset > arena->buffer_size || size > arena->buffer_size - offset ) return NULL;
 
     ptr = &arena->buffer[offset];
+    arena->padding += offset - arena->offset;
     arena->offset = offset + size;
 
-    if (zeroed) memset(ptr, 0, size);
+    if (header_size)
+    {
+        Bun_Arena_Size_Header header = (Bun_Arena_Size_Header)size;
+        memcpy((Bun_Byte *)ptr - header_size, &header, header_size); /*may be unaligned*/
+    }
+    if (zeroed) Bun_Memory_Zero(ptr, size);
 
     return ptr;
 }
+static void Bun_Arena__Set_Size(void *ptr, Bun_USize size)
+{
+    Bun_Arena_Size_Header header = (Bun_Arena_Size_Header)size;
+    memcpy((Bun_Byte *)ptr - sizeof(header), &header, sizeof(header));
+}
 
-void *Bun_Arena_Resize(void *old_memory, Bun_U32 size, Bun_U32 old_size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena)
+void *(Bun_Arena_Alloc)(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena)
 {
-    uintptr_t offset, old_memory_offset;
+    return Bun_Arena__Push(size, zeroed, alignment, arena);
+}
+
+Bun_U32 Bun_Arena_Allocation_Size(void *ptr)
+{
+    Bun_Arena_Size_Header header;
+    if (ptr == NULL) return 0;
+    memcpy(&header, (Bun_Byte *)ptr - sizeof(header), sizeof(header));
+    return header;
+}
+
+void *(Bun_Arena_Resize)(void *old_memory, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena)
+{
+    uintptr_t old_memory_offset;
+    void *new_memory;
 
     if (old_memory == NULL
-    || old_size == 0
     || (uintptr_t)old_memory < (uintptr_t)arena->buffer
-    || (uintptr_t)old_memory + size >= (uintptr_t)arena->buffer + arena->buffer_size
+    || (uintptr_t)old_memory >= (uintptr_t)arena->buffer + arena->offset
     ) return NULL;
 
-    if (size < old_size)
+    if (arena->flags & BUN_ARENA_FLAG_SIZE_HEADER)
     {
-        arena->offset -= old_size - size;
-        return old_memory;
+        if (size > (Bun_Arena_Size_Header)-1) return NULL;
+        old_size = Bun_Arena_Allocation_Size(old_memory);
     }
+    if (old_size == 0) return NULL;
 
     old_memory_offset = (uintptr_t)old_memory - (uintptr_t)arena->buffer;
-    offset = old_memory_offset + (uintptr_t)old_size;
-    if (offset == (uintptr_t)arena->offset)
+    if (old_memory_offset + old_size == arena->offset) /*last allocation, resize in place*/
     {
-        offset = old_memory_offset + size;
-        if (offset > arena->buffer_size) return NULL;
-        arena->offset = offset;
+        if (size > arena->buffer_size - old_memory_offset) return NULL;
+        arena->offset = old_memory_offset + size;
+        if (zeroed && size > old_size) Bun_Memory_Zero((Bun_Byte *)old_memory + old_size, size - old_size);
+        if (arena->flags & BUN_ARENA_FLAG_SIZE_HEADER) Bun_Arena__Set_Size(old_memory, size);
         return old_memory;
     }
-    else
+    if (size <= old_size) /*shrink in the middle (do nothing)*/
     {
-        void *new_memory = Bun_Arena_Alloc(size, zeroed, alignment, arena);
-        if (new_memory == NULL) return NULL;
-        return memmove(new_memory, old_memory, size);
+        if (arena->flags & BUN_ARENA_FLAG_SIZE_HEADER) Bun_Arena__Set_Size(old_memory, size);
+        arena->abandoned += old_size - size;
+        return old_memory;
     }
+
+    new_memory = (Bun_Arena_Alloc)(size, zeroed, alignment, arena);
+    if (new_memory == NULL) return NULL;
+    arena->abandoned += old_size;
+    return memcpy(new_memory, old_memory, old_size);
 }
 
-void Bun_Arena_Free_All(Bun_Arena *arena)
+void (Bun_Arena_Free_All)(Bun_Arena *arena)
 {
     arena->offset = 0;
+    arena->padding = 0;
+    arena->abandoned = 0;
 }
 
-bool Bun_Dynamic_Arena_Init( Bun_Dynamic_Arena *arena, Bun_Allocator *backing_allocator, Bun_U32 pool_size, bool pool_zeroed, Bun_U32 pool_alignment )
+/*
+Pool buffers and the pools array go through the process wide pool cache.
+*/
+static void *Bun_Dynamic_Arena__Block_Alloc(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator)
+{
+    void *block = Bun_Pool_Cache_Pop(size, alignment, allocator);
+    if (block == NULL) return (Bun_Allocator_Alloc_64)(size, zeroed, alignment, allocator);
+    if (zeroed) Bun_Memory_Zero(block, size);
+    return block;
+}
+static void Bun_Dynamic_Arena__Block_Free(void *block, Bun_USize size, Bun_U32 alignment, Bun_Allocator *allocator)
+{
+    if (!Bun_Pool_Cache_Push(block, size, alignment, allocator)) (Bun_Allocator_Free)(block, allocator);
+}
+static void Bun_Dynamic_Arena__Pool_Init(Bun_Arena *pool, Bun_Dynamic_Arena *arena)
+{
+    pool->buffer = Bun_Dynamic_Arena__Block_Alloc(arena->pool_size, arena->pool_zeroed, arena->pool_alignment, arena->allocator);
+    pool->buffer_size = arena->pool_size;
+    pool->offset = 0;
+    pool->flags = arena->flags;
+    pool->padding = 0;
+    pool->abandoned = 0;
+}
+void Bun_Dynamic_Arena__Pool_Free(Bun_Arena *pool, Bun_Dynamic_Arena *arena)
+{
+    Bun_Dynamic_Arena__Block_Free(pool->buffer, pool->buffer_size, arena->pool_alignment, arena->allocator);
+}
+
+bool Bun_Dynamic_Arena_Init( Bun_Dynamic_Arena *arena, Bun_Allocator *backing_allocator, Bun_USize pool_size, bool pool_zeroed, Bun_U32 pool_alignment )
 {
     static const Bun_Allocator_Mode required_modes = BUN_ALLOCATOR_MODE_ALLOC
                                                | BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED
@@ -83,44 +158,288 @@ bool Bun_Dynamic_Arena_Init( Bun_Dynamic_Arena *arena, Bun_Allocator *backing_al
     arena->pool_zeroed    = pool_zeroed;
     arena->pool_alignment = pool_alignment;
     arena->pool_offset    = 0;
+    arena->flags          = 0;
+
+    arena->large             = NULL;
+    arena->large_cache       = NULL;
+    arena->large_cache_limit = 0;
+    arena->profile           = NULL;
 
     arena->pool_len = 8;
-    arena->pools = Bun_Allocator_Alloc(sizeof(Bun_Arena)*arena->pool_len, true, BUN_ALLOCATOR_DEFAULT_ALIGN, backing_allocator);
+    arena->pools = Bun_Dynamic_Arena__Block_Alloc(sizeof(Bun_Arena)*arena->pool_len, true, BUN_ALLOCATOR_DEFAULT_ALIGN, backing_allocator);
     if (arena->pools == NULL) return false;
 
     /* this is actually not a good idea, just let the first allocation handle it.
     arena->pools[0].buffer = Allocator_Alloc(pool_size, pool_zeroed, pool_alignment, backing_allocator);
     arena->pools[0].offset = 0;
     */
+    return true;
+}
+/*
+Allocate in a block of its own, reusing a cached block when one is big enough.
+*/
+static void *Bun_Dynamic_Arena__Alloc_Large(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena)
+{
+    Bun_Dynamic_Arena_Large **link, *large = NULL;
+    uintptr_t header_size, needed, ptr;
+
+    header_size = (arena->flags & BUN_ARENA_FLAG_SIZE_HEADER) ? sizeof(Bun_Arena_Size_Header) : 0;
+    if (header_size && size > (Bun_Arena_Size_Header)-1) return NULL;
+    needed = sizeof(Bun_Dynamic_Arena_Large) + header_size + (uintptr_t)alignment;
+    if (size > BUN_USIZE_MAX - needed) return NULL;
+    needed += size;
+
+    for (link = &arena->large_cache; *link != NULL; link = &(*link)->next)
+    {
+        if ((*link)->block_size < needed) continue;
+        large = *link;
+        *link = large->next;
+        break;
+    }
+    if (large == NULL)
+    {
+        large = (Bun_Allocator_Alloc_64)(needed, false, BUN_ALLOCATOR_DEFAULT_ALIGN, arena->allocator);
+        if (large == NULL) return NULL;
+        large->block_size = needed;
+    }
+    large->size = size;
+    large->next = arena->large;
+    arena->large = large;
+
+    ptr = Bun_Align_Formula((uintptr_t)(large + 1) + header_size, alignment);
+    if (header_size) Bun_Arena__Set_Size((void *)ptr, size);
+    if (zeroed) Bun_Memory_Zero((void *)ptr, size);
+    return (void *)ptr;
+}
+/*
+RETURN:
+    the link pointing to the large block holding *ptr*, or NULL
+*/
+Bun_Dynamic_Arena_Large **Bun_Dynamic_Arena__Find_Large(void *ptr, Bun_Dynamic_Arena *arena)
+{
+    Bun_Dynamic_Arena_Large **link;
+    for (link = &arena->large; *link != NULL; link = &(*link)->next)
+    {
+        if ((uintptr_t)ptr >= (uintptr_t)(*link + 1)
+        &&  (uintptr_t)ptr <  (uintptr_t)*link + (*link)->block_size
+        ) return link;
+    }
+    return NULL;
+}
+/*
+Move live large blocks to the cache while it is under large_cache_limit, free the rest.
+*/
+static void Bun_Dynamic_Arena__Release_Large(Bun_Dynamic_Arena *arena)
+{
+    Bun_Dynamic_Arena_Large *large, *next;
+    uintptr_t cached = 0;
+
+    for (large = arena->large_cache; large != NULL; large = large->next)
+        cached += large->block_size;
+
+    for (large = arena->large; large != NULL; large = next)
+    {
+        next = large->next;
+        if (cached + large->block_size <= arena->large_cache_limit)
+        {
+            cached += large->block_size;
+            large->next = arena->large_cache;
+            arena->large_cache = large;
+        }
+        else (Bun_Allocator_Free)(large, arena->allocator);
+    }
+    arena->large = NULL;
+}
+
+#define BUN_DYNAMIC_ARENA__PROFILE_MAGIC "bun_dynamic_arena_profile 1"
+
+Bun_USize Bun_Dynamic_Arena_Profile_Size(Bun_Dynamic_Arena_Profile *profile)
+{
+    Bun_USize sorted[BUN_DYNAMIC_ARENA_PROFILE_HISTORY];
+    Bun_U32 i, j, percentile, index;
+
+    if (profile == NULL || profile->count == 0) return 0;
+
+    /*insertion sort, there are only a handful of samples*/
+    for (i = 0; i < profile->count; i++)
+    {
+        Bun_USize value = profile->peak_bytes[i];
+        for (j = i; j > 0 && sorted[j-1] > value; j--) sorted[j] = sorted[j-1];
+        sorted[j] = value;
+    }
+    percentile = (profile->percentile && profile->percentile <= 100) ? profile->percentile : 95;
+    index = (percentile * profile->count + 99) / 100;
+    return sorted[(index) ? index-1 : 0];
+}
+
+/*
+Record the usage of the lifetime that is ending in the arenas profile.
+*/
+static void Bun_Dynamic_Arena__Profile_Record(Bun_Dynamic_Arena *arena)
+{
+    Bun_Dynamic_Arena_Profile *profile = arena->profile;
+    Bun_Dynamic_Arena_Large *large;
+    uintptr_t bytes = 0;
+    Bun_U32 pools = 0, i;
+
+    if (profile == NULL) return;
+
+    for (i = 0; i < arena->pool_len; i++)
+    {
+        if (arena->pools[i].buffer == NULL || arena->pools[i].offset == 0) continue;
+        bytes += arena->pools[i].offset;
+        pools += 1;
+    }
+    for (large = arena->large; large != NULL; large = large->next)
+    {
+        bytes += large->size;
+        pools += 1;
+    }
+    if (pools == 0) return; /*unused, nothing to learn*/
+
+    profile->peak_bytes[profile->next] = bytes;
+    profile->pool_counts[profile->next] = pools;
+    profile->next = (profile->next + 1) % BUN_DYNAMIC_ARENA_PROFILE_HISTORY;
+    if (profile->count < BUN_DYNAMIC_ARENA_PROFILE_HISTORY) profile->count += 1;
+}
+/*
+Replace the pools by a single pool sized from the profile, when the profile
+asks for more then a regular pool and the first pool is not that big already.
+*/
+static void Bun_Dynamic_Arena__Profile_Provision(Bun_Dynamic_Arena *arena)
+{
+    Bun_USize size;
+    Bun_U32 i;
+
+    if (arena->profile == NULL) return;
+
+    size = Bun_Dynamic_Arena_Profile_Size(arena->profile);
+    if (size <= arena->pool_size) return;
+    size = Bun_Align_Formula(size, 4096);
+    if (size == 0) return;
+    if (arena->pools[0].buffer != NULL && arena->pools[0].buffer_size >= size) return;
+
+    for (i = 0; i < arena->pool_len; i++)
+    {
+        if (arena->pools[i].buffer != NULL) Bun_Dynamic_Arena__Pool_Free(&arena->pools[i], arena);
+        memset(&arena->pools[i], 0, sizeof(Bun_Arena));
+    }
+    arena->pool_offset = 0;
+
+    /*on failure the pools are created lazily as usual*/
+    arena->pools[0].buffer = Bun_Dynamic_Arena__Block_Alloc(size, arena->pool_zeroed, arena->pool_alignment, arena->allocator);
+    if (arena->pools[0].buffer == NULL) return;
+    arena->pools[0].buffer_size = size;
+    arena->pools[0].flags = arena->flags;
+}
+
+bool Bun_Dynamic_Arena_Init_Profiled( Bun_Dynamic_Arena *arena, Bun_Allocator *backing_allocator, Bun_USize pool_size, bool pool_zeroed, Bun_U32 pool_alignment, Bun_Dynamic_Arena_Profile *profile )
+{
+    if (!Bun_Dynamic_Arena_Init(arena, backing_allocator, pool_size, pool_zeroed, pool_alignment)) return false;
+    arena->profile = profile;
+    Bun_Dynamic_Arena__Profile_Provision(arena);
+    return true;
+}
+
+Bun_U32 Bun_Dynamic_Arena_Profile_Export(Bun_Dynamic_Arena_Profile *profile, char *buffer, Bun_U32 buffer_size)
+{
+    Bun_String_Buffer text = Bun_String_Buffer_From(buffer, buffer_size);
+    Bun_U32 i;
+
+    Bun_String_Buffer_Append(&text, BUN_DYNAMIC_ARENA__PROFILE_MAGIC);
+    Bun_String_Buffer_Append(&text, " ");
+    Bun_String_Buffer_Append_U64(&text, profile->percentile);
+    Bun_String_Buffer_Append(&text, " ");
+    Bun_String_Buffer_Append_U64(&text, profile->count);
+    Bun_String_Buffer_Append(&text, " ");
+    Bun_String_Buffer_Append_U64(&text, profile->next);
+    for (i = 0; i < profile->count; i++)
+    {
+        Bun_String_Buffer_Append(&text, " ");
+        Bun_String_Buffer_Append_U64(&text, profile->peak_bytes[i]);
+        Bun_String_Buffer_Append(&text, " ");
+        Bun_String_Buffer_Append_U64(&text, profile->pool_counts[i]);
+    }
+    Bun_String_Buffer_Append(&text, "\n");
+
+    return (text.overflow) ? 0 : text.len;
 }
-void Bun_Dynamic_Arena_Deinit( Bun_Dynamic_Arena *arena )
+
+bool Bun_Dynamic_Arena_Profile_Import(Bun_Dynamic_Arena_Profile *profile, const char *text, Bun_U32 len)
+{
+    Bun_Dynamic_Arena_Profile result = {0};
+    Bun_String string;
+    Bun_U64 percentile, count, next, peak, pools;
+    Bun_U32 magic_len = (Bun_U32)strlen(BUN_DYNAMIC_ARENA__PROFILE_MAGIC);
+    Bun_U32 i;
+
+    if (text == NULL) return false;
+    string = Bun_String_Alias(text, len);
+    if (string.len < magic_len || memcmp(string.ptr, BUN_DYNAMIC_ARENA__PROFILE_MAGIC, magic_len) != 0) return false;
+    string.ptr += magic_len;
+    string.len -= magic_len;
+
+    if (!Bun_String_Parse_U64(&string, &percentile) || percentile > 100
+    ||  !Bun_String_Parse_U64(&string, &count) || count > BUN_DYNAMIC_ARENA_PROFILE_HISTORY
+    ||  !Bun_String_Parse_U64(&string, &next) || next >= BUN_DYNAMIC_ARENA_PROFILE_HISTORY
+    ) return false;
+
+    result.percentile = (Bun_U32)percentile;
+    result.count = (Bun_U32)count;
+    result.next = (Bun_U32)next;
+    for (i = 0; i < result.count; i++)
+    {
+        if (!Bun_String_Parse_U64(&string, &peak) || peak > BUN_USIZE_MAX
+        ||  !Bun_String_Parse_U64(&string, &pools) || pools > (Bun_U32)-1
+        ) return false;
+        result.peak_bytes[i] = (Bun_USize)peak;
+        result.pool_counts[i] = (Bun_U32)pools;
+    }
+    *profile = result;
+    return true;
+}
+
+void (Bun_Dynamic_Arena_Deinit)( Bun_Dynamic_Arena *arena )
 {
     if (!arena || !arena->allocator || !arena->pools) return;
 
+    Bun_Dynamic_Arena__Profile_Record(arena);
+
+    arena->large_cache_limit = 0;
+    Bun_Dynamic_Arena__Release_Large(arena);
+    while (arena->large_cache != NULL)
+    {
+        Bun_Dynamic_Arena_Large *next = arena->large_cache->next;
+        (Bun_Allocator_Free)(arena->large_cache, arena->allocator);
+        arena->large_cache = next;
+    }
+
     int i;
     for ( i = 0; i < arena->pool_len; i++ )
     {
         if (arena->pools[i].buffer == NULL) break;
-        Bun_Allocator_Free(arena->pools[i].buffer, arena->allocator);
+        Bun_Dynamic_Arena__Pool_Free(&arena->pools[i], arena);
     }
-    Bun_Allocator_Free(arena->pools, arena->allocator);
+    Bun_Dynamic_Arena__Block_Free(arena->pools, sizeof(Bun_Arena)*arena->pool_len, BUN_ALLOCATOR_DEFAULT_ALIGN, arena->allocator);
 }
 
-void *Bun_Dynamic_Arena_Alloc_Push(Bun_U32 size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena)
+void *(Bun_Dynamic_Arena_Alloc_Push)(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena)
 {
-    uintptr_t current_pointer, offset;
     void *ptr;
     Bun_Arena *pool;
 
     /*Im blanking on if `type x = y[]` is a copy or not, I think it is, but have no internet to check*/
     pool = &arena->pools[arena->pool_offset];
 
-    current_pointer = (uintptr_t)pool->buffer + (uintptr_t)pool->offset;
-    offset = (uintptr_t)Bun_Align_Formula(current_pointer, alignment) - (uintptr_t)pool->buffer;
-
-    if ( offset + size > pool->buffer_size )
+    ptr = Bun_Arena__Push(size, zeroed, alignment, pool);
+    if (ptr == NULL)
     {
-        Bun_U32 pool_size = (arena->pool_size > size) ? arena->pool_size : size;
+        /*room for the header and for aligning past the pools own alignment*/
+        uintptr_t overhead = ((arena->flags & BUN_ARENA_FLAG_SIZE_HEADER) ? sizeof(Bun_Arena_Size_Header) : 0)
+                           + ((alignment > arena->pool_alignment) ? alignment : 0);
+
+        /*would never fit a pool, keep it out of them instead of wasting a pool slot and the current pools tail*/
+        if (size > arena->pool_size || overhead > arena->pool_size - size) return Bun_Dynamic_Arena__Alloc_Large(size, zeroed, alignment, arena);
 
         if (pool->buffer != NULL) arena->pool_offset += 1;
 
@@ -130,7 +449,7 @@ void *Bun_Dynamic_Arena_Alloc_Push(Bun_U32 size, bool zeroed, Bun_U32 alignment,
             Bun_Arena *new_ptr;
             
             arena->pool_len += 8;
-            new_ptr = Bun_Allocator_Resize( arena->pools,
+            new_ptr = (Bun_Allocator_Resize)( arena->pools,
                                         sizeof(Bun_Arena)*arena->pool_len, old_size,
                                         true, BUN_ALLOCATOR_DEFAULT_ALIGN, arena->allocator);
             if (!new_ptr)
@@ -139,124 +458,282 @@ void *Bun_Dynamic_Arena_Alloc_Push(Bun_U32 size, bool zeroed, Bun_U32 alignment,
 
         }
         pool = &arena->pools[arena->pool_offset];
-        offset = 0;
-        Bun_Arena_Init_From_Allocator( pool, arena->allocator, pool_size, arena->pool_zeroed, arena->pool_alignment );
+        /*pools after pool_offset are empty but may still hold a buffer (free_all, compaction)*/
+        if (pool->buffer == NULL) Bun_Dynamic_Arena__Pool_Init( pool, arena );
         if (pool->buffer == NULL) return NULL;
-    }
-
-    ptr = &pool->buffer[offset];
-    pool->offset = offset + size;
 
-    if (zeroed) memset(ptr, 0, size);
+        ptr = Bun_Arena__Push(size, zeroed, alignment, pool);
+    }
 
     return ptr;
 }
-void *Bun_Dynamic_Arena_Alloc_Insert(Bun_U32 size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena)
+void *(Bun_Dynamic_Arena_Alloc_Insert)(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena)
 {
-    uintptr_t current_pointer, offset;
     void *ptr;
-    Bun_Arena *pool;
 
-    if (size > arena->pool_size) return Bun_Dynamic_Arena_Alloc_Push(size, zeroed, alignment, arena);
+    if (size > arena->pool_size) return (Bun_Dynamic_Arena_Alloc_Push)(size, zeroed, alignment, arena);
 
     int i;
     for (i = 0; i < arena->pool_len; i++)
     {
-        pool = &arena->pools[i];
-
-        current_pointer = (uintptr_t)pool->buffer + (uintptr_t)pool->offset;
-        offset = (uintptr_t)Bun_Align_Formula(current_pointer, alignment) - (uintptr_t)pool->buffer;
-
-        if ( offset + size > pool->buffer_size ) continue;
-
-        ptr = &pool->buffer[offset];
-        pool->offset = offset + size;
-
-        if (zeroed) memset(ptr, 0, size);
-
-        return ptr;
+        ptr = Bun_Arena__Push(size, zeroed, alignment, &arena->pools[i]);
+        if (ptr != NULL) return ptr;
     }
     /* if we reach here there are no gaps to fill */
-    return Bun_Dynamic_Arena_Alloc_Push(size, zeroed, alignment, arena);
+    return (Bun_Dynamic_Arena_Alloc_Push)(size, zeroed, alignment, arena);
 }
-void *Bun_Dynamic_Arena_Resize(void *old_memory, Bun_U32 size, Bun_U32 old_size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena)
+void *(Bun_Dynamic_Arena_Resize)(void *old_memory, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena)
 {
-    uintptr_t current_pointer, offset;
+    uintptr_t offset, header_size;
     void *ptr;
     Bun_Arena *pool;
-    int i;
+    Bun_Dynamic_Arena_Large **link, *large;
+    Bun_U32 i;
 
-    for (i = 0; i < arena->pool_offset; i++)
+    header_size = (arena->flags & BUN_ARENA_FLAG_SIZE_HEADER) ? sizeof(Bun_Arena_Size_Header) : 0;
+
+    /*Alloc_Insert fills gaps in any pool, not just those up to pool_offset*/
+    for (i = 0; i < arena->pool_len; i++)
     {
         pool = &arena->pools[i];
+        if (pool->buffer == NULL) continue;
         if ((uintptr_t)old_memory < (uintptr_t)pool->buffer || (uintptr_t)old_memory >= (uintptr_t)pool->buffer + pool->buffer_size)
             continue;
         /* pool found */
+        if (header_size)
+        {
+            if (size > (Bun_Arena_Size_Header)-1) return NULL;
+            old_size = Bun_Arena_Allocation_Size(old_memory);
+        }
         offset = (Bun_Byte*)old_memory - pool->buffer;
-        if (offset == pool->offset - old_size) /*Is on the end*/
+        if (offset + old_size == pool->offset) /*Is on the end*/
         {
-            if (offset + size >= pool->buffer_size)
-            {
-                pool->offset = offset;
-                ptr = Bun_Dynamic_Arena_Alloc_Push(size, zeroed, alignment, arena);
-                if (ptr == NULL) return NULL;
-                return memmove(ptr, old_memory, size);
-            }
-            else if (size < old_size)
+            if (size <= pool->buffer_size - offset)
             {
                 pool->offset = offset + size;
+                if (zeroed && size > old_size) Bun_Memory_Zero((Bun_Byte *)old_memory + old_size, size - old_size);
+                if (header_size) Bun_Arena__Set_Size(old_memory, size);
                 return old_memory;
             }
-            else
+            /* give the tail back before moving, the old data stays intact until copied */
+            pool->offset = offset - header_size;
+            pool->padding -= header_size;
+            ptr = (Bun_Dynamic_Arena_Alloc_Push)(size, zeroed, alignment, arena);
+            if (ptr == NULL)
             {
-                pool->offset = offset + size;
-                return old_memory;
+                /*pools may have moved*/
+                arena->pools[i].offset = offset + old_size;
+                arena->pools[i].padding += header_size;
+                return NULL;
             }
+            return memmove(ptr, old_memory, old_size);
         }
         else if (size <= old_size)  /*shrink in the middle of allocated mem (do nothing)*/
         {
+            if (header_size) Bun_Arena__Set_Size(old_memory, size);
+            pool->abandoned += old_size - size;
             return old_memory;
         }
-        else /*shrink in the middle of allocated mem (move) */
+        else /*grow in the middle of allocated mem (move) */
         {
-            ptr = Bun_Dynamic_Arena_Alloc_Push(size, zeroed, alignment, arena);
+            ptr = (Bun_Dynamic_Arena_Alloc_Push)(size, zeroed, alignment, arena);
             if (ptr == NULL) return NULL;
-            return memmove(ptr, old_memory, size);
+            arena->pools[i].abandoned += old_size;
+            return memmove(ptr, old_memory, old_size);
         }
 
     }
+
+    link = Bun_Dynamic_Arena__Find_Large(old_memory, arena);
+    if (link != NULL)
+    {
+        large = *link;
+        old_size = large->size;
+        if (size <= (uintptr_t)large + large->block_size - (uintptr_t)old_memory) /*still fits its block*/
+        {
+            if (zeroed && size > old_size) Bun_Memory_Zero((Bun_Byte *)old_memory + old_size, size - old_size);
+            if (header_size) Bun_Arena__Set_Size(old_memory, size);
+            large->size = size;
+            return old_memory;
+        }
+        ptr = (Bun_Dynamic_Arena_Alloc_Push)(size, zeroed, alignment, arena);
+        if (ptr == NULL) return NULL;
+        memcpy(ptr, old_memory, old_size);
+
+        /* the new block may have been linked in front, look the old one up again */
+        link = Bun_Dynamic_Arena__Find_Large(old_memory, arena);
+        *link = large->next;
+        (Bun_Allocator_Free)(large, arena->allocator);
+        return ptr;
+    }
     /* If here is reached old_memory is not a valid pointer */
     return NULL;
 }
-void Bun_Dynamic_Arena_Free_All(Bun_Dynamic_Arena *arena, bool zero_pools)
+void (Bun_Dynamic_Arena_Free_All)(Bun_Dynamic_Arena *arena, bool zero_pools)
 {
     if (arena == NULL) return;
+    Bun_Dynamic_Arena__Profile_Record(arena);
     int i;
     for (i = 0; i < arena->pool_len; i++)
     {
         Bun_Arena *pool = &arena->pools[i];
         pool->offset = 0;
-        if (zero_pools) memset(pool->buffer, 0, pool->buffer_size);
+        pool->padding = 0;
+        pool->abandoned = 0;
+        if (zero_pools) Bun_Memory_Zero(pool->buffer, pool->buffer_size);
     }
     arena->pool_offset = 0;
+    Bun_Dynamic_Arena__Release_Large(arena);
+    Bun_Dynamic_Arena__Profile_Provision(arena);
 }
-void Bun_Dynamic_Arena_Free_Pools(Bun_Dynamic_Arena *arena, Bun_U32 min_pools, bool zero_pools)
+void (Bun_Dynamic_Arena_Free_Pools)(Bun_Dynamic_Arena *arena, Bun_U32 min_pools, bool zero_pools)
 {
+    Bun_Arena *new_pools;
+    Bun_U32 pool_len;
+
     if (arena == NULL) return;
 
-    if (arena->pool_len < min_pools) Bun_Dynamic_Arena_Free_All(arena, zero_pools);
+    if (arena->pool_len <= min_pools)
+    {
+        (Bun_Dynamic_Arena_Free_All)(arena, zero_pools);
+        return;
+    }
+    Bun_Dynamic_Arena__Profile_Record(arena);
 
     int i;
     for (i = 0; i < arena->pool_len; i++)
     {
         Bun_Arena *pool = &arena->pools[i];
         pool->offset = 0;
-        if (i >= min_pools) Bun_Allocator_Free(pool->buffer, arena->allocator);
-        else if (zero_pools) memset(pool->buffer, 0, pool->buffer_size);
+        pool->padding = 0;
+        pool->abandoned = 0;
+        if (i >= min_pools)
+        {
+            if (pool->buffer != NULL) Bun_Dynamic_Arena__Pool_Free(pool, arena);
+            memset(pool, 0, sizeof(*pool));
+        }
+        else if (zero_pools) Bun_Memory_Zero(pool->buffer, pool->buffer_size);
     }
-    arena->pools = Bun_Allocator_Resize( arena->pools,
-                                   sizeof(Bun_Arena)*min_pools, sizeof(Bun_Arena)*arena->pool_len,
+    /*keep a slot around for the next allocation*/
+    pool_len = (min_pools) ? min_pools : 1;
+    new_pools = (Bun_Allocator_Resize)( arena->pools,
+                                   sizeof(Bun_Arena)*pool_len, sizeof(Bun_Arena)*arena->pool_len,
                                    false, BUN_ALLOCATOR_DEFAULT_ALIGN, arena->allocator);
-    arena->pool_len = min_pools;
+    if (new_pools != NULL)
+    {
+        arena->pools = new_pools;
+        arena->pool_len = pool_len;
+    }
     arena->pool_offset = 0;
+    Bun_Dynamic_Arena__Release_Large(arena);
+    Bun_Dynamic_Arena__Profile_Provision(arena);
+}
+
+Bun_Arena_Stats Bun_Arena_Get_Stats(Bun_Arena *arena)
+{
+    Bun_Arena_Stats stats = {0};
+    Bun_USize overhead;
+
+    if (arena == NULL || arena->buffer == NULL) return stats;
+
+    overhead = arena->padding + arena->abandoned;
+    stats.buffer_size = arena->buffer_size;
+    stats.offset      = arena->offset;
+    stats.padding     = arena->padding;
+    stats.abandoned   = arena->abandoned;
+    stats.live        = (arena->offset > overhead) ? arena->offset - overhead : 0;
+    stats.unused      = arena->buffer_size - arena->offset;
+    return stats;
+}
+
+Bun_Dynamic_Arena_Stats Bun_Dynamic_Arena_Get_Stats(Bun_Dynamic_Arena *arena)
+{
+    Bun_Dynamic_Arena_Stats stats = {0};
+    Bun_Dynamic_Arena_Large *large;
+    Bun_U32 i;
+
+    if (arena == NULL || arena->pools == NULL) return stats;
+
+    for (i = 0; i < arena->pool_len; i++)
+    {
+        Bun_Arena_Stats pool = Bun_Arena_Get_Stats(&arena->pools[i]);
+        if (arena->pools[i].buffer == NULL) continue;
+
+        stats.pool_count += 1;
+        stats.reserved   += pool.buffer_size;
+        stats.live       += pool.live;
+        stats.padding    += pool.padding;
+        stats.abandoned  += pool.abandoned;
+        if (i < arena->pool_offset) stats.stranded += pool.unused;
+        else                        stats.unused   += pool.unused;
+    }
+    for (large = arena->large; large != NULL; large = large->next)
+    {
+        stats.large_count += 1;
+        stats.large_bytes += large->size;
+        stats.reserved    += large->block_size;
+        stats.live        += large->size;
+        stats.padding     += large->block_size - large->size;
+    }
+    return stats;
+}
+
+static void Bun_Arena__Report_Field(Bun_String_Buffer *text, Bun_Arena_Report_Format format, const char *key, Bun_U64 value, bool first)
+{
+    if (format == BUN_ARENA_REPORT_JSON)
+    {
+        Bun_String_Buffer_Append(text, (first) ? "\"" : ",\"");
+        Bun_String_Buffer_Append(text, key);
+        Bun_String_Buffer_Append(text, "\":");
+    }
+    else
+    {
+        Bun_String_Buffer_Append(text, " ");
+        Bun_String_Buffer_Append(text, key);
+        Bun_String_Buffer_Append(text, "=");
+    }
+    Bun_String_Buffer_Append_U64(text, value);
+}
+
+Bun_U32 Bun_Dynamic_Arena_Report(Bun_Dynamic_Arena *arena, Bun_Arena_Report_Format format, char *buffer, Bun_U32 buffer_size)
+{
+    Bun_String_Buffer text = Bun_String_Buffer_From(buffer, buffer_size);
+    Bun_Dynamic_Arena_Stats stats = Bun_Dynamic_Arena_Get_Stats(arena);
+    bool json = format == BUN_ARENA_REPORT_JSON;
+    bool first_pool = true;
+    Bun_U32 i;
+
+    Bun_String_Buffer_Append(&text, (json) ? "{" : "dynamic_arena");
+    Bun_Arena__Report_Field(&text, format, "pool_size",   (arena) ? arena->pool_size : 0, true);
+    Bun_Arena__Report_Field(&text, format, "pool_count",  stats.pool_count,  false);
+    Bun_Arena__Report_Field(&text, format, "reserved",    stats.reserved,    false);
+    Bun_Arena__Report_Field(&text, format, "live",        stats.live,        false);
+    Bun_Arena__Report_Field(&text, format, "padding",     stats.padding,     false);
+    Bun_Arena__Report_Field(&text, format, "abandoned",   stats.abandoned,   false);
+    Bun_Arena__Report_Field(&text, format, "stranded",    stats.stranded,    false);
+    Bun_Arena__Report_Field(&text, format, "unused",      stats.unused,      false);
+    Bun_Arena__Report_Field(&text, format, "large_count", stats.large_count, false);
+    Bun_Arena__Report_Field(&text, format, "large_bytes", stats.large_bytes, false);
+    Bun_String_Buffer_Append(&text, (json) ? ",\"pools\":[" : "\n");
+
+    for (i = 0; arena != NULL && i < arena->pool_len; i++)
+    {
+        Bun_Arena_Stats pool = Bun_Arena_Get_Stats(&arena->pools[i]);
+        if (arena->pools[i].buffer == NULL) continue;
+
+        if (json) Bun_String_Buffer_Append(&text, (first_pool) ? "{" : ",{");
+        else      Bun_String_Buffer_Append(&text, "pool");
+        first_pool = false;
+        Bun_Arena__Report_Field(&text, format, "index",       i,                true);
+        Bun_Arena__Report_Field(&text, format, "buffer_size", pool.buffer_size, false);
+        Bun_Arena__Report_Field(&text, format, "offset",      pool.offset,      false);
+        Bun_Arena__Report_Field(&text, format, "live",        pool.live,        false);
+        Bun_Arena__Report_Field(&text, format, "padding",     pool.padding,     false);
+        Bun_Arena__Report_Field(&text, format, "abandoned",   pool.abandoned,   false);
+        Bun_Arena__Report_Field(&text, format, "unused",      pool.unused,      false);
+        Bun_String_Buffer_Append(&text, (json) ? "}" : "\n");
+    }
+    if (json) Bun_String_Buffer_Append(&text, "]}\n");
+
+    return (text.overflow) ? 0 : text.len;
 }
@@ -1,28 +1,135 @@
+typedef Bun_U32 Bun_Arena_Flags;
+enum
+{
+    /*
+    Store a compact size header before every allocation, resize can then
+    ignore old_size and Bun_Arena_Allocation_Size can query it.
+    Set on an arena right after init, before the first allocation.
+    The header is 32 bit, allocations of 4GB and more fail on these arenas.
+    */
+    BUN_ARENA_FLAG_SIZE_HEADER = (1<<0),
+};
+typedef Bun_U32 Bun_Arena_Size_Header;
+
 typedef struct
 {
     Bun_Byte *buffer;
-    Bun_U32 buffer_size;
-    Bun_U32 offset;
+    Bun_USize buffer_size;
+    Bun_USize offset;
+    Bun_Arena_Flags flags;
 
+    Bun_USize padding;   /*bytes in offset lost to alignment and size headers*/
+    Bun_USize abandoned; /*bytes in offset left behind by resizes*/
 } Bun_Arena;
 
+/*
+Allocations bigger then a pool are kept out of the pools in their own block,
+this header sits at the start of each block.
+*/
+typedef struct Bun_Dynamic_Arena_Large Bun_Dynamic_Arena_Large;
+struct Bun_Dynamic_Arena_Large
+{
+    Bun_Dynamic_Arena_Large *next;
+    Bun_USize block_size; /*size in bytes of the whole block, header included*/
+    Bun_USize size;       /*size in bytes of the allocation in the block*/
+};
+
+/*
+Usage of a dynamic arena over its previous lifetimes (init to free_all,
+free_all to free_all...), used to pre-size its pools. See
+Bun_Dynamic_Arena_Init_Profiled.
+*/
+#define BUN_DYNAMIC_ARENA_PROFILE_HISTORY 16
+typedef struct
+{
+    Bun_USize peak_bytes[BUN_DYNAMIC_ARENA_PROFILE_HISTORY];
+    Bun_U32 pool_counts[BUN_DYNAMIC_ARENA_PROFILE_HISTORY];
+    Bun_U32 count;      /*recorded lifetimes, up to BUN_DYNAMIC_ARENA_PROFILE_HISTORY*/
+    Bun_U32 next;       /*slot the next lifetime is recorded in*/
+    Bun_U32 percentile; /*percentile of peak_bytes to pre-size to, 0 means 95*/
+} Bun_Dynamic_Arena_Profile;
+
 typedef struct
 {
     Bun_Arena *pools;
     Bun_U32 pool_len;
     Bun_U32 pool_offset;
 
-    Bun_U32  pool_size;
+    Bun_USize pool_size;
     bool pool_zeroed;
     Bun_U32  pool_alignment;
     Bun_Allocator *allocator;
+    Bun_Arena_Flags flags; /*applied to every pool*/
+
+    Bun_Dynamic_Arena_Large *large;       /*live allocations bigger then pool_size*/
+    Bun_Dynamic_Arena_Large *large_cache; /*blocks kept by free_all for reuse*/
+    Bun_USize large_cache_limit;          /*bytes of blocks free_all may keep, 0 (default) frees them all*/
+
+    Bun_Dynamic_Arena_Profile *profile;   /*NULL unless initialised with Bun_Dynamic_Arena_Init_Profiled*/
 } Bun_Dynamic_Arena;
 
-void Bun_Arena_Init_From_Allocator(Bun_Arena *arena, Bun_Allocator *allocator, Bun_U32 buffer_size, bool zeroed, Bun_U32 alignment);
+void Bun_Arena_Init_From_Allocator(Bun_Arena *arena, Bun_Allocator *allocator, Bun_USize buffer_size, bool zeroed, Bun_U32 alignment);
 void Bun_Arena_Deinit_From_Allocator(Bun_Arena *arena, Bun_Allocator *allocator);
-void *Bun_Arena_Alloc(Bun_U32 size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena);
-void *Bun_Arena_Resize(void *old_memory, Bun_U32 size, Bun_U32 old_size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena);
+void *Bun_Arena_Alloc(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena);
+/*
+Resize previusly allocated memory in an arena, in place if it is the last allocation.
+
+ARGS:
+    old_memory - pointer to memory previusly allocated on the arena
+    size       - size in bytes of new allocation
+    old_size   - size in bytes of old allocation (ignored with BUN_ARENA_FLAG_SIZE_HEADER)
+    zeroed     - wether to initialise the grown memory to zero
+    alignment  - alignment of allocation if it has to move
+    arena      - the arena used to allocate *old_memory*
+RETURN:
+    Pointer to allocated memory or NULL on failure
+*/
+void *Bun_Arena_Resize(void *old_memory, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena);
+/*
+Bump *arena* by *size* bytes aligned to a power of two *alignment*.
+RETURN:
+    Pointer to allocated memory, NULL when it does not fit or the arena has size headers
+*/
+BUN_INLINE void *Bun_Arena__Bump(Bun_USize size, Bun_U32 alignment, Bun_Arena *arena)
+{
+    uintptr_t current = (uintptr_t)arena->buffer + arena->offset;
+    uintptr_t start = (current + ((uintptr_t)alignment - 1)) & ~((uintptr_t)alignment - 1);
+    uintptr_t end = start + size;
+
+    if (BUN_UNLIKELY(arena->flags != 0
+    || (alignment & (alignment - 1)) != 0
+    || start < current || end < start
+    || end > (uintptr_t)arena->buffer + arena->buffer_size
+    )) return NULL;
+
+    arena->padding += start - current;
+    arena->offset = end - (uintptr_t)arena->buffer;
+    return (void *)start;
+}
+/*
+Inline fast path of Bun_Arena_Alloc, a compare and an add for non zeroed
+allocations that fit, anything else goes to Bun_Arena_Alloc.
+*/
+BUN_INLINE void *Bun_Arena_Alloc_Inline(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena)
+{
+    void *ptr;
+    if (!zeroed && arena->buffer != NULL)
+    {
+        ptr = Bun_Arena__Bump(size, alignment, arena);
+        if (BUN_LIKELY(ptr != NULL)) return ptr;
+    }
+    return Bun_Arena_Alloc(size, zeroed, alignment, arena);
+}
 void  Bun_Arena_Free_All(Bun_Arena *arena);
+/*
+Size of an allocation made by an arena or dynamic arena with BUN_ARENA_FLAG_SIZE_HEADER.
+
+ARGS:
+    ptr - pointer to memory allocated on a size header arena
+RETURN:
+    size in bytes of the allocation, meaningless if the arena has no size headers
+*/
+Bun_U32 Bun_Arena_Allocation_Size(void *ptr);
 
 /*
 Initialise dynamic_arena and allocate the first pool.
@@ -35,9 +142,53 @@ ARGS:
 RETURN:
     true on success, false on failure
 */
-bool Bun_Dynamic_Arena_Init( Bun_Dynamic_Arena *arena, Bun_Allocator *backing_allocator, Bun_U32 pool_size, bool pool_zeroed, Bun_U32 pool_alignment );
+bool Bun_Dynamic_Arena_Init( Bun_Dynamic_Arena *arena, Bun_Allocator *backing_allocator, Bun_USize pool_size, bool pool_zeroed, Bun_U32 pool_alignment );
+/*
+Initialise dynamic_arena with a usage profile.
+Every free_all, free_pools and deinit records the arenas usage in the
+profile, and init, free_all and free_pools replace the pools with a single
+pool sized to a high percentile of the recorded usage.
+
+ARGS:
+    (same as Bun_Dynamic_Arena_Init)
+    profile - zero initialised or imported profile, must outlive the arena.
+              May be shared by arenas used one after another.
+RETURN:
+    true on success, false on failure
+*/
+bool Bun_Dynamic_Arena_Init_Profiled( Bun_Dynamic_Arena *arena, Bun_Allocator *backing_allocator, Bun_USize pool_size, bool pool_zeroed, Bun_U32 pool_alignment, Bun_Dynamic_Arena_Profile *profile );
+/*
+Pool size a profile currently suggests.
+
+RETURN:
+    size in bytes, 0 if nothing has been recorded yet
+*/
+Bun_USize Bun_Dynamic_Arena_Profile_Size(Bun_Dynamic_Arena_Profile *profile);
+/*
+Write a profile as text, to be imported by a later process.
+
+ARGS:
+    profile     - profile to export.
+    buffer      - buffer to write the NULL terminated text into.
+    buffer_size - size in bytes of buffer.
+RETURN:
+    length of the text, or 0 if buffer is too small
+*/
+Bun_U32 Bun_Dynamic_Arena_Profile_Export(Bun_Dynamic_Arena_Profile *profile, char *buffer, Bun_U32 buffer_size);
+/*
+Read a profile written by Bun_Dynamic_Arena_Profile_Export.
+
+ARGS:
+    profile - profile to overwrite, untouched on failure.
+    text    - exported text.
+    len     - length of text or 0 to use strlen(text)
+RETURN:
+    true on success, false if text is not a valid profile
+*/
+bool Bun_Dynamic_Arena_Profile_Import(Bun_Dynamic_Arena_Profile *profile, const char *text, Bun_U32 len);
 /*
 Deinitialise dynamic_arena and free all pools
+(pools are given to the pool cache first when it is enabled, see pool_cache.h)
 
 ARGS:
     arena - initialised arena
@@ -49,6 +200,8 @@ push the allocation on the last pool.
 
 best for when an allocation is likely to be bigger then any gaps in the pools.
 NOTE: alloc_insert will call this itself for allocations where sizes > pool size
+NOTE: allocations that do not fit in pool_size get a block of their own from
+      the backing allocator, leaving the current pool untouched.
 
 ARGS:
     size      - size of allocation in bytes
@@ -58,7 +211,7 @@ ARGS:
 RETURN:
     Pointer to allocated memory or NULL on failure
 */
-void *Bun_Dynamic_Arena_Alloc_Push(Bun_U32 size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena);
+void *Bun_Dynamic_Arena_Alloc_Push(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena);
 /*
 Allocate using the dynamic arena, searching for gaps in all pools and
 inserting the new allocation in any free gap or appending it.
@@ -74,11 +227,29 @@ ARGS:
 RETURN:
     Pointer to allocated memory or NULL on failure
 */
-void *Bun_Dynamic_Arena_Alloc_Insert(Bun_U32 size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena);
+void *Bun_Dynamic_Arena_Alloc_Insert(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena);
+/*
+Inline fast path of Bun_Dynamic_Arena_Alloc_Push, bumping the current pool
+for non zeroed allocations that fit, anything else (a new pool, large
+allocations...) goes to Bun_Dynamic_Arena_Alloc_Push.
+*/
+BUN_INLINE void *Bun_Dynamic_Arena_Alloc_Inline(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena)
+{
+    Bun_Arena *pool = &arena->pools[arena->pool_offset];
+    void *ptr;
+    if (!zeroed && pool->buffer != NULL)
+    {
+        ptr = Bun_Arena__Bump(size, alignment, pool);
+        if (BUN_LIKELY(ptr != NULL)) return ptr;
+    }
+    return Bun_Dynamic_Arena_Alloc_Push(size, zeroed, alignment, arena);
+}
 /*
 Resize previusly allocated memory in a dynamic arena.
 Will attempt to preserve the pointer if it is the last allocation in a pool
 with enough free space to grow, otherwise the pointer is moved.
+With BUN_ARENA_FLAG_SIZE_HEADER set on the arena old_size is read from the
+allocation instead, so it can be passed as 0.
 
 In general try to avoid overusing resizes as it can ""leak"" memory until
 free_all call. (not a actual memory leak, it will freed, but its wasted)
@@ -93,10 +264,12 @@ ARGS:
 RETURN:
     Pointer to allocated memory or NULL on failure
 */
-void *Bun_Dynamic_Arena_Resize(void *old_memory, Bun_U32 size, Bun_U32 old_size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena);
+void *Bun_Dynamic_Arena_Resize(void *old_memory, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena);
 /*
 Free every allocation, but hold onto the allocated pools.
 New allocations after a free_all will overwrite the old memory in the pools.
+Blocks of allocations bigger then pool_size are freed, or kept for reuse up
+to large_cache_limit bytes.
 
 ARGS:
     arena      - an initialised dynamic arena
@@ -114,19 +287,96 @@ ARGS:
 */
 void Bun_Dynamic_Arena_Free_Pools(Bun_Dynamic_Arena *arena, Bun_U32 min_pools, bool zero_pools);
 
+/*
+Occupancy of a single arena or dynamic arena pool.
+live + padding + abandoned == offset, offset + unused == buffer_size
+*/
+typedef struct
+{
+    Bun_USize buffer_size;
+    Bun_USize offset;
+    Bun_USize live;      /*bytes handed out and not abandoned*/
+    Bun_USize padding;   /*alignment padding and size headers*/
+    Bun_USize abandoned; /*left behind by resizes that moved or shrunk in the middle*/
+    Bun_USize unused;    /*free tail*/
+} Bun_Arena_Stats;
+
+/*
+Occupancy of a whole dynamic arena, sums over all its pools.
+*/
+typedef struct
+{
+    Bun_U32 pool_count;  /*pools with a buffer*/
+    Bun_U64 reserved;    /*bytes in pools and large blocks*/
+    Bun_U64 live;
+    Bun_U64 padding;
+    Bun_U64 abandoned;
+    Bun_U64 stranded;    /*free tails of pools before the current one, skipped by alloc_push*/
+    Bun_U64 unused;      /*free tail of the current pool and pools after it*/
+    Bun_U32 large_count; /*allocations kept out of the pools*/
+    Bun_U64 large_bytes;
+} Bun_Dynamic_Arena_Stats;
+
+typedef Bun_U8 Bun_Arena_Report_Format;
+enum
+{
+    BUN_ARENA_REPORT_TEXT,
+    BUN_ARENA_REPORT_JSON,
+};
+
+Bun_Arena_Stats Bun_Arena_Get_Stats(Bun_Arena *arena);
+Bun_Dynamic_Arena_Stats Bun_Dynamic_Arena_Get_Stats(Bun_Dynamic_Arena *arena);
+/*
+Write the stats of a dynamic arena and of each of its pools as text or json.
+
+ARGS:
+    arena       - an initialised dynamic arena
+    format      - BUN_ARENA_REPORT_TEXT or BUN_ARENA_REPORT_JSON
+    buffer      - buffer to write the NULL terminated report into.
+    buffer_size - size in bytes of buffer.
+RETURN:
+    length of the report, or 0 if buffer is too small
+*/
+Bun_U32 Bun_Dynamic_Arena_Report(Bun_Dynamic_Arena *arena, Bun_Arena_Report_Format format, char *buffer, Bun_U32 buffer_size);
+
+/*internal, used by the compact arena to manage the pools of its dynamic arena*/
+Bun_Dynamic_Arena_Large **Bun_Dynamic_Arena__Find_Large(void *ptr, Bun_Dynamic_Arena *arena);
+void Bun_Dynamic_Arena__Pool_Free(Bun_Arena *pool, Bun_Dynamic_Arena *arena);
+
 #ifdef BUN_STRIP_PREFIX
 #    define Arena Bun_Arena
+#    define Arena_Flags Bun_Arena_Flags
+#        define ARENA_FLAG_SIZE_HEADER BUN_ARENA_FLAG_SIZE_HEADER
+#    define Arena_Size_Header Bun_Arena_Size_Header
 #    define Dynamic_Arena Bun_Dynamic_Arena
+#    define Dynamic_Arena_Large Bun_Dynamic_Arena_Large
+#    define DYNAMIC_ARENA_PROFILE_HISTORY BUN_DYNAMIC_ARENA_PROFILE_HISTORY
+#    define Dynamic_Arena_Profile Bun_Dynamic_Arena_Profile
 #    define Arena_Init_From_Allocator Bun_Arena_Init_From_Allocator
 #    define Arena_Deinit_From_Allocator Bun_Arena_Deinit_From_Allocator
 #    define Arena_Alloc Bun_Arena_Alloc
 #    define Arena_Resize Bun_Arena_Resize
+#    define Arena_Alloc_Inline Bun_Arena_Alloc_Inline
 #    define Arena_Free_All Bun_Arena_Free_All
+#    define Arena_Allocation_Size Bun_Arena_Allocation_Size
 #    define Dynamic_Arena_Init Bun_Dynamic_Arena_Init
+#    define Dynamic_Arena_Init_Profiled Bun_Dynamic_Arena_Init_Profiled
+#    define Dynamic_Arena_Profile_Size Bun_Dynamic_Arena_Profile_Size
+#    define Dynamic_Arena_Profile_Export Bun_Dynamic_Arena_Profile_Export
+#    define Dynamic_Arena_Profile_Import Bun_Dynamic_Arena_Profile_Import
 #    define Dynamic_Arena_Deinit Bun_Dynamic_Arena_Deinit
 #    define Dynamic_Arena_Alloc_Push Bun_Dynamic_Arena_Alloc_Push
 #    define Dynamic_Arena_Alloc_Insert Bun_Dynamic_Arena_Alloc_Insert
+#    define Dynamic_Arena_Alloc_Inline Bun_Dynamic_Arena_Alloc_Inline
 #    define Dynamic_Arena_Resize Bun_Dynamic_Arena_Resize
 #    define Dynamic_Arena_Free_All Bun_Dynamic_Arena_Free_All
 #    define Dynamic_Arena_Free_Pools Bun_Dynamic_Arena_Free_Pools
+#    define Arena_Stats Bun_Arena_Stats
+#    define Dynamic_Arena_Stats Bun_Dynamic_Arena_Stats
+#    define Arena_Report_Format Bun_Arena_Report_Format
+#        define ARENA_REPORT_TEXT BUN_ARENA_REPORT_TEXT
+#        define ARENA_REPORT_JSON BUN_ARENA_REPORT_JSON
+#    define Arena_Get_Stats Bun_Arena_Get_Stats
+#    define Dynamic_Arena_Get_Stats Bun_Dynamic_Arena_Get_Stats
+#    define Dynamic_Arena_Report Bun_Dynamic_Arena_Report
 #endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,306 @@
+#if defined(__unix__) || defined(__APPLE__)
+#    define BUN_COMPACT_ARENA__CLOCK_GETTIME
+#endif
+#include <time.h>
+
+/*slot of objects that were freed*/
+#define BUN_COMPACT_ARENA__DEAD ((Bun_U32)-1)
+#define BUN_COMPACT_ARENA__NO_SLOT ((Bun_U32)-1)
+/*objects moved between clock checks of an incremental step*/
+#define BUN_COMPACT_ARENA__CLOCK_INTERVAL 64
+
+/*
+Sits before every object, padded to the arena alignment.
+*/
+typedef struct
+{
+    Bun_U32 slot;
+    Bun_U32 size;
+} Bun_Compact_Arena__Header;
+
+static Bun_U64 Bun_Compact_Arena__Now_Ns(void)
+{
+#ifdef BUN_COMPACT_ARENA__CLOCK_GETTIME
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (Bun_U64)now.tv_sec*1000000000ull + (Bun_U64)now.tv_nsec;
+#else
+    return (Bun_U64)clock() * (1000000000ull / CLOCKS_PER_SEC);
+#endif
+}
+
+static uintptr_t Bun_Compact_Arena__Header_Size(Bun_Compact_Arena *arena)
+{
+    return Bun_Align_Formula(sizeof(Bun_Compact_Arena__Header), arena->alignment);
+}
+/*
+RETURN:
+    bytes taken by an object in a pool, header included
+*/
+static uintptr_t Bun_Compact_Arena__Extent(Bun_U32 size, Bun_Compact_Arena *arena)
+{
+    return Bun_Compact_Arena__Header_Size(arena) + Bun_Align_Formula(size, arena->alignment);
+}
+/*
+Pool buffers are only as aligned as the backing allocator makes them (libc
+gives 16), so the first object of a pool may sit after some padding. Every
+extent is a multiple of the alignment, so that is the only padding there is.
+RETURN:
+    offset of the first object at or after *offset* in pool
+*/
+static uintptr_t Bun_Compact_Arena__Object_Offset(Bun_Arena *pool, uintptr_t offset, Bun_Compact_Arena *arena)
+{
+    return Bun_Align_Formula((uintptr_t)pool->buffer + offset, arena->alignment) - (uintptr_t)pool->buffer;
+}
+static Bun_Compact_Arena__Header *Bun_Compact_Arena__Get_Header(void *object, Bun_Compact_Arena *arena)
+{
+    return (Bun_Compact_Arena__Header *)((Bun_Byte *)object - Bun_Compact_Arena__Header_Size(arena));
+}
+
+static void *Bun_Compact_Arena__Alloc_Object(Bun_U32 size, bool zeroed, Bun_U32 slot, Bun_Compact_Arena *arena)
+{
+    Bun_Compact_Arena__Header *header;
+    uintptr_t extent = Bun_Compact_Arena__Extent(size, arena);
+    void *object;
+
+    if (extent > (Bun_U32)-1) return NULL;
+    header = (Bun_Dynamic_Arena_Alloc_Push)((Bun_U32)extent, false, arena->alignment, &arena->arena);
+    if (header == NULL) return NULL;
+
+    header->slot = slot;
+    header->size = size;
+    object = (Bun_Byte *)header + Bun_Compact_Arena__Header_Size(arena);
+    if (zeroed) Bun_Memory_Zero(object, size);
+    return object;
+}
+/*
+Objects that do not fit a pool are in large blocks of the dynamic arena and
+are freed right away, the rest are marked dead for compaction to skip.
+*/
+static void Bun_Compact_Arena__Free_Object(void *object, Bun_Compact_Arena *arena)
+{
+    Bun_Compact_Arena__Header *header = Bun_Compact_Arena__Get_Header(object, arena);
+    uintptr_t extent = Bun_Compact_Arena__Extent(header->size, arena);
+    Bun_Dynamic_Arena_Large **link, *large;
+
+    if (extent > arena->arena.pool_size)
+    {
+        link = Bun_Dynamic_Arena__Find_Large(header, &arena->arena);
+        if (link == NULL) return;
+        large = *link;
+        *link = large->next;
+        (Bun_Allocator_Free)(large, arena->arena.allocator);
+        return;
+    }
+    header->slot = BUN_COMPACT_ARENA__DEAD;
+    arena->dead += extent;
+}
+
+bool Bun_Compact_Arena_Init(Bun_Compact_Arena *arena, Bun_Allocator *backing_allocator, Bun_U32 pool_size, Bun_U32 alignment)
+{
+    memset(arena, 0, sizeof(*arena));
+    /*headers hold U32s*/
+    if (alignment < sizeof(Bun_U32)) alignment = sizeof(Bun_U32);
+    if (!Bun_Dynamic_Arena_Init(&arena->arena, backing_allocator, pool_size, false, alignment)) return false;
+    arena->alignment = alignment;
+    arena->free_slot = BUN_COMPACT_ARENA__NO_SLOT;
+    return true;
+}
+
+void Bun_Compact_Arena_Deinit(Bun_Compact_Arena *arena)
+{
+    if (arena->slots != NULL) (Bun_Allocator_Free)(arena->slots, arena->arena.allocator);
+    (Bun_Dynamic_Arena_Deinit)(&arena->arena);
+    memset(arena, 0, sizeof(*arena));
+}
+
+Bun_Compact_Handle Bun_Compact_Arena_Alloc(Bun_U32 size, bool zeroed, Bun_Compact_Arena *arena)
+{
+    Bun_Compact_Handle handle = {0, 0};
+    Bun_Compact_Arena_Slot *slot;
+    Bun_U32 index;
+    void *object;
+
+    if (arena->free_slot != BUN_COMPACT_ARENA__NO_SLOT)
+    {
+        index = arena->free_slot;
+    }
+    else
+    {
+        if (arena->slot_len == arena->slot_capacity)
+        {
+            Bun_U32 capacity = (arena->slot_capacity) ? arena->slot_capacity*2 : 64;
+            Bun_Compact_Arena_Slot *slots = (arena->slots == NULL)
+                ? (Bun_Allocator_Alloc)(sizeof(*slots)*capacity, false, BUN_ALLOCATOR_DEFAULT_ALIGN, arena->arena.allocator)
+                : (Bun_Allocator_Resize)(arena->slots, sizeof(*slots)*capacity, sizeof(*slots)*arena->slot_capacity,
+                                       false, BUN_ALLOCATOR_DEFAULT_ALIGN, arena->arena.allocator);
+            if (slots == NULL) return handle;
+            arena->slots = slots;
+            arena->slot_capacity = capacity;
+        }
+        index = arena->slot_len;
+        arena->slots[index].ptr = NULL;
+        arena->slots[index].generation = 1;
+        arena->slots[index].next_free = BUN_COMPACT_ARENA__NO_SLOT;
+    }
+
+    object = Bun_Compact_Arena__Alloc_Object(size, zeroed, index, arena);
+    if (object == NULL) return handle;
+
+    /*only claim the slot once the object exists*/
+    slot = &arena->slots[index];
+    if (index == arena->free_slot) arena->free_slot = slot->next_free;
+    else arena->slot_len += 1;
+    slot->ptr = object;
+
+    handle.index = index;
+    handle.generation = slot->generation;
+    return handle;
+}
+
+void *Bun_Compact_Arena_Get(Bun_Compact_Arena *arena, Bun_Compact_Handle handle)
+{
+    if (handle.generation == 0
+    ||  handle.index >= arena->slot_len
+    ||  arena->slots[handle.index].generation != handle.generation
+    ) return NULL;
+    return arena->slots[handle.index].ptr;
+}
+
+bool Bun_Compact_Arena_Resize(Bun_Compact_Handle handle, Bun_U32 size, bool zeroed, Bun_Compact_Arena *arena)
+{
+    void *object = Bun_Compact_Arena_Get(arena, handle);
+    void *new_object;
+    Bun_U32 old_size;
+
+    if (object == NULL) return false;
+    old_size = Bun_Compact_Arena__Get_Header(object, arena)->size;
+    /*shrinking keeps the objects extent, compaction walks pools by it*/
+    if (size <= old_size) return true;
+
+    new_object = Bun_Compact_Arena__Alloc_Object(size, false, handle.index, arena);
+    if (new_object == NULL) return false;
+    memcpy(new_object, object, old_size);
+    if (zeroed) Bun_Memory_Zero((Bun_Byte *)new_object + old_size, size - old_size);
+
+    Bun_Compact_Arena__Free_Object(object, arena);
+    arena->slots[handle.index].ptr = new_object;
+    return true;
+}
+
+void Bun_Compact_Arena_Free(Bun_Compact_Handle handle, Bun_Compact_Arena *arena)
+{
+    void *object = Bun_Compact_Arena_Get(arena, handle);
+    Bun_Compact_Arena_Slot *slot;
+
+    if (object == NULL) return;
+    Bun_Compact_Arena__Free_Object(object, arena);
+
+    slot = &arena->slots[handle.index];
+    slot->ptr = NULL;
+    slot->generation += 1;
+    if (slot->generation == 0) slot->generation = 1;
+    slot->next_free = arena->free_slot;
+    arena->free_slot = handle.index;
+}
+
+/*
+Everything left of the dest cursor is compacted, pools after it are empty.
+Keep one of them as a spare and give the rest back.
+*/
+static void Bun_Compact_Arena__Finish(Bun_Compact_Arena *arena)
+{
+    Bun_Dynamic_Arena *dynamic = &arena->arena;
+    Bun_U32 i;
+
+    for (i = arena->dest_pool; i < dynamic->pool_len; i++)
+    {
+        Bun_Arena *pool = &dynamic->pools[i];
+        pool->offset    = (i == arena->dest_pool) ? arena->dest_offset : 0;
+        pool->padding   = (pool->offset) ? Bun_Compact_Arena__Object_Offset(pool, 0, arena) : 0;
+        pool->abandoned = 0;
+        if (i > arena->dest_pool + 1 && pool->buffer != NULL)
+        {
+            Bun_Dynamic_Arena__Pool_Free(pool, dynamic);
+            memset(pool, 0, sizeof(*pool));
+        }
+    }
+    dynamic->pool_offset = arena->dest_pool;
+    arena->compacting = false;
+}
+
+bool Bun_Compact_Arena_Compact_Step(Bun_Compact_Arena *arena, Bun_U64 budget_ns)
+{
+    Bun_Dynamic_Arena *dynamic = &arena->arena;
+    uintptr_t header_size = Bun_Compact_Arena__Header_Size(arena);
+    Bun_U64 deadline = (budget_ns) ? Bun_Compact_Arena__Now_Ns() + budget_ns : 0;
+    Bun_U32 count = 0;
+
+    if (!arena->compacting)
+    {
+        arena->source_pool   = 0;
+        arena->source_offset = 0;
+        arena->dest_pool     = 0;
+        arena->dest_offset   = 0;
+        arena->compacting    = true;
+    }
+
+    for (;;)
+    {
+        Bun_Arena *source = &dynamic->pools[arena->source_pool];
+        Bun_Arena *dest;
+        Bun_Compact_Arena__Header *header;
+        uintptr_t extent, dest_offset;
+
+        if (source->buffer != NULL) arena->source_offset = Bun_Compact_Arena__Object_Offset(source, arena->source_offset, arena);
+        if (source->buffer == NULL || arena->source_offset >= source->offset)
+        {
+            if (arena->source_pool >= dynamic->pool_offset) break;
+            arena->source_pool += 1;
+            arena->source_offset = 0;
+            continue;
+        }
+
+        header = (Bun_Compact_Arena__Header *)(source->buffer + arena->source_offset);
+        extent = Bun_Compact_Arena__Extent(header->size, arena);
+        arena->source_offset += extent;
+
+        if (header->slot == BUN_COMPACT_ARENA__DEAD)
+        {
+            arena->dead -= extent;
+        }
+        else
+        {
+            dest = &dynamic->pools[arena->dest_pool];
+            dest_offset = Bun_Compact_Arena__Object_Offset(dest, arena->dest_offset, arena);
+            /*dest is behind source, so moving on lands in source's pool at the latest*/
+            if (dest_offset + extent > dest->buffer_size)
+            {
+                dest->offset    = arena->dest_offset;
+                dest->padding   = (dest->offset) ? Bun_Compact_Arena__Object_Offset(dest, 0, arena) : 0;
+                dest->abandoned = 0;
+                arena->dest_pool += 1;
+                dest = &dynamic->pools[arena->dest_pool];
+                dest_offset = Bun_Compact_Arena__Object_Offset(dest, 0, arena);
+            }
+            /*the move may overlap the header*/
+            arena->slots[header->slot].ptr = dest->buffer + dest_offset + header_size;
+            if (dest->buffer + dest_offset != (Bun_Byte *)header)
+                memmove(dest->buffer + dest_offset, header, extent);
+            arena->dest_offset = dest_offset + extent;
+        }
+
+        if (deadline
+        &&  ++count % BUN_COMPACT_ARENA__CLOCK_INTERVAL == 0
+        &&  Bun_Compact_Arena__Now_Ns() >= deadline
+        ) return false;
+    }
+
+    Bun_Compact_Arena__Finish(arena);
+    return true;
+}
+
+void Bun_Compact_Arena_Compact(Bun_Compact_Arena *arena)
+{
+    Bun_Compact_Arena_Compact_Step(arena, 0);
+}
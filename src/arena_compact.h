@@ -0,0 +1,110 @@
+/*
+Compacting arena, objects are reached through generational handles instead
+of pointers so they can be moved.
+
+Objects live in the pools of a dynamic arena behind a small header naming
+their handle slot. Freeing an object only marks it dead, compacting slides
+the live objects of every pool down over the dead ones and the gaps left by
+resizes, updates the handle table and gives the emptied pools back.
+Compaction runs as one full pass or incrementally, a step at a time within a
+time budget, allocating and freeing are fine in between steps.
+
+Handles of freed objects go stale (the slot generation moves on), Get
+returns NULL for them instead of another objects memory.
+NOTE: pointers from Bun_Compact_Arena_Get are only valid until the next
+      compaction step.
+*/
+typedef struct
+{
+    Bun_U32 index;
+    Bun_U32 generation; /*0 is never a live generation, a zero handle is the null handle*/
+} Bun_Compact_Handle;
+
+typedef struct
+{
+    void *ptr;          /*the object, NULL while the slot is free*/
+    Bun_U32 generation;
+    Bun_U32 next_free;
+} Bun_Compact_Arena_Slot;
+
+typedef struct
+{
+    Bun_Dynamic_Arena arena; /*holds the objects, do not allocate from it directly*/
+    Bun_U32 alignment;       /*of every object*/
+
+    Bun_Compact_Arena_Slot *slots;
+    Bun_U32 slot_len;
+    Bun_U32 slot_capacity;
+    Bun_U32 free_slot;       /*head of the free slot list, (Bun_U32)-1 when empty*/
+
+    Bun_U64 dead;            /*bytes of dead objects still in the pools*/
+
+    /*progress of an unfinished incremental compaction*/
+    bool compacting;
+    Bun_U32 source_pool;
+    Bun_U32 source_offset;
+    Bun_U32 dest_pool;
+    Bun_U32 dest_offset;
+} Bun_Compact_Arena;
+
+/*
+ARGS:
+    arena             - uninitialised compact arena.
+    backing_allocator - allocator used to allocate pools and the handle table.
+    pool_size         - minimum size in bytes of each backing pool.
+    alignment         - alignment of every object.
+RETURN:
+    true on success, false on failure
+*/
+bool Bun_Compact_Arena_Init(Bun_Compact_Arena *arena, Bun_Allocator *backing_allocator, Bun_U32 pool_size, Bun_U32 alignment);
+void Bun_Compact_Arena_Deinit(Bun_Compact_Arena *arena);
+/*
+ARGS:
+    size   - size of the object in bytes
+    zeroed - wether to initialise memory to zero
+    arena  - an initialised compact arena
+RETURN:
+    handle of the new object, or the null handle on failure
+*/
+Bun_Compact_Handle Bun_Compact_Arena_Alloc(Bun_U32 size, bool zeroed, Bun_Compact_Arena *arena);
+/*
+Resize an object, the handle stays the same.
+RETURN:
+    true on success, false on failure (the object is left as it was)
+*/
+bool Bun_Compact_Arena_Resize(Bun_Compact_Handle handle, Bun_U32 size, bool zeroed, Bun_Compact_Arena *arena);
+/*
+Free an object, its memory is reclaimed by the next compaction.
+*/
+void Bun_Compact_Arena_Free(Bun_Compact_Handle handle, Bun_Compact_Arena *arena);
+/*
+RETURN:
+    pointer to the object, or NULL if handle is null or stale
+*/
+void *Bun_Compact_Arena_Get(Bun_Compact_Arena *arena, Bun_Compact_Handle handle);
+/*
+Compact the whole arena, finishing an unfinished incremental compaction first.
+*/
+void Bun_Compact_Arena_Compact(Bun_Compact_Arena *arena);
+/*
+Compact for about *budget_ns* nanoseconds, continuing where the last step stopped.
+ARGS:
+    budget_ns - time budget of this step, 0 for no limit
+RETURN:
+    true when the compaction finished, false when it needs more steps
+*/
+bool Bun_Compact_Arena_Compact_Step(Bun_Compact_Arena *arena, Bun_U64 budget_ns);
+
+#ifdef BUN_STRIP_PREFIX
+#    define Compact_Handle Bun_Compact_Handle
+#    define Compact_Arena_Slot Bun_Compact_Arena_Slot
+#    define Compact_Arena Bun_Compact_Arena
+#    define Compact_Arena_Init Bun_Compact_Arena_Init
+#    define Compact_Arena_Deinit Bun_Compact_Arena_Deinit
+#    define Compact_Arena_Alloc Bun_Compact_Arena_Alloc
+#    define Compact_Arena_Resize Bun_Compact_Arena_Resize
+#    define Compact_Arena_Free Bun_Compact_Arena_Free
+#    define Compact_Arena_Get Bun_Compact_Arena_Get
+#    define Compact_Arena_Compact Bun_Compact_Arena_Compact
+#    define Compact_Arena_Compact_Step Bun_Compact_Arena_Compact_Step
+#endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,182 @@
+#if defined(__unix__) || defined(__APPLE__)
+#    define BUN_FILE_ARENA__MMAP
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+/*header padded to a cache line, the arena buffer starts right after*/
+#define BUN_FILE_ARENA__HEADER_SIZE 64
+
+/*
+FNV-1a over 8 byte words, used to catch truncated or half written files.
+*/
+static Bun_U64 Bun_File_Arena__Checksum(const Bun_Byte *data, Bun_U64 size)
+{
+    Bun_U64 hash = 0xcbf29ce484222325ull;
+    Bun_U64 word;
+
+    while (size >= sizeof(word))
+    {
+        memcpy(&word, data, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ull;
+        data += sizeof(word);
+        size -= sizeof(word);
+    }
+    while (size--)
+        hash = (hash ^ *data++) * 0x100000001b3ull;
+    return hash;
+}
+
+#ifdef BUN_FILE_ARENA__MMAP
+/*
+mmap that either lands on *base* or fails when fixed is set.
+*/
+static void *Bun_File_Arena__Map(void *base, uintptr_t size, int prot, int flags, int fd, bool fixed)
+{
+    void *map;
+#if defined(MAP_FIXED_NOREPLACE)
+    if (base != NULL && fixed) flags |= MAP_FIXED_NOREPLACE;
+#endif
+    map = mmap(base, size, prot, flags, fd, 0);
+    if (map == MAP_FAILED) return NULL;
+    /*older kernels treat MAP_FIXED_NOREPLACE as a hint*/
+    if (base != NULL && fixed && map != base)
+    {
+        munmap(map, size);
+        return NULL;
+    }
+    return map;
+}
+
+static void Bun_File_Arena__Set_Arena(Bun_File_Arena *file_arena, Bun_USize buffer_size, Bun_USize offset)
+{
+    memset(&file_arena->arena, 0, sizeof(file_arena->arena));
+    file_arena->arena.buffer      = (Bun_Byte *)file_arena->map + file_arena->header->header_size;
+    file_arena->arena.buffer_size = buffer_size;
+    file_arena->arena.offset      = offset;
+}
+#endif /*ifdef BUN_FILE_ARENA__MMAP*/
+
+bool Bun_File_Arena_Create(Bun_File_Arena *file_arena, const char *path, Bun_USize capacity, void *base)
+{
+#ifdef BUN_FILE_ARENA__MMAP
+    Bun_File_Arena_Header *header;
+
+    memset(file_arena, 0, sizeof(*file_arena));
+    if (capacity > BUN_USIZE_MAX - BUN_FILE_ARENA__HEADER_SIZE) return false;
+    file_arena->map_size = BUN_FILE_ARENA__HEADER_SIZE + capacity;
+
+    file_arena->fd = open(path, O_RDWR|O_CREAT|O_TRUNC, 0644);
+    if (file_arena->fd < 0) return false;
+    if (ftruncate(file_arena->fd, (off_t)file_arena->map_size) != 0) goto Error_Exit;
+
+    file_arena->map = Bun_File_Arena__Map(base, file_arena->map_size, PROT_READ|PROT_WRITE, MAP_SHARED, file_arena->fd, true);
+    if (file_arena->map == NULL) goto Error_Exit;
+
+    header = file_arena->header = file_arena->map;
+    header->magic       = BUN_FILE_ARENA_MAGIC;
+    header->version     = BUN_FILE_ARENA_VERSION;
+    header->header_size = BUN_FILE_ARENA__HEADER_SIZE;
+    header->capacity    = capacity;
+    header->offset      = 0;
+    header->checksum    = Bun_File_Arena__Checksum(NULL, 0);
+    header->base        = (Bun_U64)(uintptr_t)file_arena->map;
+
+    Bun_File_Arena__Set_Arena(file_arena, capacity, 0);
+    return true;
+
+Error_Exit:
+    close(file_arena->fd);
+    memset(file_arena, 0, sizeof(*file_arena));
+    return false;
+#else
+    (void)path; (void)capacity; (void)base;
+    memset(file_arena, 0, sizeof(*file_arena));
+    return false;
+#endif
+}
+
+bool Bun_File_Arena_Commit(Bun_File_Arena *file_arena)
+{
+#ifdef BUN_FILE_ARENA__MMAP
+    Bun_File_Arena_Header *header = file_arena->header;
+
+    if (header == NULL
+    || file_arena->flags & (BUN_FILE_ARENA_OPEN_READ_ONLY|BUN_FILE_ARENA_OPEN_COPY_ON_WRITE)
+    ) return false;
+
+    header->offset   = file_arena->arena.offset;
+    header->checksum = Bun_File_Arena__Checksum(file_arena->arena.buffer, header->offset);
+    return msync(file_arena->map, header->header_size + header->offset, MS_SYNC) == 0;
+#else
+    (void)file_arena;
+    return false;
+#endif
+}
+
+bool Bun_File_Arena_Open(Bun_File_Arena *file_arena, const char *path, Bun_File_Arena_Flags flags)
+{
+#ifdef BUN_FILE_ARENA__MMAP
+    Bun_File_Arena_Header header;
+    struct stat file_stat;
+    bool read_only = flags & BUN_FILE_ARENA_OPEN_READ_ONLY;
+    int prot;
+
+    memset(file_arena, 0, sizeof(*file_arena));
+    if (!(flags & (BUN_FILE_ARENA_OPEN_READ_ONLY|BUN_FILE_ARENA_OPEN_COPY_ON_WRITE))) return false;
+
+    file_arena->fd = open(path, O_RDONLY);
+    if (file_arena->fd < 0) return false;
+
+    if (pread(file_arena->fd, &header, sizeof(header), 0) != (long)sizeof(header)
+    ||  fstat(file_arena->fd, &file_stat) != 0
+    ||  header.magic != BUN_FILE_ARENA_MAGIC
+    ||  header.version != BUN_FILE_ARENA_VERSION
+    ||  header.header_size < sizeof(header)
+    ||  header.capacity > BUN_USIZE_MAX - header.header_size
+    ||  header.offset > header.capacity
+    ||  (Bun_U64)file_stat.st_size < header.header_size + header.capacity
+    ) goto Error_Exit;
+
+    file_arena->flags = flags;
+    file_arena->map_size = header.header_size + header.capacity;
+    prot = (read_only) ? PROT_READ : PROT_READ|PROT_WRITE;
+    file_arena->map = Bun_File_Arena__Map( (flags & BUN_FILE_ARENA_OPEN_FIXED_BASE) ? (void *)(uintptr_t)header.base : NULL,
+                                           file_arena->map_size, prot, MAP_PRIVATE, file_arena->fd,
+                                           flags & BUN_FILE_ARENA_OPEN_FIXED_BASE );
+    if (file_arena->map == NULL) goto Error_Exit;
+    file_arena->header = file_arena->map;
+
+    /*read only arenas are full, so allocating fails instead of faulting*/
+    Bun_File_Arena__Set_Arena(file_arena, (Bun_USize)((read_only) ? header.offset : header.capacity), (Bun_USize)header.offset);
+
+    if (flags & BUN_FILE_ARENA_OPEN_VERIFY
+    &&  Bun_File_Arena__Checksum(file_arena->arena.buffer, header.offset) != header.checksum
+    )
+    {
+        munmap(file_arena->map, file_arena->map_size);
+        goto Error_Exit;
+    }
+    return true;
+
+Error_Exit:
+    close(file_arena->fd);
+    memset(file_arena, 0, sizeof(*file_arena));
+    return false;
+#else
+    (void)path; (void)flags;
+    memset(file_arena, 0, sizeof(*file_arena));
+    return false;
+#endif
+}
+
+void Bun_File_Arena_Close(Bun_File_Arena *file_arena)
+{
+#ifdef BUN_FILE_ARENA__MMAP
+    if (file_arena->map != NULL) munmap(file_arena->map, file_arena->map_size);
+    if (file_arena->header != NULL) close(file_arena->fd);
+#endif
+    memset(file_arena, 0, sizeof(*file_arena));
+}
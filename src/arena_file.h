@@ -0,0 +1,99 @@
+/*
+File backed arena, built once and mapped back in by later processes.
+
+The file starts with a header recording the arena offset, a format version,
+a checksum of the used bytes and the address the arena was built at,
+followed by the arena buffer. Opening maps the file read only or copy on
+write, so startup costs an mmap instead of rebuilding the data.
+
+Pointers stored in the arena are only valid if the file is mapped back at the
+address it was built at (BUN_FILE_ARENA_OPEN_FIXED_BASE), otherwise store
+Bun_Rel32/Bun_Off32 offset pointers instead (see offset_ptr.h).
+The first allocation of a fresh file arena is at the start of arena.buffer,
+a natural place for the root of the data.
+*/
+#define BUN_FILE_ARENA_MAGIC   0x414e455241465542ull /*"BUFARENA"*/
+#define BUN_FILE_ARENA_VERSION 1
+
+typedef struct
+{
+    Bun_U64 magic;
+    Bun_U32 version;
+    Bun_U32 header_size; /*bytes before the arena buffer*/
+    Bun_U64 capacity;    /*size in bytes of the arena buffer*/
+    Bun_U64 offset;      /*arena offset at the last commit*/
+    Bun_U64 checksum;    /*of the first *offset* bytes of the arena buffer*/
+    Bun_U64 base;        /*address of the mapping the arena was built in*/
+} Bun_File_Arena_Header;
+
+typedef Bun_U8 Bun_File_Arena_Flags;
+enum
+{
+    BUN_FILE_ARENA_OPEN_READ_ONLY     = (1<<0), /*map read only, no allocations*/
+    BUN_FILE_ARENA_OPEN_COPY_ON_WRITE = (1<<1), /*map private, changes are never written back*/
+    BUN_FILE_ARENA_OPEN_FIXED_BASE    = (1<<2), /*map at the recorded base or fail*/
+    BUN_FILE_ARENA_OPEN_VERIFY        = (1<<3), /*check the checksum, touches every used page*/
+};
+
+typedef struct
+{
+    Bun_Arena arena; /*use with the Bun_Arena_* functions*/
+    Bun_File_Arena_Header *header;
+    void *map;
+    uintptr_t map_size;
+    int fd;
+    Bun_File_Arena_Flags flags;
+} Bun_File_Arena;
+
+/*
+Create (or truncate) a file arena to build into, mapped shared read write.
+
+ARGS:
+    file_arena - uninitialised file arena.
+    path       - path of the file.
+    capacity   - size in bytes of the arena buffer.
+    base       - address to build the arena at, or NULL to let the os pick.
+RETURN:
+    true on success, false on failure
+*/
+bool Bun_File_Arena_Create(Bun_File_Arena *file_arena, const char *path, Bun_USize capacity, void *base);
+/*
+Record the arena offset and checksum in the header and flush the mapping to the file.
+Only valid on arenas from Bun_File_Arena_Create.
+
+RETURN:
+    true on success, false on failure
+*/
+bool Bun_File_Arena_Commit(Bun_File_Arena *file_arena);
+/*
+Map an existing file arena.
+
+ARGS:
+    file_arena - uninitialised file arena.
+    path       - path of the file.
+    flags      - BUN_FILE_ARENA_OPEN_* flags, READ_ONLY or COPY_ON_WRITE is required.
+RETURN:
+    true on success, false if the file can not be mapped or is not a valid file arena
+*/
+bool Bun_File_Arena_Open(Bun_File_Arena *file_arena, const char *path, Bun_File_Arena_Flags flags);
+/*
+Unmap the arena and close the file, uncommitted changes of created arenas
+are still written to the file by the os but not recorded in the header.
+*/
+void Bun_File_Arena_Close(Bun_File_Arena *file_arena);
+
+#ifdef BUN_STRIP_PREFIX
+#    define FILE_ARENA_MAGIC BUN_FILE_ARENA_MAGIC
+#    define FILE_ARENA_VERSION BUN_FILE_ARENA_VERSION
+#    define File_Arena_Header Bun_File_Arena_Header
+#    define File_Arena_Flags Bun_File_Arena_Flags
+#        define FILE_ARENA_OPEN_READ_ONLY BUN_FILE_ARENA_OPEN_READ_ONLY
+#        define FILE_ARENA_OPEN_COPY_ON_WRITE BUN_FILE_ARENA_OPEN_COPY_ON_WRITE
+#        define FILE_ARENA_OPEN_FIXED_BASE BUN_FILE_ARENA_OPEN_FIXED_BASE
+#        define FILE_ARENA_OPEN_VERIFY BUN_FILE_ARENA_OPEN_VERIFY
+#    define File_Arena Bun_File_Arena
+#    define File_Arena_Create Bun_File_Arena_Create
+#    define File_Arena_Commit Bun_File_Arena_Commit
+#    define File_Arena_Open Bun_File_Arena_Open
+#    define File_Arena_Close Bun_File_Arena_Close
+#endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,269 @@
+#if defined(__unix__) || defined(__APPLE__)
+#    define BUN_SHARED_ARENA__MMAP
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <sys/socket.h>
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+/*header padded to a cache line so the offset does not share it with data*/
+#define BUN_SHARED_ARENA__HEADER_SIZE 64
+
+/*
+Anonymous shared memory fd, a memfd where there is one otherwise an shm
+object that is unlinked right away.
+*/
+int Bun_Shared_Arena__Anonymous_Fd(void)
+{
+#if defined(BUN_SHARED_ARENA__MMAP) && defined(__linux__) && defined(MFD_CLOEXEC)
+    return memfd_create("bun_shared_arena", MFD_CLOEXEC);
+#elif defined(BUN_SHARED_ARENA__MMAP)
+    char name[64] = "/bun_shared_arena_";
+    Bun_String_Buffer buffer = Bun_String_Buffer_From(name, sizeof(name));
+    static Bun_U32 counter;
+    int fd;
+
+    buffer.len = strlen(name);
+    Bun_String_Buffer_Append_U64(&buffer, (Bun_U64)getpid());
+    Bun_String_Buffer_Append(&buffer, "_");
+    Bun_String_Buffer_Append_U64(&buffer, (Bun_U64)BUN_ATOMIC_ADD(&counter, 1));
+    fd = shm_open(name, O_RDWR|O_CREAT|O_EXCL, 0600);
+    if (fd >= 0) shm_unlink(name);
+    return fd;
+#else
+    return -1;
+#endif
+}
+
+bool Bun_Shared_Arena_Create(Bun_Shared_Arena *shared, const char *name, Bun_USize capacity)
+{
+#ifdef BUN_SHARED_ARENA__MMAP
+    Bun_Shared_Arena_Header *header;
+    void *map;
+
+    memset(shared, 0, sizeof(*shared));
+    if (capacity > BUN_USIZE_MAX - BUN_SHARED_ARENA__HEADER_SIZE) return false;
+    shared->map_size = BUN_SHARED_ARENA__HEADER_SIZE + capacity;
+
+    shared->fd = (name != NULL) ? shm_open(name, O_RDWR|O_CREAT|O_EXCL, 0600) : Bun_Shared_Arena__Anonymous_Fd();
+    if (shared->fd < 0) return false;
+    if (ftruncate(shared->fd, (off_t)shared->map_size) != 0) goto Error_Exit;
+
+    map = mmap(NULL, shared->map_size, PROT_READ|PROT_WRITE, MAP_SHARED, shared->fd, 0);
+    if (map == MAP_FAILED) goto Error_Exit;
+
+    /*fresh memory is zero, so other processes see magic last and a complete header*/
+    header = shared->header = map;
+    header->version     = BUN_SHARED_ARENA_VERSION;
+    header->header_size = BUN_SHARED_ARENA__HEADER_SIZE;
+    header->capacity    = capacity;
+    BUN_ATOMIC_STORE_RELAXED(&header->offset, 0);
+    BUN_ATOMIC_STORE(&header->magic, BUN_SHARED_ARENA_MAGIC);
+
+    shared->buffer   = (Bun_Byte *)map + BUN_SHARED_ARENA__HEADER_SIZE;
+    shared->capacity = capacity;
+    return true;
+
+Error_Exit:
+    close(shared->fd);
+    if (name != NULL) shm_unlink(name);
+    memset(shared, 0, sizeof(*shared));
+    return false;
+#else
+    (void)name; (void)capacity;
+    memset(shared, 0, sizeof(*shared));
+    return false;
+#endif
+}
+
+bool Bun_Shared_Arena_Open(Bun_Shared_Arena *shared, const char *name)
+{
+#ifdef BUN_SHARED_ARENA__MMAP
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+    {
+        memset(shared, 0, sizeof(*shared));
+        return false;
+    }
+    return Bun_Shared_Arena_Open_Fd(shared, fd);
+#else
+    (void)name;
+    memset(shared, 0, sizeof(*shared));
+    return false;
+#endif
+}
+
+bool Bun_Shared_Arena_Open_Fd(Bun_Shared_Arena *shared, int fd)
+{
+#ifdef BUN_SHARED_ARENA__MMAP
+    Bun_Shared_Arena_Header *header;
+    struct stat file_stat;
+    void *map;
+
+    memset(shared, 0, sizeof(*shared));
+    shared->fd = fd;
+    if (fd < 0) return false;
+
+    if (fstat(fd, &file_stat) != 0
+    ||  (Bun_U64)file_stat.st_size < sizeof(*header)
+    ) goto Error_Exit;
+
+    shared->map_size = (uintptr_t)file_stat.st_size;
+    map = mmap(NULL, shared->map_size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) goto Error_Exit;
+    header = map;
+
+    if (BUN_ATOMIC_LOAD(&header->magic) != BUN_SHARED_ARENA_MAGIC
+    ||  header->version != BUN_SHARED_ARENA_VERSION
+    ||  header->header_size < sizeof(*header)
+    ||  header->capacity > BUN_USIZE_MAX - header->header_size
+    ||  header->header_size + header->capacity > shared->map_size
+    )
+    {
+        munmap(map, shared->map_size);
+        goto Error_Exit;
+    }
+
+    shared->header   = header;
+    shared->buffer   = (Bun_Byte *)map + header->header_size;
+    shared->capacity = (Bun_USize)header->capacity;
+    return true;
+
+Error_Exit:
+    close(fd);
+    memset(shared, 0, sizeof(*shared));
+    return false;
+#else
+    (void)fd;
+    memset(shared, 0, sizeof(*shared));
+    return false;
+#endif
+}
+
+void Bun_Shared_Arena_Close(Bun_Shared_Arena *shared, const char *unlink_name)
+{
+#ifdef BUN_SHARED_ARENA__MMAP
+    if (shared->header != NULL)
+    {
+        munmap(shared->header, shared->map_size);
+        close(shared->fd);
+    }
+    if (unlink_name != NULL) shm_unlink(unlink_name);
+#else
+    (void)unlink_name;
+#endif
+    memset(shared, 0, sizeof(*shared));
+}
+
+void *Bun_Shared_Arena_Alloc(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Shared_Arena *shared)
+{
+    Bun_Shared_Arena_Header *header = shared->header;
+    Bun_U64 offset, start;
+    Bun_Byte *result;
+
+    if (header == NULL || alignment == 0 || (alignment & (alignment - 1)) != 0) return NULL;
+#ifdef BUN_SHARED_ARENA__MMAP
+    /*beyond the page size the mappings of other processes may disagree*/
+    if (alignment > (uintptr_t)sysconf(_SC_PAGESIZE)) return NULL;
+#endif
+
+    /*mappings are page aligned in every process, so aligning addresses here agrees with all of them*/
+    offset = BUN_ATOMIC_LOAD_RELAXED(&header->offset);
+    do
+    {
+        start = Bun_Align_Formula((uintptr_t)shared->buffer + (uintptr_t)offset, alignment);
+        if (start == 0) return NULL;
+        start -= (uintptr_t)shared->buffer;
+        if (start > shared->capacity || size > shared->capacity - start) return NULL;
+    }
+    while (!BUN_ATOMIC_CAS(&header->offset, &offset, start + size));
+
+    result = shared->buffer + start;
+    /*the memory may be reused after Free_All, fresh memory is already zero*/
+    if (zeroed) Bun_Memory_Zero(result, size);
+    return result;
+}
+
+Bun_USize Bun_Shared_Arena_Offset(Bun_Shared_Arena *shared)
+{
+    if (shared->header == NULL) return 0;
+    return (Bun_USize)BUN_ATOMIC_LOAD(&shared->header->offset);
+}
+
+void Bun_Shared_Arena_Free_All(Bun_Shared_Arena *shared)
+{
+    if (shared->header == NULL) return;
+    BUN_ATOMIC_STORE(&shared->header->offset, 0);
+}
+
+bool Bun_Shared_Arena_Send_Fd(int socket, int fd)
+{
+#ifdef BUN_SHARED_ARENA__MMAP
+    struct msghdr message;
+    struct iovec io;
+    struct cmsghdr *control;
+    union
+    {
+        char buffer[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control_buffer;
+    char byte = 0;
+
+    memset(&message, 0, sizeof(message));
+    memset(&control_buffer, 0, sizeof(control_buffer));
+    /*at least one byte of real data has to go along with the fd*/
+    io.iov_base = &byte;
+    io.iov_len  = 1;
+    message.msg_iov        = &io;
+    message.msg_iovlen     = 1;
+    message.msg_control    = control_buffer.buffer;
+    message.msg_controllen = sizeof(control_buffer.buffer);
+
+    control = CMSG_FIRSTHDR(&message);
+    control->cmsg_level = SOL_SOCKET;
+    control->cmsg_type  = SCM_RIGHTS;
+    control->cmsg_len   = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(control), &fd, sizeof(int));
+
+    return sendmsg(socket, &message, 0) == 1;
+#else
+    (void)socket; (void)fd;
+    return false;
+#endif
+}
+
+int Bun_Shared_Arena_Receive_Fd(int socket)
+{
+#ifdef BUN_SHARED_ARENA__MMAP
+    struct msghdr message;
+    struct iovec io;
+    struct cmsghdr *control;
+    union
+    {
+        char buffer[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control_buffer;
+    char byte;
+    int fd = -1;
+
+    memset(&message, 0, sizeof(message));
+    io.iov_base = &byte;
+    io.iov_len  = 1;
+    message.msg_iov        = &io;
+    message.msg_iovlen     = 1;
+    message.msg_control    = control_buffer.buffer;
+    message.msg_controllen = sizeof(control_buffer.buffer);
+
+    if (recvmsg(socket, &message, 0) != 1) return -1;
+    for (control = CMSG_FIRSTHDR(&message); control != NULL; control = CMSG_NXTHDR(&message, control))
+    {
+        if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_RIGHTS)
+            memcpy(&fd, CMSG_DATA(control), sizeof(int));
+    }
+    return fd;
+#else
+    (void)socket;
+    return -1;
+#endif
+}
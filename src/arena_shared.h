@@ -0,0 +1,122 @@
+/*
+Arena in shared memory, for handing data between processes without copying.
+
+The memory is a memfd (or a named posix shm object) mapped by every process
+using the arena. The bump offset lives in a header at the start of the
+memory and is only updated atomically, so any process can allocate while
+others read what was already written, in place. This is why it is not a plain
+Bun_Arena, whose offset is private to each process.
+Processes map the memory at different addresses, link data with Bun_Off32
+offsets relative to *buffer* (see offset_ptr.h) rather than with pointers.
+
+Producer:
+    Bun_Shared_Arena_Create(&shared, NULL, capacity);
+    Bun_Shared_Arena_Send_Fd(socket, shared.fd);
+    result = Bun_Shared_Arena_Alloc(size, false, 16, &shared);
+Consumer:
+    Bun_Shared_Arena_Open_Fd(&shared, Bun_Shared_Arena_Receive_Fd(socket));
+    result = Bun_Off32_Decode(shared.buffer, result_offset);
+*/
+#define BUN_SHARED_ARENA_MAGIC   0x4148535241465542ull /*"BUFARSHA"*/
+#define BUN_SHARED_ARENA_VERSION 1
+
+typedef struct
+{
+    Bun_U64 magic;
+    Bun_U32 version;
+    Bun_U32 header_size; /*bytes before the arena buffer*/
+    Bun_U64 capacity;    /*size in bytes of the arena buffer*/
+    Bun_U64 offset;      /*bump offset, only ever accessed atomically*/
+} Bun_Shared_Arena_Header;
+
+typedef struct
+{
+    Bun_Shared_Arena_Header *header;
+    Bun_Byte *buffer; /*the shared arena buffer as mapped in this process*/
+    Bun_USize capacity;
+    int fd;
+    uintptr_t map_size;
+} Bun_Shared_Arena;
+
+/*
+Create a shared arena.
+
+ARGS:
+    shared   - uninitialised shared arena.
+    name     - posix shm name ("/name") other processes can open, or NULL for
+               an anonymous memfd that is handed over with Bun_Shared_Arena_Send_Fd.
+    capacity - size in bytes of the arena buffer.
+RETURN:
+    true on success, false on failure
+*/
+bool Bun_Shared_Arena_Create(Bun_Shared_Arena *shared, const char *name, Bun_USize capacity);
+/*
+Map a shared arena created by another process by its shm name.
+*/
+bool Bun_Shared_Arena_Open(Bun_Shared_Arena *shared, const char *name);
+/*
+Map a shared arena from a file descriptor, the shared arena takes ownership of fd.
+*/
+bool Bun_Shared_Arena_Open_Fd(Bun_Shared_Arena *shared, int fd);
+/*
+Unmap the arena and close its fd, the memory lives on while other processes map it.
+ARGS:
+    unlink_name - shm name to remove, or NULL to keep it (memfds have none)
+*/
+void Bun_Shared_Arena_Close(Bun_Shared_Arena *shared, const char *unlink_name);
+/*
+Allocate from the shared arena, safe to call from any thread of any process mapping it.
+
+ARGS:
+    size      - size of allocation in bytes
+    zeroed    - wether to initialise memory to zero
+    alignment - alignment of allocation, at most the page size
+    shared    - an initialised shared arena
+RETURN:
+    Pointer to allocated memory or NULL on failure
+*/
+void *Bun_Shared_Arena_Alloc(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Shared_Arena *shared);
+/*
+RETURN:
+    bytes allocated so far by all processes
+*/
+Bun_USize Bun_Shared_Arena_Offset(Bun_Shared_Arena *shared);
+/*
+Free every allocation, nobody may be reading the arena anymore.
+*/
+void Bun_Shared_Arena_Free_All(Bun_Shared_Arena *shared);
+/*
+Pass a file descriptor to another process over a unix domain socket (SCM_RIGHTS).
+RETURN:
+    true on success, false on failure
+*/
+bool Bun_Shared_Arena_Send_Fd(int socket, int fd);
+/*
+Receive a file descriptor sent with Bun_Shared_Arena_Send_Fd.
+RETURN:
+    the received fd, or -1 on failure
+*/
+int Bun_Shared_Arena_Receive_Fd(int socket);
+
+/*
+Internal, also used by the snapshot arena.
+RETURN:
+    a new anonymous shared memory fd, or -1 on failure or where there is none
+*/
+int Bun_Shared_Arena__Anonymous_Fd(void);
+
+#ifdef BUN_STRIP_PREFIX
+#    define SHARED_ARENA_MAGIC BUN_SHARED_ARENA_MAGIC
+#    define SHARED_ARENA_VERSION BUN_SHARED_ARENA_VERSION
+#    define Shared_Arena_Header Bun_Shared_Arena_Header
+#    define Shared_Arena Bun_Shared_Arena
+#    define Shared_Arena_Create Bun_Shared_Arena_Create
+#    define Shared_Arena_Open Bun_Shared_Arena_Open
+#    define Shared_Arena_Open_Fd Bun_Shared_Arena_Open_Fd
+#    define Shared_Arena_Close Bun_Shared_Arena_Close
+#    define Shared_Arena_Alloc Bun_Shared_Arena_Alloc
+#    define Shared_Arena_Offset Bun_Shared_Arena_Offset
+#    define Shared_Arena_Free_All Bun_Shared_Arena_Free_All
+#    define Shared_Arena_Send_Fd Bun_Shared_Arena_Send_Fd
+#    define Shared_Arena_Receive_Fd Bun_Shared_Arena_Receive_Fd
+#endif /*ifdef BUN_STRIP_PREFIX*/
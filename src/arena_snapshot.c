@@ -0,0 +1,171 @@
+#if defined(__unix__) || defined(__APPLE__)
+#    define BUN_SNAPSHOT_ARENA__MMAP
+#    include <sys/mman.h>
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+#ifdef BUN_SNAPSHOT_ARENA__MMAP
+/*
+Remap the arena buffer in place, shared to write through to the memfd or private to copy on write.
+*/
+static bool Bun_Snapshot_Arena__Remap(Bun_Snapshot_Arena *snapshot_arena, int flags)
+{
+    void *map = mmap(snapshot_arena->map, snapshot_arena->map_size, PROT_READ|PROT_WRITE, flags|MAP_FIXED, snapshot_arena->fd, 0);
+    return map == snapshot_arena->map;
+}
+
+#if defined(__linux__)
+/*pagemap entry bits, see the kernel's Documentation/admin-guide/mm/pagemap.rst*/
+#define BUN_SNAPSHOT_ARENA__PAGE_PRESENT   (1ull<<63)
+#define BUN_SNAPSHOT_ARENA__PAGE_SWAPPED   (1ull<<62)
+#define BUN_SNAPSHOT_ARENA__PAGE_FILE      (1ull<<61)
+#define BUN_SNAPSHOT_ARENA__PAGEMAP_BATCH  512
+
+/*
+Write the pages copied since the snapshot back to the memfd, a page is
+copied when it is mapped but no longer backed by the file.
+RETURN:
+    true on success, false if pagemap can not be read
+*/
+static bool Bun_Snapshot_Arena__Commit_Copied(Bun_Snapshot_Arena *snapshot_arena, uintptr_t size)
+{
+    Bun_U64 entries[BUN_SNAPSHOT_ARENA__PAGEMAP_BATCH];
+    uintptr_t page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t first = (uintptr_t)snapshot_arena->map / page_size;
+    uintptr_t pages = (size + page_size - 1) / page_size;
+    uintptr_t page, i;
+    int pagemap;
+    bool result = true;
+
+    pagemap = open("/proc/self/pagemap", O_RDONLY);
+    if (pagemap < 0) return false;
+
+    for (page = 0; page < pages && result; page += BUN_SNAPSHOT_ARENA__PAGEMAP_BATCH)
+    {
+        uintptr_t count = pages - page;
+        if (count > BUN_SNAPSHOT_ARENA__PAGEMAP_BATCH) count = BUN_SNAPSHOT_ARENA__PAGEMAP_BATCH;
+
+        if (pread(pagemap, entries, count*sizeof(Bun_U64), (off_t)((first + page)*sizeof(Bun_U64))) != (long)(count*sizeof(Bun_U64)))
+        {
+            result = false;
+            break;
+        }
+        for (i = 0; i < count; i++)
+        {
+            uintptr_t offset = (page + i)*page_size;
+            if (!(entries[i] & (BUN_SNAPSHOT_ARENA__PAGE_PRESENT|BUN_SNAPSHOT_ARENA__PAGE_SWAPPED))
+            ||  entries[i] & BUN_SNAPSHOT_ARENA__PAGE_FILE
+            ) continue;
+            if (pwrite(snapshot_arena->fd, (Bun_Byte *)snapshot_arena->map + offset, page_size, (off_t)offset) != (long)page_size)
+            {
+                result = false;
+                break;
+            }
+        }
+    }
+    close(pagemap);
+    return result;
+}
+#endif /*if defined(__linux__)*/
+#endif /*ifdef BUN_SNAPSHOT_ARENA__MMAP*/
+
+bool Bun_Snapshot_Arena_Init(Bun_Snapshot_Arena *snapshot_arena, Bun_USize capacity)
+{
+#ifdef BUN_SNAPSHOT_ARENA__MMAP
+    uintptr_t page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+    void *map;
+
+    memset(snapshot_arena, 0, sizeof(*snapshot_arena));
+    snapshot_arena->map_size = Bun_Align_Formula(capacity, (Bun_U32)page_size);
+    if (snapshot_arena->map_size == 0) return false;
+
+    snapshot_arena->fd = Bun_Shared_Arena__Anonymous_Fd();
+    if (snapshot_arena->fd < 0) return false;
+    if (ftruncate(snapshot_arena->fd, (off_t)snapshot_arena->map_size) != 0) goto Error_Exit;
+
+    map = mmap(NULL, snapshot_arena->map_size, PROT_READ|PROT_WRITE, MAP_SHARED, snapshot_arena->fd, 0);
+    if (map == MAP_FAILED) goto Error_Exit;
+
+    snapshot_arena->map = map;
+    snapshot_arena->arena.buffer      = map;
+    snapshot_arena->arena.buffer_size = snapshot_arena->map_size;
+    return true;
+
+Error_Exit:
+    close(snapshot_arena->fd);
+    memset(snapshot_arena, 0, sizeof(*snapshot_arena));
+    return false;
+#else
+    (void)capacity;
+    memset(snapshot_arena, 0, sizeof(*snapshot_arena));
+    return false;
+#endif
+}
+
+void Bun_Snapshot_Arena_Deinit(Bun_Snapshot_Arena *snapshot_arena)
+{
+#ifdef BUN_SNAPSHOT_ARENA__MMAP
+    if (snapshot_arena->map != NULL)
+    {
+        munmap(snapshot_arena->map, snapshot_arena->map_size);
+        close(snapshot_arena->fd);
+    }
+#endif
+    memset(snapshot_arena, 0, sizeof(*snapshot_arena));
+}
+
+bool Bun_Snapshot_Arena_Snapshot(Bun_Snapshot_Arena *snapshot_arena)
+{
+#ifdef BUN_SNAPSHOT_ARENA__MMAP
+    if (snapshot_arena->map == NULL || snapshot_arena->active) return false;
+    if (!Bun_Snapshot_Arena__Remap(snapshot_arena, MAP_PRIVATE)) return false;
+    snapshot_arena->saved  = snapshot_arena->arena;
+    snapshot_arena->active = true;
+    return true;
+#else
+    (void)snapshot_arena;
+    return false;
+#endif
+}
+
+bool Bun_Snapshot_Arena_Rollback(Bun_Snapshot_Arena *snapshot_arena)
+{
+#ifdef BUN_SNAPSHOT_ARENA__MMAP
+    if (!snapshot_arena->active) return false;
+    if (!Bun_Snapshot_Arena__Remap(snapshot_arena, MAP_SHARED)) return false;
+    snapshot_arena->arena  = snapshot_arena->saved;
+    snapshot_arena->active = false;
+    return true;
+#else
+    (void)snapshot_arena;
+    return false;
+#endif
+}
+
+bool Bun_Snapshot_Arena_Commit(Bun_Snapshot_Arena *snapshot_arena)
+{
+#ifdef BUN_SNAPSHOT_ARENA__MMAP
+    uintptr_t used;
+
+    if (!snapshot_arena->active) return false;
+
+    /*pages past both offsets hold nothing anyone may read*/
+    used = snapshot_arena->arena.offset;
+    if (snapshot_arena->saved.offset > used) used = snapshot_arena->saved.offset;
+
+#if defined(__linux__)
+    if (!Bun_Snapshot_Arena__Commit_Copied(snapshot_arena, used))
+#endif
+    {
+        if (used && pwrite(snapshot_arena->fd, snapshot_arena->map, used, 0) != (long)used) return false;
+    }
+
+    if (!Bun_Snapshot_Arena__Remap(snapshot_arena, MAP_SHARED)) return false;
+    snapshot_arena->active = false;
+    return true;
+#else
+    (void)snapshot_arena;
+    return false;
+#endif
+}
@@ -0,0 +1,64 @@
+/*
+Arena with copy on write snapshots, for speculative work that is usually thrown away.
+
+The arena buffer is a memfd mapped shared. Taking a snapshot remaps it
+private at the same address, an O(1) operation after which the memfd holds
+the snapshot and every page written is copied by the kernel on first touch.
+Rolling back remaps the memfd shared again, dropping the copied pages, so it
+costs the pages touched instead of the arena size. Committing writes the
+copied pages back to the memfd (found through /proc/self/pagemap, or the
+whole used range where that is not available) before remapping.
+
+Pointers into the arena stay valid across snapshots, the address never changes.
+
+    Bun_Snapshot_Arena_Snapshot(&snapshot_arena);
+    ... speculative writes and Bun_Arena_* calls on snapshot_arena.arena ...
+    if (good) Bun_Snapshot_Arena_Commit(&snapshot_arena);
+    else      Bun_Snapshot_Arena_Rollback(&snapshot_arena);
+*/
+typedef struct
+{
+    Bun_Arena arena;  /*use with the Bun_Arena_* functions*/
+    Bun_Arena saved;  /*arena at the time of the snapshot*/
+    void *map;
+    uintptr_t map_size;
+    int fd;
+    bool active;      /*a snapshot is taken*/
+} Bun_Snapshot_Arena;
+
+/*
+ARGS:
+    snapshot_arena - uninitialised snapshot arena.
+    capacity       - size in bytes of the arena buffer, rounded up to whole pages.
+RETURN:
+    true on success, false on failure
+*/
+bool Bun_Snapshot_Arena_Init(Bun_Snapshot_Arena *snapshot_arena, Bun_USize capacity);
+void Bun_Snapshot_Arena_Deinit(Bun_Snapshot_Arena *snapshot_arena);
+/*
+Take a snapshot of the arena contents and offset.
+RETURN:
+    true on success, false on failure or if a snapshot is already taken
+*/
+bool Bun_Snapshot_Arena_Snapshot(Bun_Snapshot_Arena *snapshot_arena);
+/*
+Restore the arena to the snapshot and drop it.
+RETURN:
+    true on success, false on failure or if no snapshot is taken
+*/
+bool Bun_Snapshot_Arena_Rollback(Bun_Snapshot_Arena *snapshot_arena);
+/*
+Keep every change since the snapshot and drop it.
+RETURN:
+    true on success, false on failure or if no snapshot is taken
+*/
+bool Bun_Snapshot_Arena_Commit(Bun_Snapshot_Arena *snapshot_arena);
+
+#ifdef BUN_STRIP_PREFIX
+#    define Snapshot_Arena Bun_Snapshot_Arena
+#    define Snapshot_Arena_Init Bun_Snapshot_Arena_Init
+#    define Snapshot_Arena_Deinit Bun_Snapshot_Arena_Deinit
+#    define Snapshot_Arena_Snapshot Bun_Snapshot_Arena_Snapshot
+#    define Snapshot_Arena_Rollback Bun_Snapshot_Arena_Rollback
+#    define Snapshot_Arena_Commit Bun_Snapshot_Arena_Commit
+#endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,425 @@
+#if defined(__linux__)
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#    include <fcntl.h>
+#endif
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(BUN_NO_THREADS)
+#    define BUN_NUMA__THREADS
+#    include <pthread.h>
+#endif
+
+/*from linux/mempolicy.h, not pulled in to avoid needing kernel headers*/
+#define BUN_NUMA__MPOL_PREFERRED 1
+
+/*stored right before every pointer handed out by the numa allocator*/
+typedef struct
+{
+    void *base;         /*start of the mapping, or of the slot*/
+    uintptr_t map_size; /*size of the mapping, or of the slot*/
+    Bun_USize size;
+    Bun_S32 node;
+    Bun_S32 slot_class; /*size class of a slot carved from a chunk, -1 for a mapping of its own*/
+} Bun_Numa__Header;
+
+/*
+Small blocks are slots carved from per node chunks instead of a mapping
+each, slots of class c are (BUN_NUMA__MIN_SLOT << c) bytes and freed slots
+go on a free list of their node and class. Chunks are kept for the life of
+the process.
+*/
+#define BUN_NUMA__MIN_SLOT   64
+#define BUN_NUMA__SLOT_CLASSES 10 /*64 bytes to 32KB*/
+#define BUN_NUMA__CHUNK_SIZE (1u << 20)
+
+typedef struct Bun_Numa__Slot Bun_Numa__Slot;
+struct Bun_Numa__Slot
+{
+    Bun_Numa__Slot *next;
+};
+
+static struct
+{
+#ifdef BUN_NUMA__THREADS
+    pthread_mutex_t lock;
+#endif
+    Bun_Byte *chunk; /*bump pointer into the newest chunk*/
+    Bun_Byte *chunk_end;
+    Bun_Numa__Slot *free_slots[BUN_NUMA__SLOT_CLASSES];
+} bun_numa_nodes[BUN_NUMA_MAX_NODES];
+
+#if defined(__linux__)
+static Bun_U32 bun_numa_node_count = 0; /*0 until queried*/
+#endif
+static Bun_U32 bun_numa_simulated_node_count = 0;
+static Bun_S32 bun_numa_simulated_node = 0;
+
+static uintptr_t Bun_Numa__Page_Size(void)
+{
+#if defined(__linux__)
+    static uintptr_t page_size = 0;
+    uintptr_t result = BUN_ATOMIC_LOAD_RELAXED(&page_size);
+    if (!result)
+    {
+        result = (uintptr_t)sysconf(_SC_PAGESIZE);
+        BUN_ATOMIC_STORE_RELAXED(&page_size, result);
+    }
+    return result;
+#else
+    return 4096;
+#endif
+}
+
+/*
+the count is cached on first use, threads racing to do so all read the
+same file and store the same value
+*/
+Bun_U32 Bun_Numa_Node_Count(void)
+{
+    Bun_U32 count = 1;
+
+    if (bun_numa_simulated_node_count) return bun_numa_simulated_node_count;
+#if defined(__linux__)
+    count = BUN_ATOMIC_LOAD_RELAXED(&bun_numa_node_count);
+    if (count) return count;
+
+    count = 1;
+    {
+        /* contents look like "0" or "0-1" or "0,2-3", the highest node is all we need*/
+        char buffer[256];
+        int fd, i;
+        long n = 0;
+        Bun_U32 value = 0, highest = 0;
+
+        fd = open("/sys/devices/system/node/online", O_RDONLY);
+        if (fd >= 0)
+        {
+            n = read(fd, buffer, sizeof(buffer)-1);
+            close(fd);
+        }
+        for (i = 0; i < n; i++)
+        {
+            if (buffer[i] >= '0' && buffer[i] <= '9')
+            {
+                value = value*10 + (Bun_U32)(buffer[i] - '0');
+                if (value > highest) highest = value;
+            }
+            else value = 0;
+        }
+        if (n > 0) count = (highest+1 > BUN_NUMA_MAX_NODES) ? BUN_NUMA_MAX_NODES : highest+1;
+    }
+    BUN_ATOMIC_STORE_RELAXED(&bun_numa_node_count, count);
+#endif
+    return count;
+}
+
+Bun_S32 Bun_Numa_Current_Node(void)
+{
+    if (bun_numa_simulated_node_count) return bun_numa_simulated_node;
+    if (Bun_Numa_Node_Count() <= 1) return 0;
+#if defined(__linux__) && defined(SYS_getcpu)
+    {
+        unsigned int cpu = 0, node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) return 0;
+        return (Bun_S32)node;
+    }
+#else
+    return 0;
+#endif
+}
+
+bool Bun_Numa_Bind(void *ptr, uintptr_t size, Bun_S32 node)
+{
+    if (ptr == NULL || size == 0) return false;
+    if (node == BUN_NUMA_NODE_LOCAL) node = Bun_Numa_Current_Node();
+    if (node < 0 || (Bun_U32)node >= Bun_Numa_Node_Count()) return false;
+
+    /*nothing to place on a single node, and nothing is placed while simulating*/
+    if (bun_numa_simulated_node_count || Bun_Numa_Node_Count() <= 1) return true;
+#if defined(__linux__) && defined(SYS_mbind)
+    {
+        uintptr_t page_size = Bun_Numa__Page_Size();
+        uintptr_t start = (uintptr_t)ptr - (uintptr_t)ptr % page_size;
+        uintptr_t end = Bun_Align_Formula((uintptr_t)ptr + size, page_size);
+        unsigned long mask = 1ul << node;
+
+        return syscall(SYS_mbind, start, end - start, BUN_NUMA__MPOL_PREFERRED,
+                       &mask, (unsigned long)(sizeof(mask)*8 + 1), 0) == 0;
+    }
+#else
+    return true;
+#endif
+}
+
+void Bun_Numa_Simulate(Bun_U32 node_count, Bun_S32 current_node)
+{
+    if (node_count > BUN_NUMA_MAX_NODES) node_count = BUN_NUMA_MAX_NODES;
+    bun_numa_simulated_node_count = node_count;
+    bun_numa_simulated_node = (current_node >= 0 && (Bun_U32)current_node < node_count) ? current_node : 0;
+}
+
+static void *Bun_Numa__Map(uintptr_t map_size)
+{
+#if defined(__linux__)
+    void *ptr = mmap(NULL, map_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    return (ptr == MAP_FAILED) ? NULL : ptr;
+#else
+    return calloc(map_size, 1);
+#endif
+}
+static void Bun_Numa__Unmap(void *base, uintptr_t map_size)
+{
+#if defined(__linux__)
+    munmap(base, map_size);
+#else
+    (void)map_size;
+    free(base);
+#endif
+}
+
+#ifdef BUN_NUMA__THREADS
+static void Bun_Numa__Init_Locks(void)
+{
+    Bun_U32 i;
+    for (i = 0; i < BUN_NUMA_MAX_NODES; i++) pthread_mutex_init(&bun_numa_nodes[i].lock, NULL);
+}
+#endif
+
+static void Bun_Numa__Lock(Bun_S32 node)
+{
+#ifdef BUN_NUMA__THREADS
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, &Bun_Numa__Init_Locks);
+    pthread_mutex_lock(&bun_numa_nodes[node].lock);
+#else
+    (void)node;
+#endif
+}
+static void Bun_Numa__Unlock(Bun_S32 node)
+{
+#ifdef BUN_NUMA__THREADS
+    pthread_mutex_unlock(&bun_numa_nodes[node].lock);
+#else
+    (void)node;
+#endif
+}
+
+/*
+Take a slot of *slot_class* on *node*, from its free list or else the chunk.
+ARGS:
+    fresh - set to true when the slot is untouched zero memory.
+RETURN:
+    the slot, or NULL when no chunk can be mapped
+*/
+static Bun_Byte *Bun_Numa__Slot_Alloc(Bun_S32 node, Bun_S32 slot_class, bool *fresh)
+{
+    uintptr_t slot_size = (uintptr_t)BUN_NUMA__MIN_SLOT << slot_class;
+    uintptr_t slot_alignment = (slot_size < Bun_Numa__Page_Size()) ? slot_size : Bun_Numa__Page_Size();
+    Bun_Byte *slot = NULL;
+
+    Bun_Numa__Lock(node);
+    if (bun_numa_nodes[node].free_slots[slot_class] != NULL)
+    {
+        slot = (Bun_Byte *)bun_numa_nodes[node].free_slots[slot_class];
+        bun_numa_nodes[node].free_slots[slot_class] = ((Bun_Numa__Slot *)slot)->next;
+        *fresh = false;
+    }
+    else
+    {
+        slot = (Bun_Byte *)Bun_Align_Formula((uintptr_t)bun_numa_nodes[node].chunk, (Bun_U32)slot_alignment);
+        if (bun_numa_nodes[node].chunk == NULL || slot_size > (uintptr_t)(bun_numa_nodes[node].chunk_end - slot))
+        {
+            /*the rest of the old chunk is left unused, calloc'd chunks are not page aligned*/
+            slot = Bun_Numa__Map(BUN_NUMA__CHUNK_SIZE);
+            if (slot != NULL)
+            {
+                Bun_Numa_Bind(slot, BUN_NUMA__CHUNK_SIZE, node);
+                bun_numa_nodes[node].chunk_end = slot + BUN_NUMA__CHUNK_SIZE;
+                slot = (Bun_Byte *)Bun_Align_Formula((uintptr_t)slot, (Bun_U32)slot_alignment);
+            }
+        }
+        if (slot != NULL) bun_numa_nodes[node].chunk = slot + slot_size;
+        *fresh = true;
+    }
+    Bun_Numa__Unlock(node);
+    return slot;
+}
+
+/*
+Hand out a block placed on *node*, a slot for small blocks and a fresh
+mapping of its own otherwise, with an aligned pointer within it.
+*/
+static void *Bun_Numa__Alloc(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_S32 node)
+{
+    uintptr_t map_size, offset;
+    Bun_Byte *base;
+    Bun_Numa__Header *header;
+    uintptr_t ptr;
+    Bun_S32 slot_class = -1;
+    bool fresh = true;
+
+    if (alignment < BUN_ALLOCATOR_DEFAULT_ALIGN) alignment = BUN_ALLOCATOR_DEFAULT_ALIGN;
+    if (node == BUN_NUMA_NODE_LOCAL) node = Bun_Numa_Current_Node();
+    if (node < 0 || (Bun_U32)node >= Bun_Numa_Node_Count()) node = 0;
+
+    if (size > BUN_USIZE_MAX - sizeof(Bun_Numa__Header) - alignment) return NULL;
+
+    /*slots are aligned to their size up to a page, so the header offset is known up front*/
+    offset = Bun_Align_Formula(sizeof(Bun_Numa__Header), alignment);
+    if (alignment <= Bun_Numa__Page_Size()
+    &&  alignment <= ((uintptr_t)BUN_NUMA__MIN_SLOT << (BUN_NUMA__SLOT_CLASSES-1))
+    &&  size <= ((uintptr_t)BUN_NUMA__MIN_SLOT << (BUN_NUMA__SLOT_CLASSES-1)) - offset
+    )
+    {
+        for (slot_class = 0; ((uintptr_t)BUN_NUMA__MIN_SLOT << slot_class) < offset + size
+                          || ((uintptr_t)BUN_NUMA__MIN_SLOT << slot_class) < alignment; slot_class++);
+        map_size = (uintptr_t)BUN_NUMA__MIN_SLOT << slot_class;
+        base = Bun_Numa__Slot_Alloc(node, slot_class, &fresh);
+    }
+    else
+    {
+        slot_class = -1;
+        map_size = Bun_Align_Formula((uintptr_t)size + sizeof(Bun_Numa__Header) + alignment, Bun_Numa__Page_Size());
+        if (map_size == 0) return NULL;
+        base = Bun_Numa__Map(map_size);
+        /*bind before the first touch, the header write faults in the first page*/
+        if (base != NULL) Bun_Numa_Bind(base, map_size, node);
+    }
+    if (base == NULL) return NULL;
+
+    ptr = Bun_Align_Formula((uintptr_t)base + sizeof(Bun_Numa__Header), alignment);
+    header = (Bun_Numa__Header *)(ptr - sizeof(Bun_Numa__Header));
+    header->base = base;
+    header->map_size = map_size;
+    header->size = size;
+    header->node = node;
+    header->slot_class = slot_class;
+
+    /*fresh pages are always zero, reused slots are not*/
+    if (zeroed && !fresh) memset((void *)ptr, 0, size);
+    return (void *)ptr;
+}
+
+/*unmap a block or put its slot back on the free list*/
+static void Bun_Numa__Release(Bun_Numa__Header *header)
+{
+    Bun_Numa__Slot *slot = header->base;
+    Bun_S32 node = header->node;
+
+    if (header->slot_class < 0)
+    {
+        Bun_Numa__Unmap(header->base, header->map_size);
+        return;
+    }
+    Bun_Numa__Lock(node);
+    slot->next = bun_numa_nodes[node].free_slots[header->slot_class];
+    bun_numa_nodes[node].free_slots[header->slot_class] = slot;
+    Bun_Numa__Unlock(node);
+}
+
+void *Bun_Numa_Allocator_Proc64(void *allocator_data,
+                          Bun_Allocator_Error *allocator_error,
+                          Bun_Allocator_Mode mode,
+                          Bun_USize size,
+                          Bun_U32 alignment,
+                          void *old_memory,
+                          Bun_USize old_size
+                          )
+{
+    Bun_Numa_Allocator *numa = *(Bun_Numa_Allocator **)allocator_data;
+    Bun_Numa__Header *header;
+    void *ptr;
+    (void)old_size; /*the header knows better*/
+
+    switch (mode)
+    {
+        case BUN_ALLOCATOR_MODE_ALLOC:
+        case BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED:
+            ptr = Bun_Numa__Alloc(size, mode == BUN_ALLOCATOR_MODE_ALLOC, alignment, numa->node);
+            if (ptr == NULL && allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY;
+            return ptr;
+        case BUN_ALLOCATOR_MODE_FREE:
+            if (old_memory == NULL)
+            {
+                if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_POINTER;
+                return NULL;
+            }
+            Bun_Numa__Release((Bun_Numa__Header *)old_memory - 1);
+            return old_memory;
+        case BUN_ALLOCATOR_MODE_RESIZE:
+        case BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED:
+            if (old_memory == NULL || size == 0)
+            {
+                if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_INVALID_ARGUMENT;
+                return NULL;
+            }
+            header = (Bun_Numa__Header *)old_memory - 1;
+
+            /* still fits in the mapping or slot */
+            if (size <= (uintptr_t)header->base + header->map_size - (uintptr_t)old_memory)
+            {
+                if (mode == BUN_ALLOCATOR_MODE_RESIZE && size > header->size)
+                    memset((Bun_Byte *)old_memory + header->size, 0, size - header->size);
+                header->size = size;
+                return old_memory;
+            }
+
+            /* keep the block on the node it was placed on */
+            ptr = Bun_Numa__Alloc(size, mode == BUN_ALLOCATOR_MODE_RESIZE, alignment, header->node);
+            if (ptr == NULL)
+            {
+                if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_OUT_OF_MEMORY;
+                return NULL;
+            }
+            memcpy(ptr, old_memory, header->size);
+            Bun_Numa__Release(header);
+            return ptr;
+        default:
+            if (allocator_error != NULL) *allocator_error = BUN_ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED;
+            return NULL;
+    }
+}
+
+void *Bun_Numa_Allocator_Proc(void *allocator_data,
+                          Bun_Allocator_Error *allocator_error,
+                          Bun_Allocator_Mode mode,
+                          Bun_U32 size,
+                          Bun_U32 alignment,
+                          void *old_memory,
+                          Bun_U32 old_size
+                          )
+{
+    return Bun_Numa_Allocator_Proc64(allocator_data, allocator_error, mode, size, alignment, old_memory, old_size);
+}
+
+bool Bun_Numa__Is_Node_Local(const Bun_Allocator *allocator)
+{
+    return allocator->proc64 == &Bun_Numa_Allocator_Proc64
+        && ((Bun_Numa_Allocator *)allocator->data)->node == BUN_NUMA_NODE_LOCAL;
+}
+
+void Bun_Numa_Allocator_Init(Bun_Numa_Allocator *numa, Bun_S32 node)
+{
+    numa->node = node;
+}
+
+Bun_Allocator Bun_Numa_Allocator_Interface(Bun_Numa_Allocator *numa)
+{
+    return (Bun_Allocator){
+        .proc = &Bun_Numa_Allocator_Proc,
+        .proc64 = &Bun_Numa_Allocator_Proc64,
+        .implemented_modes = BUN_ALLOCATOR_MODE_ALLOC
+                           | BUN_ALLOCATOR_MODE_ALLOC_NON_ZEROED
+                           | BUN_ALLOCATOR_MODE_FREE
+                           | BUN_ALLOCATOR_MODE_RESIZE
+                           | BUN_ALLOCATOR_MODE_RESIZE_NON_ZEROED,
+        .data = numa,
+        .error = 0,
+    };
+}
+
+Bun_S32 Bun_Numa_Allocation_Node(void *ptr)
+{
+    if (ptr == NULL) return -1;
+    return ((Bun_Numa__Header *)ptr - 1)->node;
+}
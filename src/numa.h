@@ -0,0 +1,109 @@
+/*
+NUMA placement for allocator and arena memory.
+
+Memory is mapped directly from the os and bound to a node with mbind
+(through raw syscalls, libnuma is not needed). On machines with a single
+node, or on platforms without NUMA support, placement is a no-op and the
+allocator behaves like a plain page allocator.
+Blocks up to 32KB are carved from 1MB chunks mapped per node and reused
+through per node free lists, so they cost no syscall. The chunks are never
+given back to the os, bigger blocks get a mapping of their own.
+
+Use a numa allocator as the backing allocator of an arena or dynamic arena
+to place its pools:
+    Bun_Numa_Allocator numa;
+    Bun_Allocator allocator;
+    Bun_Numa_Allocator_Init(&numa, BUN_NUMA_NODE_LOCAL);
+    allocator = Bun_Numa_Allocator_Interface(&numa);
+    Bun_Dynamic_Arena_Init(&arena, &allocator, pool_size, false, 64);
+*/
+
+/*place on the node of the thread doing the allocation*/
+#define BUN_NUMA_NODE_LOCAL (-1)
+/*nodes are tracked with a single 64 bit node mask*/
+#define BUN_NUMA_MAX_NODES 64
+
+typedef struct
+{
+    Bun_S32 node; /*node to place memory on, or BUN_NUMA_NODE_LOCAL*/
+} Bun_Numa_Allocator;
+
+/*
+Number of NUMA nodes on this machine (or the simulated count).
+
+RETURN:
+    node count, 1 when NUMA is unavailable
+*/
+Bun_U32 Bun_Numa_Node_Count(void);
+/*
+Node of the cpu the calling thread is currently running on.
+
+RETURN:
+    node index, 0 when NUMA is unavailable
+*/
+Bun_S32 Bun_Numa_Current_Node(void);
+/*
+Set the placement policy of a range of memory that has not been touched yet.
+Pages are preferred on *node*, falling back to other nodes when it is full.
+
+ARGS:
+    ptr  - start of the range, rounded down to a page.
+    size - size in bytes of the range, rounded up to a page.
+    node - node to place on or BUN_NUMA_NODE_LOCAL.
+RETURN:
+    true on success (or when placement is a no-op), false on failure
+*/
+bool Bun_Numa_Bind(void *ptr, uintptr_t size, Bun_S32 node);
+/*
+Simulate a NUMA topology, for testing placement on single node machines.
+While simulating no memory policy is applied, allocations only record the
+node they would have been placed on (see Bun_Numa_Allocation_Node).
+
+ARGS:
+    node_count   - number of simulated nodes, 0 to stop simulating.
+    current_node - node reported for the calling thread.
+*/
+void Bun_Numa_Simulate(Bun_U32 node_count, Bun_S32 current_node);
+
+/*
+Initialise a numa allocator.
+
+ARGS:
+    numa - uninitialised numa allocator.
+    node - node to place allocations on, or BUN_NUMA_NODE_LOCAL to use the
+           node of the allocating thread at the time of each allocation.
+*/
+void Bun_Numa_Allocator_Init(Bun_Numa_Allocator *numa, Bun_S32 node);
+/*
+Get the generic allocator interface of a numa allocator.
+implements ALLOC, ALLOC_NON_ZEROED, FREE, RESIZE and RESIZE_NON_ZEROED.
+
+ARGS:
+    numa - an initialised numa allocator, must outlive the returned allocator.
+*/
+Bun_Allocator Bun_Numa_Allocator_Interface(Bun_Numa_Allocator *numa);
+/*
+Node an allocation made by a numa allocator was placed on.
+
+ARGS:
+    ptr - pointer returned by a numa allocator.
+RETURN:
+    node index, or -1 if ptr is NULL
+*/
+Bun_S32 Bun_Numa_Allocation_Node(void *ptr);
+
+/*internal, used by the pool cache to keep node local blocks on their node*/
+bool Bun_Numa__Is_Node_Local(const Bun_Allocator *allocator);
+
+#ifdef BUN_STRIP_PREFIX
+#    define NUMA_NODE_LOCAL BUN_NUMA_NODE_LOCAL
+#    define NUMA_MAX_NODES BUN_NUMA_MAX_NODES
+#    define Numa_Allocator Bun_Numa_Allocator
+#    define Numa_Node_Count Bun_Numa_Node_Count
+#    define Numa_Current_Node Bun_Numa_Current_Node
+#    define Numa_Bind Bun_Numa_Bind
+#    define Numa_Simulate Bun_Numa_Simulate
+#    define Numa_Allocator_Init Bun_Numa_Allocator_Init
+#    define Numa_Allocator_Interface Bun_Numa_Allocator_Interface
+#    define Numa_Allocation_Node Bun_Numa_Allocation_Node
+#endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,57 @@
+bool Bun_Rel32_Set(Bun_Rel32 *field, const void *target)
+{
+    intptr_t distance;
+
+    if (target == NULL)
+    {
+        *field = 0;
+        return true;
+    }
+    distance = (intptr_t)((uintptr_t)target - (uintptr_t)field);
+    /*0 is NULL, so a field can not point at itself*/
+    if (distance == 0 || distance < (intptr_t)INT32_MIN || distance > (intptr_t)INT32_MAX) return false;
+
+    *field = (Bun_Rel32)distance;
+    return true;
+}
+
+void *Bun_Rel32_Get(const Bun_Rel32 *field)
+{
+    if (*field == 0) return NULL;
+    return (Bun_Byte *)field + *field;
+}
+
+bool Bun_Off32_Encode(const void *base, const void *ptr, Bun_Off32 *off)
+{
+    uintptr_t offset;
+
+    if (ptr == NULL)
+    {
+        *off = 0;
+        return true;
+    }
+    if ((uintptr_t)ptr < (uintptr_t)base) return false;
+    offset = (uintptr_t)ptr - (uintptr_t)base;
+    if (offset >= (Bun_U32)-1) return false;
+
+    *off = (Bun_Off32)offset + 1;
+    return true;
+}
+
+void *Bun_Off32_Decode(const void *base, Bun_Off32 off)
+{
+    if (off == 0) return NULL;
+    return (Bun_Byte *)base + off - 1;
+}
+
+bool Bun_Arena_Off32_Encode(Bun_Arena *arena, const void *ptr, Bun_Off32 *off)
+{
+    if (ptr != NULL && (uintptr_t)ptr >= (uintptr_t)arena->buffer + arena->offset) return false;
+    return Bun_Off32_Encode(arena->buffer, ptr, off);
+}
+
+void *Bun_Arena_Off32_Decode(Bun_Arena *arena, Bun_Off32 off)
+{
+    if (off > arena->offset) return NULL;
+    return Bun_Off32_Decode(arena->buffer, off);
+}
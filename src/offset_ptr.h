@@ -0,0 +1,76 @@
+/*
+32 bit offset pointers for data living in arenas.
+
+Half the size of a pointer and independent of where the memory is mapped,
+so arena contents built out of them can be copied with memcpy, saved to a
+file (see File_Arena) or shared between processes.
+
+Rel32 - self relative, the distance from the field to the target.
+        Stays valid as long as field and target move together.
+Off32 - base relative, offset of the target from a base (an arena buffer) + 1.
+        Stays valid as long as the target stays at the same offset of the base.
+Both encode NULL as 0, so zero initialised memory holds NULL pointers.
+*/
+typedef Bun_S32 Bun_Rel32;
+typedef Bun_U32 Bun_Off32;
+
+/*
+Point *field* at *target*.
+
+ARGS:
+    field  - the offset pointer, must be where it will be read from.
+    target - pointer to point at, or NULL.
+RETURN:
+    true on success, false if target is further then 2GB away (field is untouched)
+*/
+bool Bun_Rel32_Set(Bun_Rel32 *field, const void *target);
+/*
+RETURN:
+    the pointer *field* points at, or NULL
+*/
+void *Bun_Rel32_Get(const Bun_Rel32 *field);
+/*
+Encode *ptr* as an offset from *base*.
+
+ARGS:
+    base - start of the region offsets are relative to.
+    ptr  - pointer into the region, or NULL.
+    off  - the encoded offset.
+RETURN:
+    true on success, false if ptr is before base or 4GB past it
+*/
+bool Bun_Off32_Encode(const void *base, const void *ptr, Bun_Off32 *off);
+/*
+RETURN:
+    the pointer *off* encodes relative to *base*, or NULL
+*/
+void *Bun_Off32_Decode(const void *base, Bun_Off32 off);
+/*
+Bun_Off32_Encode relative to an arena buffer, also checking ptr is in the used part of the arena.
+*/
+bool Bun_Arena_Off32_Encode(Bun_Arena *arena, const void *ptr, Bun_Off32 *off);
+/*
+Bun_Off32_Decode relative to an arena buffer, NULL if off is past the used part of the arena.
+*/
+void *Bun_Arena_Off32_Decode(Bun_Arena *arena, Bun_Off32 off);
+
+#ifndef BUN_NO_MACROS
+/*unchecked inline decoding for hot paths, field is evaluated more then once*/
+#define BUN_REL32_GET(T, field)     ((field) ? (T *)((Bun_Byte *)&(field) + (field)) : (T *)NULL)
+#define BUN_OFF32_GET(T, base, off) ((off) ? (T *)((Bun_Byte *)(base) + (off) - 1) : (T *)NULL)
+#endif /*BUN_NO_MACROS*/
+
+#ifdef BUN_STRIP_PREFIX
+#    define Rel32 Bun_Rel32
+#    define Off32 Bun_Off32
+#    define Rel32_Set Bun_Rel32_Set
+#    define Rel32_Get Bun_Rel32_Get
+#    define Off32_Encode Bun_Off32_Encode
+#    define Off32_Decode Bun_Off32_Decode
+#    define Arena_Off32_Encode Bun_Arena_Off32_Encode
+#    define Arena_Off32_Decode Bun_Arena_Off32_Decode
+#    ifndef BUN_NO_MACROS
+#        define REL32_GET BUN_REL32_GET
+#        define OFF32_GET BUN_OFF32_GET
+#    endif
+#endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,263 @@
+/*
+Typed object pools and arenas generated for a type T.
+
+BUN_POOL_DEFINE(T) emits a pool of T living in chunks of BUN_POOL_CHUNK_SLOTS
+objects with a bitmask of the live ones, so every size and alignment is a
+compile time constant and walking the live objects is a linear scan over
+dense chunks. Chunks are never given back before Deinit, objects never move.
+
+    BUN_POOL_DEFINE(Vec3)
+
+    Vec3_Pool pool;
+    Vec3_Pool_Iter iter;
+    Vec3 *v;
+
+    Vec3_Pool_Init(&pool, &bun_allocator_libc);
+    v = Vec3_Pool_Alloc(&pool);
+    for (iter = Vec3_Pool_Iter_Begin(&pool); (v = Vec3_Pool_Iter_Next(&iter)) != NULL;) ...
+    Vec3_Pool_Free(&pool, v);
+    Vec3_Pool_Deinit(&pool);
+
+BUN_ARENA_DEFINE(T) emits typed wrappers over Bun_Dynamic_Arena_Alloc_Inline.
+
+T has to be assignable (a struct, union or scalar, not an array), use the
+_NAMED versions when T is not a single identifier (pointers, struct tags...).
+Everything generated is static, so define a pool once per translation unit.
+*/
+#ifndef BUN_NO_MACROS
+
+#define BUN_POOL_CHUNK_SLOTS 64
+
+/*alignment of T as a constant expression*/
+#define BUN_ALIGN_OF(T) offsetof(struct { char c; T t; }, t)
+
+/*index of the lowest set bit, mask must not be 0*/
+BUN_INLINE Bun_U32 Bun_Pool__Lowest_Bit(Bun_U64 mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (Bun_U32)__builtin_ctzll(mask);
+#else
+    Bun_U32 bit = 0;
+    while (!(mask & 1)) { mask >>= 1; bit++; }
+    return bit;
+#endif
+}
+
+#define BUN_POOL_DEFINE(T) BUN_POOL_DEFINE_NAMED(T, T)
+#define BUN_POOL_DEFINE_NAMED(T, Name)                                                                  \
+typedef struct                                                                                          \
+{                                                                                                       \
+    Bun_U64 live; /*bit i set when items[i] is allocated*/                                              \
+    T items[BUN_POOL_CHUNK_SLOTS];                                                                      \
+} Name##_Pool_Chunk;                                                                                    \
+                                                                                                        \
+enum                                                                                                    \
+{                                                                                                       \
+    Name##_POOL_SIZE  = sizeof(T),                                                                      \
+    Name##_POOL_ALIGN = BUN_ALIGN_OF(T),                                                                \
+};                                                                                                      \
+                                                                                                        \
+typedef struct                                                                                          \
+{                                                                                                       \
+    Name##_Pool_Chunk **chunks; /*sorted by address*/                                                   \
+    Bun_USize chunk_count;                                                                              \
+    Bun_USize chunk_capacity;                                                                           \
+    Bun_USize hint; /*every chunk before it is full*/                                                   \
+    Bun_USize count; /*live objects*/                                                                   \
+    Bun_Allocator *allocator;                                                                           \
+} Name##_Pool;                                                                                          \
+                                                                                                        \
+typedef struct                                                                                          \
+{                                                                                                       \
+    Name##_Pool *pool;                                                                                  \
+    Bun_USize chunk;                                                                                    \
+    Bun_U64 mask; /*live objects of the current chunk not returned yet*/                                \
+} Name##_Pool_Iter;                                                                                     \
+                                                                                                        \
+static BUN_MAYBE_UNUSED void Name##_Pool_Init(Name##_Pool *pool, Bun_Allocator *allocator)              \
+{                                                                                                       \
+    static const Name##_Pool empty;                                                                     \
+    *pool = empty;                                                                                      \
+    pool->allocator = allocator;                                                                        \
+}                                                                                                       \
+                                                                                                        \
+static BUN_MAYBE_UNUSED void Name##_Pool_Deinit(Name##_Pool *pool)                                      \
+{                                                                                                       \
+    Bun_USize i;                                                                                        \
+    for (i = 0; i < pool->chunk_count; i++) Bun_Allocator_Free_Inline(pool->chunks[i], pool->allocator); \
+    if (pool->chunks != NULL) Bun_Allocator_Free_Inline(pool->chunks, pool->allocator);                 \
+    Name##_Pool_Init(pool, pool->allocator);                                                            \
+}                                                                                                       \
+                                                                                                        \
+/*first chunk at or after the hint with a free slot, adding one if they are all full, NULL on failure*/ \
+static BUN_MAYBE_UNUSED Name##_Pool_Chunk *Name##__Pool_Chunk_With_Room(Name##_Pool *pool)              \
+{                                                                                                       \
+    Name##_Pool_Chunk *chunk, **chunks;                                                                 \
+    Bun_USize at;                                                                                       \
+                                                                                                        \
+    for (; pool->hint < pool->chunk_count; pool->hint++)                                                \
+        if (~pool->chunks[pool->hint]->live) return pool->chunks[pool->hint];                           \
+                                                                                                        \
+    if (pool->chunk_count == pool->chunk_capacity)                                                      \
+    {                                                                                                   \
+        at = (pool->chunk_capacity) ? pool->chunk_capacity*2 : 8;                                       \
+        chunks = (pool->chunks == NULL)                                                                 \
+               ? Bun_Allocator_Alloc_Inline(at*sizeof(*chunks), false, BUN_ALIGN_OF(void *), pool->allocator) \
+               : Bun_Allocator_Resize_Inline(pool->chunks, at*sizeof(*chunks), pool->chunk_capacity*sizeof(*chunks), \
+                                             false, BUN_ALIGN_OF(void *), pool->allocator);              \
+        if (chunks == NULL) return NULL;                                                                \
+        pool->chunks = chunks;                                                                          \
+        pool->chunk_capacity = at;                                                                      \
+    }                                                                                                   \
+    chunk = Bun_Allocator_Alloc_Inline(sizeof(*chunk), true, BUN_ALIGN_OF(Name##_Pool_Chunk), pool->allocator); \
+    if (chunk == NULL) return NULL;                                                                     \
+                                                                                                        \
+    /*every chunk is full, so the hint is wherever the new one lands*/                                  \
+    at = pool->chunk_count;                                                                             \
+    while (at > 0 && (uintptr_t)pool->chunks[at - 1] > (uintptr_t)chunk)                                \
+    {                                                                                                   \
+        pool->chunks[at] = pool->chunks[at - 1];                                                        \
+        at--;                                                                                           \
+    }                                                                                                   \
+    pool->chunks[at] = chunk;                                                                           \
+    pool->chunk_count++;                                                                                \
+    pool->hint = at;                                                                                    \
+    return chunk;                                                                                       \
+}                                                                                                       \
+                                                                                                        \
+/*RETURN: a zeroed T, NULL on failure*/                                                                 \
+static BUN_MAYBE_UNUSED T *Name##_Pool_Alloc(Name##_Pool *pool)                                         \
+{                                                                                                       \
+    static const T zero;                                                                                \
+    Name##_Pool_Chunk *chunk = Name##__Pool_Chunk_With_Room(pool);                                      \
+    Bun_U32 bit;                                                                                        \
+                                                                                                        \
+    if (chunk == NULL) return NULL;                                                                     \
+    bit = Bun_Pool__Lowest_Bit(~chunk->live);                                                           \
+    chunk->live |= 1ull << bit;                                                                         \
+    pool->count++;                                                                                      \
+    chunk->items[bit] = zero;                                                                           \
+    return &chunk->items[bit];                                                                          \
+}                                                                                                       \
+                                                                                                        \
+/*                                                                                                      \
+Allocate *count* objects, each a copy of *init* or zeroed if init is NULL,                              \
+filling whole chunks at a time. out (if not NULL) gets the objects.                                     \
+RETURN: the number of objects allocated, less then count on failure                                     \
+*/                                                                                                      \
+static BUN_MAYBE_UNUSED Bun_USize Name##_Pool_Alloc_Batch(Name##_Pool *pool, Bun_USize count, const T *init, T **out) \
+{                                                                                                       \
+    static const T zero;                                                                                \
+    Name##_Pool_Chunk *chunk;                                                                           \
+    Bun_USize done = 0;                                                                                 \
+    Bun_U64 room;                                                                                       \
+    Bun_U32 bit;                                                                                        \
+                                                                                                        \
+    if (init == NULL) init = &zero;                                                                     \
+    while (done < count && (chunk = Name##__Pool_Chunk_With_Room(pool)) != NULL)                        \
+    {                                                                                                   \
+        for (room = ~chunk->live; room && done < count; room &= room - 1)                               \
+        {                                                                                               \
+            bit = Bun_Pool__Lowest_Bit(room);                                                           \
+            chunk->items[bit] = *init;                                                                  \
+            chunk->live |= 1ull << bit;                                                                 \
+            if (out != NULL) out[done] = &chunk->items[bit];                                            \
+            done++;                                                                                     \
+        }                                                                                               \
+    }                                                                                                   \
+    pool->count += done;                                                                                \
+    return done;                                                                                        \
+}                                                                                                       \
+                                                                                                        \
+/*RETURN: true on success, false if ptr is not a live object of the pool*/                             \
+static BUN_MAYBE_UNUSED bool Name##_Pool_Free(Name##_Pool *pool, T *ptr)                                \
+{                                                                                                       \
+    uintptr_t address = (uintptr_t)ptr, offset;                                                         \
+    Bun_USize low = 0, high = pool->chunk_count, mid;                                                   \
+    Name##_Pool_Chunk *chunk;                                                                           \
+    Bun_U64 bit;                                                                                        \
+                                                                                                        \
+    /*last chunk starting at or before ptr*/                                                            \
+    while (low < high)                                                                                  \
+    {                                                                                                   \
+        mid = low + (high - low)/2;                                                                     \
+        if ((uintptr_t)pool->chunks[mid] <= address) low = mid + 1;                                     \
+        else high = mid;                                                                                \
+    }                                                                                                   \
+    if (low == 0) return false;                                                                         \
+    chunk = pool->chunks[low - 1];                                                                      \
+                                                                                                        \
+    offset = address - (uintptr_t)chunk->items;                                                         \
+    if (address < (uintptr_t)chunk->items || offset >= sizeof(chunk->items) || offset % sizeof(T)) return false; \
+    bit = 1ull << (offset / sizeof(T));                                                                 \
+    if (!(chunk->live & bit)) return false;                                                             \
+                                                                                                        \
+    chunk->live &= ~bit;                                                                                \
+    pool->count--;                                                                                      \
+    if (low - 1 < pool->hint) pool->hint = low - 1;                                                     \
+    return true;                                                                                        \
+}                                                                                                       \
+                                                                                                        \
+/*free every object, keeping the chunks*/                                                               \
+static BUN_MAYBE_UNUSED void Name##_Pool_Free_All(Name##_Pool *pool)                                    \
+{                                                                                                       \
+    Bun_USize i;                                                                                        \
+    for (i = 0; i < pool->chunk_count; i++) pool->chunks[i]->live = 0;                                  \
+    pool->hint = 0;                                                                                     \
+    pool->count = 0;                                                                                    \
+}                                                                                                       \
+                                                                                                        \
+/*                                                                                                      \
+Iterate the live objects in address order with Name##_Pool_Iter_Next.                                   \
+The object last returned may be freed while iterating, allocations may or may not be seen.              \
+*/                                                                                                      \
+static BUN_MAYBE_UNUSED Name##_Pool_Iter Name##_Pool_Iter_Begin(Name##_Pool *pool)                      \
+{                                                                                                       \
+    Name##_Pool_Iter iter;                                                                              \
+    iter.pool  = pool;                                                                                  \
+    iter.chunk = 0;                                                                                     \
+    iter.mask  = (pool->chunk_count) ? pool->chunks[0]->live : 0;                                       \
+    return iter;                                                                                        \
+}                                                                                                       \
+                                                                                                        \
+/*RETURN: the next live object, NULL when done*/                                                        \
+static BUN_MAYBE_UNUSED T *Name##_Pool_Iter_Next(Name##_Pool_Iter *iter)                                \
+{                                                                                                       \
+    Bun_U32 bit;                                                                                        \
+    while (!iter->mask)                                                                                 \
+    {                                                                                                   \
+        if (iter->chunk + 1 >= iter->pool->chunk_count) return NULL;                                    \
+        iter->mask = iter->pool->chunks[++iter->chunk]->live;                                           \
+    }                                                                                                   \
+    bit = Bun_Pool__Lowest_Bit(iter->mask);                                                             \
+    iter->mask &= iter->mask - 1;                                                                       \
+    return &iter->pool->chunks[iter->chunk]->items[bit];                                                \
+}
+
+#define BUN_ARENA_DEFINE(T) BUN_ARENA_DEFINE_NAMED(T, T)
+#define BUN_ARENA_DEFINE_NAMED(T, Name)                                                                 \
+/*RETURN: a zeroed T from the arena, NULL on failure*/                                                  \
+static BUN_MAYBE_UNUSED T *Name##_Arena_Push(Bun_Dynamic_Arena *arena)                                  \
+{                                                                                                       \
+    return Bun_Dynamic_Arena_Alloc_Inline(sizeof(T), true, BUN_ALIGN_OF(T), arena);                     \
+}                                                                                                       \
+                                                                                                        \
+/*RETURN: count contiguous T, zeroed if *zeroed* is set, NULL on failure*/                             \
+static BUN_MAYBE_UNUSED T *Name##_Arena_Push_Array(Bun_USize count, bool zeroed, Bun_Dynamic_Arena *arena) \
+{                                                                                                       \
+    if (count == 0 || count > BUN_USIZE_MAX / sizeof(T)) return NULL;                                   \
+    return Bun_Dynamic_Arena_Alloc_Inline(count*sizeof(T), zeroed, BUN_ALIGN_OF(T), arena);             \
+}
+
+#endif /*BUN_NO_MACROS*/
+
+#ifdef BUN_STRIP_PREFIX
+#    ifndef BUN_NO_MACROS
+#        define POOL_CHUNK_SLOTS BUN_POOL_CHUNK_SLOTS
+#        define ALIGN_OF BUN_ALIGN_OF
+#        define POOL_DEFINE BUN_POOL_DEFINE
+#        define POOL_DEFINE_NAMED BUN_POOL_DEFINE_NAMED
+#        define ARENA_DEFINE BUN_ARENA_DEFINE
+#        define ARENA_DEFINE_NAMED BUN_ARENA_DEFINE_NAMED
+#    endif
+#endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,172 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(BUN_NO_THREADS)
+#    define BUN_POOL_CACHE__THREADS
+#    include <pthread.h>
+#endif
+
+Bun_Pool_Cache_Config bun_pool_cache_config = (Bun_Pool_Cache_Config){
+    .max_bytes          = 0,
+    .max_blocks_per_bin = 64,
+};
+
+/*cached blocks are linked through their first bytes*/
+typedef struct Bun_Pool_Cache__Block Bun_Pool_Cache__Block;
+struct Bun_Pool_Cache__Block
+{
+    Bun_Pool_Cache__Block *next;
+};
+
+typedef struct
+{
+    Bun_Allocator allocator; /*copy, used to free on trim*/
+    Bun_USize size;
+    Bun_U32 alignment;
+    Bun_S32 node; /*node of the blocks from node local numa allocators, -1 otherwise*/
+    Bun_U32 count;
+    Bun_Pool_Cache__Block *blocks;
+} Bun_Pool_Cache__Bin;
+
+static struct
+{
+    uintptr_t bytes; /*written under the lock, read atomically by the unlocked early outs*/
+    Bun_Pool_Cache__Bin bins[BUN_POOL_CACHE_BINS];
+#ifdef BUN_POOL_CACHE__THREADS
+    pthread_mutex_t lock;
+#endif
+} bun_pool_cache = {
+    0,
+    {{{0}}},
+#ifdef BUN_POOL_CACHE__THREADS
+    PTHREAD_MUTEX_INITIALIZER,
+#endif
+};
+
+static void Bun_Pool_Cache__Lock(void)
+{
+#ifdef BUN_POOL_CACHE__THREADS
+    pthread_mutex_lock(&bun_pool_cache.lock);
+#endif
+}
+static void Bun_Pool_Cache__Unlock(void)
+{
+#ifdef BUN_POOL_CACHE__THREADS
+    pthread_mutex_unlock(&bun_pool_cache.lock);
+#endif
+}
+
+/*
+Find the bin for a key, linear probing from its hash.
+ARGS:
+    node   - node the blocks are on, -1 when the allocator does not place them.
+    create - claim an empty bin when the key has none.
+*/
+static Bun_Pool_Cache__Bin *Bun_Pool_Cache__Find(Bun_USize size, Bun_U32 alignment, Bun_Allocator *allocator, Bun_S32 node, bool create)
+{
+    uintptr_t hash;
+    Bun_U32 i;
+    Bun_Pool_Cache__Bin *empty = NULL;
+
+    hash = (uintptr_t)size * 0x9E3779B1u ^ (uintptr_t)alignment ^ (uintptr_t)allocator->data ^ ((uintptr_t)allocator->proc >> 4) ^ ((uintptr_t)(node+1) << 8);
+    for (i = 0; i < BUN_POOL_CACHE_BINS; i++)
+    {
+        Bun_Pool_Cache__Bin *bin = &bun_pool_cache.bins[(hash + i) % BUN_POOL_CACHE_BINS];
+        if (bin->count == 0)
+        {
+            if (empty == NULL) empty = bin;
+            continue;
+        }
+        if (bin->size == size
+        &&  bin->alignment == alignment
+        &&  bin->allocator.proc == allocator->proc
+        &&  bin->allocator.data == allocator->data
+        &&  bin->node == node
+        ) return bin;
+    }
+    if (!create || empty == NULL) return NULL;
+
+    empty->allocator = *allocator;
+    empty->size = size;
+    empty->alignment = alignment;
+    empty->node = node;
+    empty->blocks = NULL;
+    return empty;
+}
+
+void *Bun_Pool_Cache_Pop(Bun_USize size, Bun_U32 alignment, Bun_Allocator *allocator)
+{
+    Bun_Pool_Cache__Bin *bin;
+    Bun_Pool_Cache__Block *block = NULL;
+    Bun_S32 node;
+
+    if (allocator == NULL || BUN_ATOMIC_LOAD_RELAXED(&bun_pool_cache.bytes) == 0) return NULL;
+    /*a node local allocator would have placed a fresh block on this thread's node*/
+    node = Bun_Numa__Is_Node_Local(allocator) ? Bun_Numa_Current_Node() : -1;
+
+    Bun_Pool_Cache__Lock();
+    bin = Bun_Pool_Cache__Find(size, alignment, allocator, node, false);
+    if (bin != NULL)
+    {
+        block = bin->blocks;
+        bin->blocks = block->next;
+        bin->count -= 1;
+        BUN_ATOMIC_STORE_RELAXED(&bun_pool_cache.bytes, bun_pool_cache.bytes - size);
+    }
+    Bun_Pool_Cache__Unlock();
+    return block;
+}
+
+bool Bun_Pool_Cache_Push(void *block, Bun_USize size, Bun_U32 alignment, Bun_Allocator *allocator)
+{
+    Bun_Pool_Cache__Bin *bin;
+    Bun_S32 node;
+    bool kept = false;
+
+    if (block == NULL || allocator == NULL
+    || size < sizeof(Bun_Pool_Cache__Block)
+    || size > bun_pool_cache_config.max_bytes
+    || BUN_ATOMIC_LOAD_RELAXED(&bun_pool_cache.bytes) > bun_pool_cache_config.max_bytes - size
+    ) return false;
+    node = Bun_Numa__Is_Node_Local(allocator) ? Bun_Numa_Allocation_Node(block) : -1;
+
+    Bun_Pool_Cache__Lock();
+    if (bun_pool_cache.bytes <= bun_pool_cache_config.max_bytes - size)
+    {
+        bin = Bun_Pool_Cache__Find(size, alignment, allocator, node, true);
+        if (bin != NULL
+        && (!bun_pool_cache_config.max_blocks_per_bin || bin->count < bun_pool_cache_config.max_blocks_per_bin)
+        )
+        {
+            ((Bun_Pool_Cache__Block *)block)->next = bin->blocks;
+            bin->blocks = block;
+            bin->count += 1;
+            BUN_ATOMIC_STORE_RELAXED(&bun_pool_cache.bytes, bun_pool_cache.bytes + size);
+            kept = true;
+        }
+    }
+    Bun_Pool_Cache__Unlock();
+    return kept;
+}
+
+void Bun_Pool_Cache_Trim(uintptr_t max_bytes)
+{
+    Bun_U32 i;
+
+    Bun_Pool_Cache__Lock();
+    for (i = 0; i < BUN_POOL_CACHE_BINS && bun_pool_cache.bytes > max_bytes; i++)
+    {
+        Bun_Pool_Cache__Bin *bin = &bun_pool_cache.bins[i];
+        while (bin->count && bun_pool_cache.bytes > max_bytes)
+        {
+            Bun_Pool_Cache__Block *block = bin->blocks;
+            bin->blocks = block->next;
+            bin->count -= 1;
+            BUN_ATOMIC_STORE_RELAXED(&bun_pool_cache.bytes, bun_pool_cache.bytes - bin->size);
+            (Bun_Allocator_Free)(block, &bin->allocator);
+        }
+    }
+    Bun_Pool_Cache__Unlock();
+}
+
+uintptr_t Bun_Pool_Cache_Bytes(void)
+{
+    return BUN_ATOMIC_LOAD_RELAXED(&bun_pool_cache.bytes);
+}
@@ -0,0 +1,68 @@
+/*
+Process wide, thread safe cache of pool sized blocks.
+
+Dynamic arenas draw their pools (and pools array) from here and give them
+back on Deinit/Free_Pools, so short lived arenas cost a cache pop instead of
+a trip to the backing allocator. Blocks are binned by size, alignment and the
+allocator they came from, a block is only ever handed back to an arena using
+the same allocator. Blocks of a BUN_NUMA_NODE_LOCAL numa allocator are also
+binned by the node they were placed on and only handed to threads running on
+that node.
+
+The cache is off until bun_pool_cache_config.max_bytes is set.
+NOTE: allocators with cached blocks must stay valid until the blocks are
+      trimmed, call Bun_Pool_Cache_Trim(0) before tearing one down.
+*/
+typedef struct
+{
+    uintptr_t max_bytes;        /*bytes kept over all bins, 0 disables the cache*/
+    Bun_U32 max_blocks_per_bin; /*blocks kept per bin, 0 means no per bin limit*/
+} Bun_Pool_Cache_Config;
+
+extern Bun_Pool_Cache_Config bun_pool_cache_config;
+
+/*number of distinct (size, alignment, allocator, node) bins*/
+#define BUN_POOL_CACHE_BINS 64
+
+/*
+Take a cached block.
+
+ARGS:
+    size      - size in bytes of the block.
+    alignment - alignment the block was allocated with.
+    allocator - allocator the block must come from.
+RETURN:
+    a block with undefined contents, or NULL if none is cached
+*/
+void *Bun_Pool_Cache_Pop(Bun_USize size, Bun_U32 alignment, Bun_Allocator *allocator);
+/*
+Give a block to the cache.
+
+ARGS:
+    block     - block allocated by *allocator*, at least pointer sized.
+    size      - size in bytes of the block.
+    alignment - alignment the block was allocated with.
+    allocator - allocator the block came from.
+RETURN:
+    true if the cache kept the block, false if the caller still owns it
+*/
+bool Bun_Pool_Cache_Push(void *block, Bun_USize size, Bun_U32 alignment, Bun_Allocator *allocator);
+/*
+Free cached blocks until at most *max_bytes* are kept.
+*/
+void Bun_Pool_Cache_Trim(uintptr_t max_bytes);
+/*
+RETURN:
+    bytes currently kept by the cache
+*/
+uintptr_t Bun_Pool_Cache_Bytes(void);
+
+#ifdef BUN_STRIP_PREFIX
+#    define Pool_Cache_Config Bun_Pool_Cache_Config
+#    define pool_cache_config bun_pool_cache_config
+#    define POOL_CACHE_BINS BUN_POOL_CACHE_BINS
+#    define Pool_Cache_Pop Bun_Pool_Cache_Pop
+#    define Pool_Cache_Push Bun_Pool_Cache_Push
+#    define Pool_Cache_Trim Bun_Pool_Cache_Trim
+#    define Pool_Cache_Bytes Bun_Pool_Cache_Bytes
+#endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,416 @@
+#ifdef BUN_PROFILE_CALLSITES
+#if defined(BUN_ATOMICS) && (defined(__unix__) || defined(__APPLE__)) && !defined(BUN_NO_THREADS)
+#    define BUN_PROFILE__THREADS
+#endif
+
+#ifdef BUN_PROFILE__THREADS
+#    define BUN_PROFILE__THREAD_LOCAL __thread
+#else
+#    define BUN_PROFILE__THREAD_LOCAL
+#endif
+
+Bun_Profile_Config bun_profile_config = {0};
+
+static const char *bun_profile__kind_names[BUN_PROFILE_KIND_COUNT] = {
+    "Bun_Allocator_Alloc",
+    "Bun_Allocator_Resize",
+    "Bun_Arena_Alloc",
+    "Bun_Arena_Resize",
+    "Bun_Dynamic_Arena_Alloc_Push",
+    "Bun_Dynamic_Arena_Alloc_Insert",
+    "Bun_Dynamic_Arena_Resize",
+};
+
+/*
+Call site table, open addressing on a hash of file, line and kind. Slots are
+claimed by swapping their key in and never given back, the claiming thread
+sets the rest and then *ready*.
+*/
+typedef struct
+{
+    Bun_U64 key; /*0 while free*/
+    Bun_U32 ready;
+    Bun_U32 line;
+    const char *file;
+    Bun_Profile_Kind kind;
+    Bun_U64 count;
+    Bun_U64 bytes;
+    Bun_U64 live_count;
+    Bun_U64 live_bytes;
+} Bun_Profile__Site;
+
+/*
+Live table, BUN_PROFILE__WAYS entries per bucket so looking up a pointer
+reads a single cache line of pointers. An entry is taken by swapping its
+pointer to BUSY, which keeps every other thread off the record until the
+pointer (or EMPTY) is stored back.
+*/
+#define BUN_PROFILE__WAYS 8
+#define BUN_PROFILE__EMPTY ((void *)0)
+#define BUN_PROFILE__BUSY  ((void *)1)
+
+typedef struct
+{
+    void *owner;             /*allocator or arena, only accessed atomically*/
+    Bun_Profile__Site *site;
+    Bun_U64 count;           /*what the allocation stands for when sampled*/
+    Bun_U64 bytes;
+} Bun_Profile__Record;
+
+static Bun_Profile__Site bun_profile__sites[BUN_PROFILE_MAX_CALLSITES];
+static void *bun_profile__live_ptrs[BUN_PROFILE_MAX_LIVE];
+static Bun_Profile__Record bun_profile__live_records[BUN_PROFILE_MAX_LIVE];
+static Bun_U64 bun_profile__tracked; /*entries in the live table*/
+static Bun_U64 bun_profile__dropped;
+static BUN_PROFILE__THREAD_LOCAL Bun_S64 bun_profile__countdown; /*bytes until the next recorded allocation*/
+
+static Bun_U64 Bun_Profile__Hash(const char *file, Bun_U32 line, Bun_Profile_Kind kind)
+{
+    Bun_U64 hash = 0xcbf29ce484222325ull; /*fnv-1a*/
+    for (; *file; file++) hash = (hash ^ (Bun_U8)*file) * 0x100000001b3ull;
+    hash = (hash ^ line) * 0x100000001b3ull;
+    hash = (hash ^ kind) * 0x100000001b3ull;
+    return (hash) ? hash : 1;
+}
+
+/*RETURN: the slot of a call site, claimed if new, NULL if the table is full*/
+static Bun_Profile__Site *Bun_Profile__Site_Of(const char *file, Bun_U32 line, Bun_Profile_Kind kind)
+{
+    Bun_U64 key = Bun_Profile__Hash(file, line, kind);
+    Bun_Profile__Site *site;
+    Bun_U64 found;
+    Bun_U32 i;
+
+    for (i = 0; i < BUN_PROFILE_MAX_CALLSITES; i++)
+    {
+        site = &bun_profile__sites[(key + i) & (BUN_PROFILE_MAX_CALLSITES - 1)];
+        found = BUN_ATOMIC_LOAD(&site->key);
+        if (found == 0)
+        {
+            if (BUN_ATOMIC_CAS(&site->key, &found, key))
+            {
+                site->file = file;
+                site->line = line;
+                site->kind = kind;
+                BUN_ATOMIC_STORE(&site->ready, 1);
+                return site;
+            }
+        }
+        if (found != key) continue;
+        while (!BUN_ATOMIC_LOAD(&site->ready)) {} /*claimed by another thread a moment ago*/
+        if (site->line == line && site->kind == kind && strcmp(site->file, file) == 0) return site;
+    }
+    return NULL;
+}
+
+static Bun_U32 Bun_Profile__Bucket_Of(void *ptr)
+{
+    Bun_U64 hash = (Bun_U64)(uintptr_t)ptr * 0x9E3779B97F4A7C15ull;
+    return (Bun_U32)(hash >> 32) & (BUN_PROFILE_MAX_LIVE / BUN_PROFILE__WAYS - 1);
+}
+
+static bool Bun_Profile__Track(void *ptr, Bun_Profile__Record *record)
+{
+    Bun_U32 start = Bun_Profile__Bucket_Of(ptr) * BUN_PROFILE__WAYS;
+    Bun_U32 i;
+    void *expected;
+
+    for (i = start; i < start + BUN_PROFILE__WAYS; i++)
+    {
+        expected = BUN_PROFILE__EMPTY;
+        if (BUN_ATOMIC_LOAD_RELAXED(&bun_profile__live_ptrs[i]) != BUN_PROFILE__EMPTY) continue;
+        if (!BUN_ATOMIC_CAS(&bun_profile__live_ptrs[i], &expected, BUN_PROFILE__BUSY)) continue;
+
+        BUN_ATOMIC_STORE_RELAXED(&bun_profile__live_records[i].owner, record->owner);
+        bun_profile__live_records[i].site  = record->site;
+        bun_profile__live_records[i].count = record->count;
+        bun_profile__live_records[i].bytes = record->bytes;
+        BUN_ATOMIC_STORE(&bun_profile__live_ptrs[i], ptr);
+
+        BUN_ATOMIC_ADD(&record->site->live_count, record->count);
+        BUN_ATOMIC_ADD(&record->site->live_bytes, record->bytes);
+        BUN_ATOMIC_ADD(&bun_profile__tracked, 1);
+        return true;
+    }
+    BUN_ATOMIC_ADD(&bun_profile__dropped, 1);
+    return false;
+}
+
+/*take entry *i* whose pointer is *ptr*, RETURN: false if another thread took it first*/
+static bool Bun_Profile__Take(Bun_U32 i, void *ptr, Bun_Profile__Record *record)
+{
+    if (!BUN_ATOMIC_CAS(&bun_profile__live_ptrs[i], &ptr, BUN_PROFILE__BUSY)) return false;
+
+    *record = bun_profile__live_records[i];
+    BUN_ATOMIC_STORE(&bun_profile__live_ptrs[i], BUN_PROFILE__EMPTY);
+
+    BUN_ATOMIC_SUB(&record->site->live_count, record->count);
+    BUN_ATOMIC_SUB(&record->site->live_bytes, record->bytes);
+    BUN_ATOMIC_SUB(&bun_profile__tracked, 1);
+    return true;
+}
+
+/*RETURN: true and the record of *ptr* if it was tracked*/
+static bool Bun_Profile__Untrack(void *ptr, Bun_Profile__Record *record)
+{
+    Bun_U32 start, i;
+
+    if (ptr == NULL || BUN_ATOMIC_LOAD_RELAXED(&bun_profile__tracked) == 0) return false;
+    start = Bun_Profile__Bucket_Of(ptr) * BUN_PROFILE__WAYS;
+    for (i = start; i < start + BUN_PROFILE__WAYS; i++)
+    {
+        if (BUN_ATOMIC_LOAD(&bun_profile__live_ptrs[i]) == ptr) return Bun_Profile__Take(i, ptr, record);
+    }
+    return false;
+}
+
+/*untrack everything allocated from *owner*, for arenas freeing all at once*/
+static void Bun_Profile__Untrack_Owner(void *owner)
+{
+    Bun_Profile__Record record;
+    void *ptr;
+    Bun_U32 i;
+
+    if (BUN_ATOMIC_LOAD_RELAXED(&bun_profile__tracked) == 0) return;
+    for (i = 0; i < BUN_PROFILE_MAX_LIVE; i++)
+    {
+        ptr = BUN_ATOMIC_LOAD(&bun_profile__live_ptrs[i]);
+        if (ptr == BUN_PROFILE__EMPTY || ptr == BUN_PROFILE__BUSY) continue;
+        if (BUN_ATOMIC_LOAD_RELAXED(&bun_profile__live_records[i].owner) != owner) continue;
+        Bun_Profile__Take(i, ptr, &record);
+    }
+}
+
+/*count a successful allocation at its call site, sampled with bun_profile_config.sample_interval*/
+static void Bun_Profile__Allocated(void *ptr, Bun_USize size, void *owner, Bun_Profile_Kind kind, const char *file, Bun_U32 line)
+{
+    Bun_S64 interval = (Bun_S64)bun_profile_config.sample_interval;
+    Bun_Profile__Record record;
+
+    if (ptr == NULL) return;
+    record.owner = owner;
+    record.count = 1;
+    record.bytes = size;
+    if (interval > 0)
+    {
+        bun_profile__countdown -= (Bun_S64)size;
+        if (bun_profile__countdown > 0) return;
+        bun_profile__countdown += interval;
+        if (bun_profile__countdown <= 0) bun_profile__countdown = interval;
+        /*stands for the allocations since the last recorded one*/
+        if ((Bun_S64)size < interval)
+        {
+            record.bytes = (Bun_U64)interval;
+            record.count = (size) ? (Bun_U64)interval / size : 1;
+        }
+    }
+
+    record.site = Bun_Profile__Site_Of(file, line, kind);
+    if (record.site == NULL)
+    {
+        BUN_ATOMIC_ADD(&bun_profile__dropped, 1);
+        return;
+    }
+    BUN_ATOMIC_ADD(&record.site->count, record.count);
+    BUN_ATOMIC_ADD(&record.site->bytes, record.bytes);
+    Bun_Profile__Track(ptr, &record);
+}
+
+/*
+Wrappers behind the macros in profile.h, each calls the real function.
+*/
+void *Bun_Profile__Allocator_Alloc(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator, const char *file, Bun_U32 line)
+{
+    void *ptr = (Bun_Allocator_Alloc_64)(size, zeroed, alignment, allocator);
+    Bun_Profile__Allocated(ptr, size, allocator, BUN_PROFILE_ALLOCATOR_ALLOC, file, line);
+    return ptr;
+}
+bool Bun_Profile__Allocator_Free(void *ptr, Bun_Allocator *allocator)
+{
+    Bun_Profile__Record record;
+    bool tracked = Bun_Profile__Untrack(ptr, &record);
+    bool result = (Bun_Allocator_Free)(ptr, allocator);
+    if (!result && tracked) Bun_Profile__Track(ptr, &record);
+    return result;
+}
+bool Bun_Profile__Allocator_Free_All(Bun_Allocator *allocator)
+{
+    bool result = (Bun_Allocator_Free_all)(allocator);
+    if (result) Bun_Profile__Untrack_Owner(allocator);
+    return result;
+}
+void *Bun_Profile__Allocator_Resize(void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator, const char *file, Bun_U32 line)
+{
+    Bun_Profile__Record record;
+    bool tracked = Bun_Profile__Untrack(ptr, &record);
+    void *new_ptr = (Bun_Allocator_Resize_64)(ptr, size, old_size, zeroed, alignment, allocator);
+    if (new_ptr == NULL && tracked) Bun_Profile__Track(ptr, &record);
+    Bun_Profile__Allocated(new_ptr, size, allocator, BUN_PROFILE_ALLOCATOR_RESIZE, file, line);
+    return new_ptr;
+}
+
+void *Bun_Profile__Arena_Alloc(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena, const char *file, Bun_U32 line)
+{
+    void *ptr = (Bun_Arena_Alloc_Inline)(size, zeroed, alignment, arena);
+    Bun_Profile__Allocated(ptr, size, arena, BUN_PROFILE_ARENA_ALLOC, file, line);
+    return ptr;
+}
+void *Bun_Profile__Arena_Resize(void *old_memory, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena, const char *file, Bun_U32 line)
+{
+    Bun_Profile__Record record;
+    bool tracked = Bun_Profile__Untrack(old_memory, &record);
+    void *ptr = (Bun_Arena_Resize)(old_memory, size, old_size, zeroed, alignment, arena);
+    if (ptr == NULL && tracked) Bun_Profile__Track(old_memory, &record);
+    Bun_Profile__Allocated(ptr, size, arena, BUN_PROFILE_ARENA_RESIZE, file, line);
+    return ptr;
+}
+void Bun_Profile__Arena_Free_All(Bun_Arena *arena)
+{
+    Bun_Profile__Untrack_Owner(arena);
+    (Bun_Arena_Free_All)(arena);
+}
+void Bun_Profile__Arena_Deinit_From_Allocator(Bun_Arena *arena, Bun_Allocator *allocator)
+{
+    Bun_Profile__Untrack_Owner(arena);
+    (Bun_Arena_Deinit_From_Allocator)(arena, allocator);
+}
+
+void *Bun_Profile__Dynamic_Arena_Alloc(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena, Bun_Profile_Kind kind, const char *file, Bun_U32 line)
+{
+    void *ptr = (kind == BUN_PROFILE_DYNAMIC_ARENA_INSERT)
+              ? (Bun_Dynamic_Arena_Alloc_Insert)(size, zeroed, alignment, arena)
+              : (Bun_Dynamic_Arena_Alloc_Inline)(size, zeroed, alignment, arena);
+    Bun_Profile__Allocated(ptr, size, arena, kind, file, line);
+    return ptr;
+}
+void *Bun_Profile__Dynamic_Arena_Resize(void *old_memory, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena, const char *file, Bun_U32 line)
+{
+    Bun_Profile__Record record;
+    bool tracked = Bun_Profile__Untrack(old_memory, &record);
+    void *ptr = (Bun_Dynamic_Arena_Resize)(old_memory, size, old_size, zeroed, alignment, arena);
+    if (ptr == NULL && tracked) Bun_Profile__Track(old_memory, &record);
+    Bun_Profile__Allocated(ptr, size, arena, BUN_PROFILE_DYNAMIC_ARENA_RESIZE, file, line);
+    return ptr;
+}
+void Bun_Profile__Dynamic_Arena_Free_All(Bun_Dynamic_Arena *arena, bool zero_pools)
+{
+    Bun_Profile__Untrack_Owner(arena);
+    (Bun_Dynamic_Arena_Free_All)(arena, zero_pools);
+}
+void Bun_Profile__Dynamic_Arena_Free_Pools(Bun_Dynamic_Arena *arena, Bun_U32 min_pools, bool zero_pools)
+{
+    Bun_Profile__Untrack_Owner(arena);
+    (Bun_Dynamic_Arena_Free_Pools)(arena, min_pools, zero_pools);
+}
+void Bun_Profile__Dynamic_Arena_Deinit(Bun_Dynamic_Arena *arena)
+{
+    Bun_Profile__Untrack_Owner(arena);
+    (Bun_Dynamic_Arena_Deinit)(arena);
+}
+
+static bool Bun_Profile__Read_Site(Bun_Profile__Site *site, Bun_Profile_Callsite *out)
+{
+    if (!BUN_ATOMIC_LOAD(&site->ready)) return false;
+    out->file       = site->file;
+    out->line       = site->line;
+    out->kind       = site->kind;
+    out->count      = BUN_ATOMIC_LOAD_RELAXED(&site->count);
+    out->bytes      = BUN_ATOMIC_LOAD_RELAXED(&site->bytes);
+    out->live_count = BUN_ATOMIC_LOAD_RELAXED(&site->live_count);
+    out->live_bytes = BUN_ATOMIC_LOAD_RELAXED(&site->live_bytes);
+    return true;
+}
+
+static int Bun_Profile__Compare_Bytes(const void *a, const void *b)
+{
+    Bun_U64 x = ((const Bun_Profile_Callsite *)a)->bytes;
+    Bun_U64 y = ((const Bun_Profile_Callsite *)b)->bytes;
+    return (x < y) - (x > y);
+}
+
+Bun_U32 Bun_Profile_Snapshot(Bun_Profile_Callsite *sites, Bun_U32 max_sites)
+{
+    Bun_Profile_Callsite site;
+    Bun_U32 count = 0, smallest = 0, i, j;
+
+    if (max_sites == 0) return 0;
+    for (i = 0; i < BUN_PROFILE_MAX_CALLSITES; i++)
+    {
+        if (!Bun_Profile__Read_Site(&bun_profile__sites[i], &site)) continue;
+        if (count < max_sites)
+        {
+            sites[count++] = site;
+            continue;
+        }
+        /*full, keep the biggest by replacing the smallest*/
+        for (smallest = 0, j = 1; j < count; j++)
+        {
+            if (sites[j].bytes < sites[smallest].bytes) smallest = j;
+        }
+        if (site.bytes > sites[smallest].bytes) sites[smallest] = site;
+    }
+    qsort(sites, count, sizeof(*sites), Bun_Profile__Compare_Bytes);
+    return count;
+}
+
+Bun_U32 Bun_Profile_Report(Bun_Profile_Report_Format format, char *buffer, Bun_U32 buffer_size)
+{
+    Bun_String_Buffer text = Bun_String_Buffer_From(buffer, buffer_size);
+    Bun_Profile_Callsite site;
+    Bun_U32 i;
+
+    if (format == BUN_PROFILE_REPORT_TEXT)
+    {
+        Bun_String_Buffer_Append(&text, "profile sample_interval=");
+        Bun_String_Buffer_Append_U64(&text, bun_profile_config.sample_interval);
+        Bun_String_Buffer_Append(&text, " dropped=");
+        Bun_String_Buffer_Append_U64(&text, Bun_Profile_Dropped());
+        Bun_String_Buffer_Append(&text, "\n");
+    }
+    for (i = 0; i < BUN_PROFILE_MAX_CALLSITES; i++)
+    {
+        if (!Bun_Profile__Read_Site(&bun_profile__sites[i], &site)) continue;
+        if (format == BUN_PROFILE_REPORT_FOLDED_LIVE && site.live_bytes == 0) continue;
+
+        Bun_String_Buffer_Append(&text, site.file);
+        Bun_String_Buffer_Append(&text, ":");
+        Bun_String_Buffer_Append_U64(&text, site.line);
+        Bun_String_Buffer_Append(&text, (format == BUN_PROFILE_REPORT_TEXT) ? " " : ";");
+        Bun_String_Buffer_Append(&text, bun_profile__kind_names[site.kind]);
+        if (format == BUN_PROFILE_REPORT_TEXT)
+        {
+            Bun_String_Buffer_Append(&text, " count=");
+            Bun_String_Buffer_Append_U64(&text, site.count);
+            Bun_String_Buffer_Append(&text, " bytes=");
+            Bun_String_Buffer_Append_U64(&text, site.bytes);
+            Bun_String_Buffer_Append(&text, " live_count=");
+            Bun_String_Buffer_Append_U64(&text, site.live_count);
+            Bun_String_Buffer_Append(&text, " live_bytes=");
+            Bun_String_Buffer_Append_U64(&text, site.live_bytes);
+        }
+        else
+        {
+            Bun_String_Buffer_Append(&text, " ");
+            Bun_String_Buffer_Append_U64(&text, (format == BUN_PROFILE_REPORT_FOLDED_LIVE) ? site.live_bytes : site.bytes);
+        }
+        Bun_String_Buffer_Append(&text, "\n");
+    }
+    return (text.overflow) ? 0 : text.len;
+}
+
+void Bun_Profile_Reset(void)
+{
+    Bun_U32 i;
+    for (i = 0; i < BUN_PROFILE_MAX_CALLSITES; i++)
+    {
+        BUN_ATOMIC_STORE_RELAXED(&bun_profile__sites[i].count, 0);
+        BUN_ATOMIC_STORE_RELAXED(&bun_profile__sites[i].bytes, 0);
+    }
+    BUN_ATOMIC_STORE_RELAXED(&bun_profile__dropped, 0);
+}
+
+Bun_U64 Bun_Profile_Dropped(void)
+{
+    return BUN_ATOMIC_LOAD_RELAXED(&bun_profile__dropped);
+}
+#endif /*ifdef BUN_PROFILE_CALLSITES*/
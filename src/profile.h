@@ -0,0 +1,172 @@
+#ifdef BUN_PROFILE_CALLSITES
+/*
+Per call site allocation profiling, opt in by defining BUN_PROFILE_CALLSITES
+before every include of bun.h (the implementation one included).
+
+The allocation functions of allocators, arenas and dynamic arenas become
+macros passing __FILE__ and __LINE__ (Bun_Allocator_NEW included, through
+Bun_Allocator_Alloc), every call site gets a slot in a lock free table with
+its allocation count and bytes, and the count and bytes still live.
+Frees, resizes and arena free_all/free_pools/deinit are wrapped as well to
+keep the live numbers, a resize counts as a new allocation at its call site.
+The library itself calls these functions with their name in parentheses,
+which skips the macros, so only the programs own calls are counted.
+
+Allocations are tracked until freed in a table of BUN_PROFILE_MAX_LIVE
+entries, ones that do not fit are still counted but never live. Arena
+free_all, free_pools and deinit scan that table for the arenas entries.
+
+    bun_profile_config.sample_interval = 1 << 19;
+    ...
+    Bun_Profile_Report(BUN_PROFILE_REPORT_FOLDED_BYTES, buffer, sizeof(buffer));
+    -> src/load.c:42;Bun_Dynamic_Arena_Alloc_Push 41943040000
+*/
+#ifndef BUN_PROFILE_MAX_CALLSITES
+#define BUN_PROFILE_MAX_CALLSITES 4096 /*power of 2*/
+#endif
+#ifndef BUN_PROFILE_MAX_LIVE
+#define BUN_PROFILE_MAX_LIVE (1 << 14) /*power of 2*/
+#endif
+
+typedef struct
+{
+    /*
+    Record one allocation every this many bytes allocated by a thread, 0
+    (default) records every allocation. Recorded allocations stand for the
+    bytes since the previous one, so counts and bytes are estimates.
+    Set before allocating.
+    */
+    Bun_USize sample_interval;
+} Bun_Profile_Config;
+
+extern Bun_Profile_Config bun_profile_config;
+
+/*the function family called at a call site*/
+typedef Bun_U8 Bun_Profile_Kind;
+enum
+{
+    BUN_PROFILE_ALLOCATOR_ALLOC,
+    BUN_PROFILE_ALLOCATOR_RESIZE,
+    BUN_PROFILE_ARENA_ALLOC,
+    BUN_PROFILE_ARENA_RESIZE,
+    BUN_PROFILE_DYNAMIC_ARENA_PUSH,
+    BUN_PROFILE_DYNAMIC_ARENA_INSERT,
+    BUN_PROFILE_DYNAMIC_ARENA_RESIZE,
+    BUN_PROFILE_KIND_COUNT,
+};
+
+typedef struct
+{
+    const char *file;
+    Bun_U32 line;
+    Bun_Profile_Kind kind;
+    Bun_U64 count;      /*allocations since start or the last reset*/
+    Bun_U64 bytes;      /*bytes allocated since start or the last reset*/
+    Bun_U64 live_count; /*allocations not freed yet*/
+    Bun_U64 live_bytes;
+} Bun_Profile_Callsite;
+
+typedef Bun_U8 Bun_Profile_Report_Format;
+enum
+{
+    BUN_PROFILE_REPORT_TEXT,
+    BUN_PROFILE_REPORT_FOLDED_BYTES, /*folded stacks "file:line;function bytes", for flamegraph.pl or speedscope*/
+    BUN_PROFILE_REPORT_FOLDED_LIVE,  /*same with live bytes, sites with nothing live are left out*/
+};
+
+/*
+Copy the call sites, sorted by bytes allocated, biggest first.
+
+ARGS:
+    sites     - array to copy the call sites into.
+    max_sites - length of sites.
+RETURN:
+    number of call sites copied
+*/
+Bun_U32 Bun_Profile_Snapshot(Bun_Profile_Callsite *sites, Bun_U32 max_sites);
+/*
+Write every call site as text or folded stacks.
+
+ARGS:
+    format      - one of BUN_PROFILE_REPORT_*
+    buffer      - buffer to write the NULL terminated report into.
+    buffer_size - size in bytes of buffer.
+RETURN:
+    length of the report, or 0 if buffer is too small
+*/
+Bun_U32 Bun_Profile_Report(Bun_Profile_Report_Format format, char *buffer, Bun_U32 buffer_size);
+/*
+Zero the counts and bytes of every call site, live counts and bytes are kept.
+*/
+void Bun_Profile_Reset(void);
+/*
+RETURN:
+    allocations recorded but not tracked as live, the live table was full
+    or their call site did not fit in the call site table
+*/
+Bun_U64 Bun_Profile_Dropped(void);
+
+/*called by the macros below*/
+void *Bun_Profile__Allocator_Alloc(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator, const char *file, Bun_U32 line);
+bool  Bun_Profile__Allocator_Free(void *ptr, Bun_Allocator *allocator);
+bool  Bun_Profile__Allocator_Free_All(Bun_Allocator *allocator);
+void *Bun_Profile__Allocator_Resize(void *ptr, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Allocator *allocator, const char *file, Bun_U32 line);
+void *Bun_Profile__Arena_Alloc(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena, const char *file, Bun_U32 line);
+void *Bun_Profile__Arena_Resize(void *old_memory, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Arena *arena, const char *file, Bun_U32 line);
+void  Bun_Profile__Arena_Free_All(Bun_Arena *arena);
+void  Bun_Profile__Arena_Deinit_From_Allocator(Bun_Arena *arena, Bun_Allocator *allocator);
+void *Bun_Profile__Dynamic_Arena_Alloc(Bun_USize size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena, Bun_Profile_Kind kind, const char *file, Bun_U32 line);
+void *Bun_Profile__Dynamic_Arena_Resize(void *old_memory, Bun_USize size, Bun_USize old_size, bool zeroed, Bun_U32 alignment, Bun_Dynamic_Arena *arena, const char *file, Bun_U32 line);
+void  Bun_Profile__Dynamic_Arena_Free_All(Bun_Dynamic_Arena *arena, bool zero_pools);
+void  Bun_Profile__Dynamic_Arena_Free_Pools(Bun_Dynamic_Arena *arena, Bun_U32 min_pools, bool zero_pools);
+void  Bun_Profile__Dynamic_Arena_Deinit(Bun_Dynamic_Arena *arena);
+
+#define Bun_Allocator_Alloc(size, zeroed, alignment, allocator)        Bun_Profile__Allocator_Alloc(size, zeroed, alignment, allocator, __FILE__, __LINE__)
+#define Bun_Allocator_Alloc_64(size, zeroed, alignment, allocator)     Bun_Profile__Allocator_Alloc(size, zeroed, alignment, allocator, __FILE__, __LINE__)
+#define Bun_Allocator_Alloc_Inline(size, zeroed, alignment, allocator) Bun_Profile__Allocator_Alloc(size, zeroed, alignment, allocator, __FILE__, __LINE__)
+#define Bun_Allocator_Free(ptr, allocator)        Bun_Profile__Allocator_Free(ptr, allocator)
+#define Bun_Allocator_Free_Inline(ptr, allocator) Bun_Profile__Allocator_Free(ptr, allocator)
+#define Bun_Allocator_Free_all(allocator)         Bun_Profile__Allocator_Free_All(allocator)
+#define Bun_Allocator_Resize(ptr, size, old_size, zeroed, alignment, allocator)        Bun_Profile__Allocator_Resize(ptr, size, old_size, zeroed, alignment, allocator, __FILE__, __LINE__)
+#define Bun_Allocator_Resize_64(ptr, size, old_size, zeroed, alignment, allocator)     Bun_Profile__Allocator_Resize(ptr, size, old_size, zeroed, alignment, allocator, __FILE__, __LINE__)
+#define Bun_Allocator_Resize_Inline(ptr, size, old_size, zeroed, alignment, allocator) Bun_Profile__Allocator_Resize(ptr, size, old_size, zeroed, alignment, allocator, __FILE__, __LINE__)
+
+#define Bun_Arena_Alloc(size, zeroed, alignment, arena)        Bun_Profile__Arena_Alloc(size, zeroed, alignment, arena, __FILE__, __LINE__)
+#define Bun_Arena_Alloc_Inline(size, zeroed, alignment, arena) Bun_Profile__Arena_Alloc(size, zeroed, alignment, arena, __FILE__, __LINE__)
+#define Bun_Arena_Resize(old_memory, size, old_size, zeroed, alignment, arena) Bun_Profile__Arena_Resize(old_memory, size, old_size, zeroed, alignment, arena, __FILE__, __LINE__)
+#define Bun_Arena_Free_All(arena) Bun_Profile__Arena_Free_All(arena)
+#define Bun_Arena_Deinit_From_Allocator(arena, allocator) Bun_Profile__Arena_Deinit_From_Allocator(arena, allocator)
+
+#define Bun_Dynamic_Arena_Alloc_Push(size, zeroed, alignment, arena)   Bun_Profile__Dynamic_Arena_Alloc(size, zeroed, alignment, arena, BUN_PROFILE_DYNAMIC_ARENA_PUSH, __FILE__, __LINE__)
+#define Bun_Dynamic_Arena_Alloc_Inline(size, zeroed, alignment, arena) Bun_Profile__Dynamic_Arena_Alloc(size, zeroed, alignment, arena, BUN_PROFILE_DYNAMIC_ARENA_PUSH, __FILE__, __LINE__)
+#define Bun_Dynamic_Arena_Alloc_Insert(size, zeroed, alignment, arena) Bun_Profile__Dynamic_Arena_Alloc(size, zeroed, alignment, arena, BUN_PROFILE_DYNAMIC_ARENA_INSERT, __FILE__, __LINE__)
+#define Bun_Dynamic_Arena_Resize(old_memory, size, old_size, zeroed, alignment, arena) Bun_Profile__Dynamic_Arena_Resize(old_memory, size, old_size, zeroed, alignment, arena, __FILE__, __LINE__)
+#define Bun_Dynamic_Arena_Free_All(arena, zero_pools)              Bun_Profile__Dynamic_Arena_Free_All(arena, zero_pools)
+#define Bun_Dynamic_Arena_Free_Pools(arena, min_pools, zero_pools) Bun_Profile__Dynamic_Arena_Free_Pools(arena, min_pools, zero_pools)
+#define Bun_Dynamic_Arena_Deinit(arena)                            Bun_Profile__Dynamic_Arena_Deinit(arena)
+
+#ifdef BUN_STRIP_PREFIX
+#    define PROFILE_MAX_CALLSITES BUN_PROFILE_MAX_CALLSITES
+#    define PROFILE_MAX_LIVE BUN_PROFILE_MAX_LIVE
+#    define Profile_Config Bun_Profile_Config
+#    define profile_config bun_profile_config
+#    define Profile_Kind Bun_Profile_Kind
+#        define PROFILE_ALLOCATOR_ALLOC BUN_PROFILE_ALLOCATOR_ALLOC
+#        define PROFILE_ALLOCATOR_RESIZE BUN_PROFILE_ALLOCATOR_RESIZE
+#        define PROFILE_ARENA_ALLOC BUN_PROFILE_ARENA_ALLOC
+#        define PROFILE_ARENA_RESIZE BUN_PROFILE_ARENA_RESIZE
+#        define PROFILE_DYNAMIC_ARENA_PUSH BUN_PROFILE_DYNAMIC_ARENA_PUSH
+#        define PROFILE_DYNAMIC_ARENA_INSERT BUN_PROFILE_DYNAMIC_ARENA_INSERT
+#        define PROFILE_DYNAMIC_ARENA_RESIZE BUN_PROFILE_DYNAMIC_ARENA_RESIZE
+#        define PROFILE_KIND_COUNT BUN_PROFILE_KIND_COUNT
+#    define Profile_Callsite Bun_Profile_Callsite
+#    define Profile_Report_Format Bun_Profile_Report_Format
+#        define PROFILE_REPORT_TEXT BUN_PROFILE_REPORT_TEXT
+#        define PROFILE_REPORT_FOLDED_BYTES BUN_PROFILE_REPORT_FOLDED_BYTES
+#        define PROFILE_REPORT_FOLDED_LIVE BUN_PROFILE_REPORT_FOLDED_LIVE
+#    define Profile_Snapshot Bun_Profile_Snapshot
+#    define Profile_Report Bun_Profile_Report
+#    define Profile_Reset Bun_Profile_Reset
+#    define Profile_Dropped Bun_Profile_Dropped
+#endif /*ifdef BUN_STRIP_PREFIX*/
+#endif /*ifdef BUN_PROFILE_CALLSITES*/
@@ -1,21 +1,21 @@
-Bun_String Bun_String_Alias(const char *cstring, Bun_U32 len)
+Bun_String Bun_String_Alias(const char *cstring, Bun_USize len)
 {
-    if (!len) len = (Bun_U32)strlen(cstring);
+    if (!len) len = strlen(cstring);
     return (Bun_String){
         .ptr = (char*)cstring,
         .len = len
     };
 }
 
-Bun_String Bun_String_Copy(const char *cstring, Bun_U32 len, Bun_Allocator *allocator)
+Bun_String Bun_String_Copy(const char *cstring, Bun_USize len, Bun_Allocator *allocator)
 {
     Bun_String string = {0};
 
     if (cstring == NULL) return string;
 
-    if (!len) len = (Bun_U32)strlen(cstring);
+    if (!len) len = strlen(cstring);
     string = (Bun_String){
-        .ptr = Bun_Allocator_Alloc(len, false, 1, allocator),
+        .ptr = (Bun_Allocator_Alloc_64)(len, false, 1, allocator),
         .len = len
     };
     if (string.ptr == NULL) return string;
@@ -33,3 +33,68 @@ bool Bun_String_Is_Null_Terminated(Bun_String string)
 {
     return string.ptr && string.ptr[string.len] == '\0';
 }
+
+Bun_String_Buffer Bun_String_Buffer_From(char *ptr, Bun_U32 capacity)
+{
+    if (ptr != NULL && capacity) ptr[0] = '\0';
+    return (Bun_String_Buffer){
+        .ptr = ptr,
+        .len = 0,
+        .capacity = (ptr != NULL) ? capacity : 0,
+        .overflow = false,
+    };
+}
+
+void Bun_String_Buffer_Append(Bun_String_Buffer *buffer, const char *cstring)
+{
+    Bun_U32 len, room;
+
+    if (cstring == NULL || buffer->capacity == 0) return;
+
+    len = (Bun_U32)strlen(cstring);
+    room = buffer->capacity - 1 - buffer->len;
+    if (len > room)
+    {
+        len = room;
+        buffer->overflow = true;
+    }
+    memcpy(buffer->ptr + buffer->len, cstring, len);
+    buffer->len += len;
+    buffer->ptr[buffer->len] = '\0';
+}
+
+void Bun_String_Buffer_Append_U64(Bun_String_Buffer *buffer, Bun_U64 value)
+{
+    char digits[21];
+    int i = sizeof(digits) - 1;
+
+    digits[i] = '\0';
+    do
+    {
+        digits[--i] = '0' + (char)(value % 10);
+        value /= 10;
+    } while (value);
+    Bun_String_Buffer_Append(buffer, &digits[i]);
+}
+
+bool Bun_String_Parse_U64(Bun_String *string, Bun_U64 *value)
+{
+    Bun_USize i = 0;
+    Bun_U64 result = 0;
+
+    while (i < string->len && (string->ptr[i] == ' ' || string->ptr[i] == '\t' || string->ptr[i] == '\n' || string->ptr[i] == '\r'))
+        i++;
+    if (i == string->len || string->ptr[i] < '0' || string->ptr[i] > '9') return false;
+
+    while (i < string->len && string->ptr[i] >= '0' && string->ptr[i] <= '9')
+    {
+        Bun_U64 digit = (Bun_U64)(string->ptr[i] - '0');
+        if (result > (UINT64_MAX - digit) / 10) return false;
+        result = result*10 + digit;
+        i++;
+    }
+    string->ptr += i;
+    string->len -= i;
+    *value = result;
+    return true;
+}
@@ -1,7 +1,7 @@
 typedef struct
 {
     char *ptr;
-    Bun_U32 len;
+    Bun_USize len;
 } Bun_String;
 
 /*
@@ -11,9 +11,9 @@ ARGS:
     cstring - NULL terminated string.
     len     - length of cstring or 0 to use strlen(cstring)
 RETURN:
-    string with .ptr == cstring and .len == *len* or (U32)strlen(cstring)
+    string with .ptr == cstring and .len == *len* or strlen(cstring)
 */
-Bun_String Bun_String_Alias(const char *cstring, Bun_U32 len);
+Bun_String Bun_String_Alias(const char *cstring, Bun_USize len);
 /*
 Copy cstring to a new string using the provided allocator.
 
@@ -22,9 +22,9 @@ ARGS:
     len       - length of cstring or 0 to use strlen(cstring)
     allocator - A valid allocator that supports ALLOCATOR_MODE_ALLOC.
 RETURN:
-    string with .ptr == cstring and .len == *len* or (U32)strlen(cstring)
+    string with .ptr == cstring and .len == *len* or strlen(cstring)
 */
-Bun_String String_Copy(const char *cstring, Bun_U32 len, Bun_Allocator *allocator);
+Bun_String Bun_String_Copy(const char *cstring, Bun_USize len, Bun_Allocator *allocator);
 /*
 Dublicate string using the provided allocator.
 
@@ -45,11 +45,49 @@ RETURN:
 */
 bool Bun_String_Is_Null_Terminated(Bun_String string);
 
+/*
+Text written into a fixed caller provided buffer, kept NULL terminated.
+Writes that do not fit are truncated and set *overflow*.
+*/
+typedef struct
+{
+    char *ptr;
+    Bun_U32 len;
+    Bun_U32 capacity;
+    bool overflow;
+} Bun_String_Buffer;
+
+/*
+ARGS:
+    ptr      - memory to write into.
+    capacity - size in bytes of ptr, including room for the NULL terminator.
+RETURN:
+    an empty string buffer writing into ptr
+*/
+Bun_String_Buffer Bun_String_Buffer_From(char *ptr, Bun_U32 capacity);
+void Bun_String_Buffer_Append(Bun_String_Buffer *buffer, const char *cstring);
+void Bun_String_Buffer_Append_U64(Bun_String_Buffer *buffer, Bun_U64 value);
+/*
+Parse an unsigned decimal number from the start of string, skipping leading
+whitespace, and advance string past it.
+
+ARGS:
+    string - string to parse from, advanced on success.
+    value  - parsed number.
+RETURN:
+    true if a number was parsed, false otherwise or when it overflows 64 bits
+*/
+bool Bun_String_Parse_U64(Bun_String *string, Bun_U64 *value);
 
 #ifdef BUN_STRIP_PREFIX
 #    define String Bun_String
 #    define String_Alias Bun_String_Alias
-#    define String_Copy Bun_String String_Copy
+#    define String_Copy Bun_String_Copy
 #    define String_Duplicate Bun_String_Duplicate
 #    define String_Is_Null_Terminated Bun_String_Is_Null_Terminated
+#    define String_Buffer Bun_String_Buffer
+#    define String_Buffer_From Bun_String_Buffer_From
+#    define String_Buffer_Append Bun_String_Buffer_Append
+#    define String_Buffer_Append_U64 Bun_String_Buffer_Append_U64
+#    define String_Parse_U64 Bun_String_Parse_U64
 #endif /*ifdef BUN_STRIP_PREFIX*/
@@ -0,0 +1,223 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(BUN_NO_THREADS)
+#    define BUN_ZERO__THREADS
+#    include <pthread.h>
+#endif
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+Bun_Zero_Config bun_zero_config = (Bun_Zero_Config){
+    .non_temporal_threshold = 1u << 20,  /*bigger then most L2 caches*/
+    .parallel_threshold     = 64u << 20, /*below this thread wakeups dominate*/
+    .max_threads            = 4,
+};
+
+/*
+memset with streaming stores, the range is not pulled into the cache.
+*/
+static void Bun_Zero__Stream(Bun_Byte *ptr, uintptr_t size)
+{
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    uintptr_t head = Bun_Align_Formula((uintptr_t)ptr, 64) - (uintptr_t)ptr;
+
+    if (head > size) head = size;
+    memset(ptr, 0, head);
+    ptr += head;
+    size -= head;
+
+    while (size >= 64)
+    {
+        _mm_stream_si128((__m128i *)(ptr +  0), zero);
+        _mm_stream_si128((__m128i *)(ptr + 16), zero);
+        _mm_stream_si128((__m128i *)(ptr + 32), zero);
+        _mm_stream_si128((__m128i *)(ptr + 48), zero);
+        ptr += 64;
+        size -= 64;
+    }
+    /*streaming stores are weakly ordered, make them visible before returning*/
+    _mm_sfence();
+    memset(ptr, 0, size);
+#else
+    memset(ptr, 0, size);
+#endif
+}
+
+static void Bun_Zero__Range(Bun_Byte *ptr, uintptr_t size)
+{
+    if (bun_zero_config.non_temporal_threshold && size >= bun_zero_config.non_temporal_threshold)
+        Bun_Zero__Stream(ptr, size);
+    else
+        memset(ptr, 0, size);
+}
+
+#ifdef BUN_ZERO__THREADS
+/*
+Helper threads sleep on *work* and wake up when *generation* changes, helper
+N zeroes chunk N of the current job, the calling thread always takes chunk 0.
+They are joinable, Bun_Memory_Zero_Stop_Threads (also run at exit) sets
+*stop* and joins them.
+*/
+static struct
+{
+    pthread_mutex_t dispatch; /*one parallel zero at a time*/
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_cond_t done;
+
+    Bun_U32 thread_count;
+    Bun_U32 start_generation[BUN_ZERO_MAX_THREADS];
+    pthread_t threads[BUN_ZERO_MAX_THREADS];
+    bool stop;
+    bool stop_at_exit; /*atexit handler registered*/
+
+    Bun_U32 generation;
+    Bun_Byte *ptr;
+    uintptr_t size;
+    uintptr_t chunk_size;
+    Bun_U32 chunk_count;
+    Bun_U32 pending;
+} bun_zero_pool = {
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+};
+
+/*
+Chunk N ends on the N+1th page boundary after ptr, chunk_size is a multiple of
+the page size so no two chunks touch the same page.
+*/
+static void Bun_Zero__Chunk(Bun_Byte *ptr, uintptr_t size, uintptr_t chunk_size, Bun_U32 index)
+{
+    uintptr_t head = Bun_Align_Formula((uintptr_t)ptr, 4096) - (uintptr_t)ptr;
+    uintptr_t start = (index == 0) ? 0 : head + chunk_size * index;
+    uintptr_t end = head + chunk_size * (index + 1);
+
+    if (start >= size) return;
+    if (end > size) end = size;
+    Bun_Zero__Range(ptr + start, end - start);
+}
+
+static void *Bun_Zero__Helper(void *arg)
+{
+    Bun_U32 index = (Bun_U32)(uintptr_t)arg;
+    Bun_U32 seen;
+    Bun_Byte *ptr;
+    uintptr_t size, chunk_size;
+
+    pthread_mutex_lock(&bun_zero_pool.lock);
+    seen = bun_zero_pool.start_generation[index];
+    for (;/*ever*/;)
+    {
+        while (bun_zero_pool.generation == seen && !bun_zero_pool.stop)
+            pthread_cond_wait(&bun_zero_pool.work, &bun_zero_pool.lock);
+        if (bun_zero_pool.stop) break;
+        seen = bun_zero_pool.generation;
+        if (index >= bun_zero_pool.chunk_count) continue;
+
+        ptr = bun_zero_pool.ptr;
+        size = bun_zero_pool.size;
+        chunk_size = bun_zero_pool.chunk_size;
+        pthread_mutex_unlock(&bun_zero_pool.lock);
+
+        Bun_Zero__Chunk(ptr, size, chunk_size, index);
+
+        pthread_mutex_lock(&bun_zero_pool.lock);
+        if (--bun_zero_pool.pending == 0) pthread_cond_signal(&bun_zero_pool.done);
+    }
+    pthread_mutex_unlock(&bun_zero_pool.lock);
+    return NULL;
+}
+
+static void Bun_Zero__Stop_At_Exit(void)
+{
+    Bun_Memory_Zero_Stop_Threads();
+}
+
+static bool Bun_Zero__Parallel(Bun_Byte *ptr, uintptr_t size)
+{
+    Bun_U32 threads = (bun_zero_config.max_threads > BUN_ZERO_MAX_THREADS) ? BUN_ZERO_MAX_THREADS : bun_zero_config.max_threads;
+    Bun_U32 chunk_count;
+    uintptr_t chunk_size;
+
+    if (threads < 2) return false;
+    /*someone else is using the helpers, just do it ourselves*/
+    if (pthread_mutex_trylock(&bun_zero_pool.dispatch) != 0) return false;
+
+    pthread_mutex_lock(&bun_zero_pool.lock);
+    if (!bun_zero_pool.stop_at_exit) bun_zero_pool.stop_at_exit = (atexit(&Bun_Zero__Stop_At_Exit) == 0);
+    while (bun_zero_pool.thread_count < threads-1)
+    {
+        Bun_U32 index = bun_zero_pool.thread_count + 1;
+
+        bun_zero_pool.start_generation[index] = bun_zero_pool.generation;
+        if (pthread_create(&bun_zero_pool.threads[index], NULL, &Bun_Zero__Helper, (void *)(uintptr_t)index) != 0) break;
+        bun_zero_pool.thread_count += 1;
+    }
+    chunk_count = (bun_zero_pool.thread_count+1 < threads) ? bun_zero_pool.thread_count+1 : threads;
+    if (chunk_count < 2)
+    {
+        pthread_mutex_unlock(&bun_zero_pool.lock);
+        pthread_mutex_unlock(&bun_zero_pool.dispatch);
+        return false;
+    }
+    chunk_size = Bun_Align_Formula((size + chunk_count - 1) / chunk_count, 4096);
+
+    bun_zero_pool.ptr = ptr;
+    bun_zero_pool.size = size;
+    bun_zero_pool.chunk_size = chunk_size;
+    bun_zero_pool.chunk_count = chunk_count;
+    bun_zero_pool.pending = chunk_count - 1;
+    bun_zero_pool.generation += 1;
+    pthread_cond_broadcast(&bun_zero_pool.work);
+    pthread_mutex_unlock(&bun_zero_pool.lock);
+
+    Bun_Zero__Chunk(ptr, size, chunk_size, 0);
+
+    pthread_mutex_lock(&bun_zero_pool.lock);
+    while (bun_zero_pool.pending)
+        pthread_cond_wait(&bun_zero_pool.done, &bun_zero_pool.lock);
+    pthread_mutex_unlock(&bun_zero_pool.lock);
+
+    pthread_mutex_unlock(&bun_zero_pool.dispatch);
+    return true;
+}
+#endif /*ifdef BUN_ZERO__THREADS*/
+
+Bun_U32 Bun_Memory_Zero_Stop_Threads(void)
+{
+#ifdef BUN_ZERO__THREADS
+    Bun_U32 count, i;
+
+    /*waits for a parallel zero in flight*/
+    pthread_mutex_lock(&bun_zero_pool.dispatch);
+    pthread_mutex_lock(&bun_zero_pool.lock);
+    count = bun_zero_pool.thread_count;
+    bun_zero_pool.stop = true;
+    pthread_cond_broadcast(&bun_zero_pool.work);
+    pthread_mutex_unlock(&bun_zero_pool.lock);
+
+    for (i = 1; i <= count; i++) pthread_join(bun_zero_pool.threads[i], NULL);
+
+    pthread_mutex_lock(&bun_zero_pool.lock);
+    bun_zero_pool.thread_count = 0;
+    bun_zero_pool.stop = false;
+    pthread_mutex_unlock(&bun_zero_pool.lock);
+    pthread_mutex_unlock(&bun_zero_pool.dispatch);
+    return count;
+#else
+    return 0;
+#endif
+}
+
+void Bun_Memory_Zero(void *ptr, uintptr_t size)
+{
+    if (ptr == NULL || size == 0) return;
+#ifdef BUN_ZERO__THREADS
+    if (bun_zero_config.parallel_threshold && size >= bun_zero_config.parallel_threshold
+    &&  Bun_Zero__Parallel(ptr, size)
+    ) return;
+#endif
+    Bun_Zero__Range(ptr, size);
+}
@@ -0,0 +1,51 @@
+/*
+Zeroing engine used by arenas and allocators.
+
+Small ranges are a plain memset. Ranges above *non_temporal_threshold* are
+written with streaming stores that bypass the cache, so resetting a big pool
+does not evict data that is actually going to be read. Ranges above
+*parallel_threshold* are split between the caller and a pool of helper threads
+(spawned on first use, joined at exit or by Bun_Memory_Zero_Stop_Threads).
+NOTE: the helpers are pthreads, link with -lpthread where libc does not
+      include it (glibc before 2.34...), or define BUN_NO_THREADS.
+*/
+typedef struct
+{
+    uintptr_t non_temporal_threshold; /*bytes, 0 disables streaming stores*/
+    uintptr_t parallel_threshold;     /*bytes, 0 disables helper threads*/
+    Bun_U32 max_threads;              /*including the calling thread*/
+} Bun_Zero_Config;
+
+/*
+Tune the thresholds, changes take effect on the next call to Bun_Memory_Zero.
+max_threads is capped at BUN_ZERO_MAX_THREADS.
+*/
+extern Bun_Zero_Config bun_zero_config;
+
+#define BUN_ZERO_MAX_THREADS 16
+
+/*
+Set *size* bytes at *ptr* to zero.
+
+ARGS:
+    ptr  - start of the range.
+    size - size in bytes of the range.
+*/
+void Bun_Memory_Zero(void *ptr, uintptr_t size);
+/*
+Stop and join the helper threads, the next parallel zero spawns them again.
+Call it before unloading a shared library holding the implementation, it is
+registered with atexit for the main program.
+
+RETURN:
+    number of helper threads stopped
+*/
+Bun_U32 Bun_Memory_Zero_Stop_Threads(void);
+
+#ifdef BUN_STRIP_PREFIX
+#    define Zero_Config Bun_Zero_Config
+#    define zero_config bun_zero_config
+#    define ZERO_MAX_THREADS BUN_ZERO_MAX_THREADS
+#    define Memory_Zero Bun_Memory_Zero
+#    define Memory_Zero_Stop_Threads Bun_Memory_Zero_Stop_Threads
+#endif /*ifdef BUN_STRIP_PREFIX*/
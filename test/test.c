@@ -3,11 +3,1087 @@
 #include "bun.h"
 
 #include <stdio.h>
+#include <sys/wait.h>
+#include <pthread.h>
 
 #define ASCII_START ' '
 #define ASCII_END '~'
 #define ASCII_RANGE (ASCII_END - ASCII_START)
 
+#define CHECK(cond) do { if (!(cond)) { printf("%s:%d: check failed '%s'\n", __FILE__, __LINE__, #cond); return 1; } } while (0)
+
+int test_numa(void)
+{
+    Numa_Allocator numa;
+    Allocator allocator;
+    Dynamic_Arena arena;
+    void *ptr;
+    Byte *a, *b, *c, *d;
+
+    /* pretend to be a 2 node machine running on node 1 */
+    Numa_Simulate(2, 1);
+    CHECK(Numa_Node_Count() == 2);
+
+    Numa_Allocator_Init(&numa, NUMA_NODE_LOCAL);
+    allocator = Numa_Allocator_Interface(&numa);
+    CHECK(Dynamic_Arena_Init(&arena, &allocator, 4096, false, 64));
+
+    ptr = Dynamic_Arena_Alloc_Push(100, true, 64, &arena);
+    CHECK(ptr != NULL);
+    CHECK(Numa_Allocation_Node(arena.pools[0].buffer) == 1);
+
+    Dynamic_Arena_Deinit(&arena);
+
+    /* small blocks share chunks, freed slots are reused and zeroed again when asked */
+    a = Allocator_Alloc(100, false, 16, &allocator);
+    b = Allocator_Alloc(100, false, 16, &allocator);
+    CHECK(a != NULL && b != NULL && (uintptr_t)a % 16 == 0);
+    CHECK(a + (1 << 20) > b && b + (1 << 20) > a);
+    memset(a, 0xff, 100);
+    CHECK(Allocator_Free(a, &allocator));
+    CHECK(Allocator_Alloc(100, true, 16, &allocator) == a);
+    CHECK(a[0] == 0 && a[99] == 0);
+    memset(a, 0xff, 100);
+    a = Allocator_Resize(a, 1000, 100, true, 16, &allocator);
+    CHECK(a != NULL && a[99] == 0xff && a[100] == 0 && a[999] == 0);
+    CHECK(Numa_Allocation_Node(a) == 1);
+
+    /* slots stay on their node */
+    Numa_Simulate(2, 0);
+    c = Allocator_Alloc(100, false, 16, &allocator);
+    CHECK(c != NULL && c != b && Numa_Allocation_Node(c) == 0);
+    CHECK(Allocator_Free(b, &allocator));
+    CHECK(Allocator_Alloc(100, false, 16, &allocator) != b);
+
+    /* big and over aligned blocks get mappings of their own */
+    d = Allocator_Alloc(1 << 16, true, 4096, &allocator);
+    CHECK(d != NULL && (uintptr_t)d % 4096 == 0 && d[(1 << 16) - 1] == 0);
+    CHECK(Allocator_Free(d, &allocator));
+    CHECK(Allocator_Free(a, &allocator));
+    CHECK(Allocator_Free(c, &allocator));
+    Numa_Simulate(0, 0);
+    return 0;
+}
+
+int test_size_header(void)
+{
+    Dynamic_Arena arena;
+    char *a, *b, *c;
+
+    CHECK(Dynamic_Arena_Init(&arena, &allocator_libc, 256, false, 16));
+    arena.flags |= ARENA_FLAG_SIZE_HEADER;
+
+    a = Dynamic_Arena_Alloc_Push(10, true, 1, &arena);
+    CHECK(a != NULL && Arena_Allocation_Size(a) == 10);
+
+    /* last allocation of its pool grows in place without knowing old_size */
+    b = Dynamic_Arena_Resize(a, 20, 0, true, 1, &arena);
+    CHECK(b == a && Arena_Allocation_Size(b) == 20);
+
+    /* not the last allocation anymore, so it has to move */
+    c = Dynamic_Arena_Alloc_Push(8, true, 1, &arena);
+    b = Dynamic_Arena_Resize(a, 40, 0, true, 1, &arena);
+    CHECK(b != a && c != NULL && Arena_Allocation_Size(b) == 40);
+
+    /* after a free all, insert fills pools past pool_offset and resize finds them there */
+    CHECK(Dynamic_Arena_Alloc_Push(200, true, 1, &arena) != NULL && arena.pool_offset == 1);
+    Dynamic_Arena_Free_All(&arena, false);
+    CHECK(Dynamic_Arena_Alloc_Push(230, true, 1, &arena) != NULL);
+    a = Dynamic_Arena_Alloc_Insert(20, true, 1, &arena);
+    CHECK(a != NULL && arena.pool_offset == 0 && a == (char *)arena.pools[1].buffer + sizeof(Arena_Size_Header));
+    b = Dynamic_Arena_Resize(a, 30, 0, true, 1, &arena);
+    CHECK(b == a && Arena_Allocation_Size(b) == 30);
+
+    Dynamic_Arena_Deinit(&arena);
+    return 0;
+}
+
+int test_large_objects(void)
+{
+    Dynamic_Arena arena;
+    char *small, *big, *after;
+
+    CHECK(Dynamic_Arena_Init(&arena, &allocator_libc, 256, false, 16));
+
+    small = Dynamic_Arena_Alloc_Push(16, true, 16, &arena);
+    big = Dynamic_Arena_Alloc_Push(4096, true, 16, &arena);
+    after = Dynamic_Arena_Alloc_Push(16, true, 16, &arena);
+
+    /* the big allocation stays out of the pools */
+    CHECK(big != NULL && arena.large != NULL && arena.pool_offset == 0);
+    CHECK(after == small + 16);
+
+    big = Dynamic_Arena_Resize(big, 8192, 4096, true, 16, &arena);
+    CHECK(big != NULL && arena.large->size == 8192 && arena.large->next == NULL);
+
+    arena.large_cache_limit = 1 << 16;
+    Dynamic_Arena_Free_All(&arena, false);
+    CHECK(arena.large == NULL && arena.large_cache != NULL);
+    CHECK(Dynamic_Arena_Alloc_Push(5000, true, 16, &arena) != NULL && arena.large_cache == NULL);
+
+    Dynamic_Arena_Free_Pools(&arena, 0, false);
+    Dynamic_Arena_Deinit(&arena);
+    return 0;
+}
+
+int test_memory_zero(void)
+{
+    Zero_Config saved = zero_config;
+    U32 sizes[] = {1, 63, 4097, 100000, 300001};
+    Byte *buffer;
+    U32 i, j, offset;
+
+    buffer = malloc(300001 + 256);
+    CHECK(buffer != NULL);
+
+    /* small thresholds so every path runs on test sized ranges */
+    zero_config.non_temporal_threshold = 4096;
+    zero_config.parallel_threshold = 65536;
+    zero_config.max_threads = 4;
+    for (i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++)
+    {
+        for (offset = 1; offset < 128; offset += 61) /* unaligned starts */
+        {
+            memset(buffer, 0xff, 300001 + 256);
+            Memory_Zero(buffer + offset, sizes[i]);
+            for (j = 0; j < sizes[i]; j++) CHECK(buffer[offset + j] == 0);
+            CHECK(buffer[offset - 1] == 0xff);
+            CHECK(buffer[offset + sizes[i]] == 0xff);
+        }
+    }
+
+    /* the parallel path spawned the helpers, they join and come back on next use */
+    CHECK(Memory_Zero_Stop_Threads() == 3);
+    CHECK(Memory_Zero_Stop_Threads() == 0);
+    memset(buffer, 0xff, 300001);
+    Memory_Zero(buffer, 300001);
+    for (j = 0; j < 300001; j++) CHECK(buffer[j] == 0);
+    CHECK(Memory_Zero_Stop_Threads() == 3);
+
+    /* a zero threshold disables the path, no helpers */
+    zero_config.parallel_threshold = 0;
+    zero_config.non_temporal_threshold = 0;
+    memset(buffer, 0xff, 300001);
+    Memory_Zero(buffer, 300001);
+    for (j = 0; j < 300001; j++) CHECK(buffer[j] == 0);
+    CHECK(Memory_Zero_Stop_Threads() == 0);
+
+    zero_config = saved;
+    free(buffer);
+    return 0;
+}
+
+int test_pool_cache(void)
+{
+    Numa_Allocator numa;
+    Allocator allocator;
+    Dynamic_Arena arena;
+    void *pool;
+
+    pool_cache_config.max_bytes = 1 << 20;
+
+    CHECK(Dynamic_Arena_Init(&arena, &allocator_libc, 4096, false, 16));
+    CHECK(Dynamic_Arena_Alloc_Push(100, true, 16, &arena) != NULL);
+    pool = arena.pools[0].buffer;
+    Dynamic_Arena_Deinit(&arena);
+    CHECK(Pool_Cache_Bytes() >= 4096);
+
+    /* the next short lived arena gets the same pool back */
+    CHECK(Dynamic_Arena_Init(&arena, &allocator_libc, 4096, false, 16));
+    CHECK(Dynamic_Arena_Alloc_Push(100, true, 16, &arena) != NULL);
+    CHECK(arena.pools[0].buffer == pool);
+    Dynamic_Arena_Deinit(&arena);
+
+    Pool_Cache_Trim(0);
+    CHECK(Pool_Cache_Bytes() == 0);
+
+    /* node local blocks only go back to threads on the node they were placed on */
+    Numa_Simulate(2, 1);
+    Numa_Allocator_Init(&numa, NUMA_NODE_LOCAL);
+    allocator = Numa_Allocator_Interface(&numa);
+    CHECK(Dynamic_Arena_Init(&arena, &allocator, 4096, false, 16));
+    CHECK(Dynamic_Arena_Alloc_Push(100, true, 16, &arena) != NULL);
+    pool = arena.pools[0].buffer;
+    Dynamic_Arena_Deinit(&arena);
+    CHECK(Pool_Cache_Bytes() >= 4096);
+
+    Numa_Simulate(2, 0);
+    CHECK(Dynamic_Arena_Init(&arena, &allocator, 4096, false, 16));
+    CHECK(Dynamic_Arena_Alloc_Push(100, true, 16, &arena) != NULL);
+    CHECK(arena.pools[0].buffer != pool);
+    CHECK(Numa_Allocation_Node(arena.pools[0].buffer) == 0);
+    Dynamic_Arena_Deinit(&arena);
+
+    Numa_Simulate(2, 1);
+    CHECK(Dynamic_Arena_Init(&arena, &allocator, 4096, false, 16));
+    CHECK(Dynamic_Arena_Alloc_Push(100, true, 16, &arena) != NULL);
+    CHECK(arena.pools[0].buffer == pool);
+    Dynamic_Arena_Deinit(&arena);
+
+    Pool_Cache_Trim(0);
+    Numa_Simulate(0, 0);
+    CHECK(Pool_Cache_Bytes() == 0);
+    pool_cache_config.max_bytes = 0;
+    return 0;
+}
+
+int test_stats(void)
+{
+    Dynamic_Arena arena;
+    Dynamic_Arena_Stats stats;
+    char report[1024];
+    void *a;
+
+    CHECK(Dynamic_Arena_Init(&arena, &allocator_libc, 256, false, 16));
+    a = Dynamic_Arena_Alloc_Push(10, false, 16, &arena);
+    CHECK(Dynamic_Arena_Alloc_Push(10, false, 16, &arena) != NULL);  /* 6 bytes of padding before it */
+    CHECK(Dynamic_Arena_Resize(a, 20, 10, false, 16, &arena) != a); /* abandons 10 bytes */
+    CHECK(Dynamic_Arena_Alloc_Push(200, false, 16, &arena) != NULL); /* strands the first pool's tail */
+
+    stats = Dynamic_Arena_Get_Stats(&arena);
+    CHECK(stats.pool_count == 2 && stats.reserved == 512);
+    CHECK(stats.abandoned == 10 && stats.padding == 12 && stats.live == 230);
+    CHECK(stats.stranded == 256 - 52 && stats.unused == 56);
+
+    CHECK(Dynamic_Arena_Report(&arena, ARENA_REPORT_JSON, report, sizeof(report)) != 0);
+    CHECK(Dynamic_Arena_Report(&arena, ARENA_REPORT_TEXT, report, sizeof(report)) != 0);
+    CHECK(Dynamic_Arena_Report(&arena, ARENA_REPORT_TEXT, report, 16) == 0);
+
+    Dynamic_Arena_Deinit(&arena);
+    return 0;
+}
+
+int test_file_arena(void)
+{
+    const char *tmpdir = getenv("TMPDIR");
+    char path[512];
+    File_Arena file_arena;
+    U32 *table;
+    int i, fd;
+
+    /* a fresh file under TMPDIR, so the test runs from any directory */
+    if (tmpdir == NULL || *tmpdir == '\0') tmpdir = "/tmp";
+    CHECK(strlen(tmpdir) < sizeof(path) - 32);
+    strcpy(path, tmpdir);
+    strcat(path, "/bun_test_file_arena_XXXXXX");
+    fd = mkstemp(path);
+    CHECK(fd >= 0);
+    close(fd);
+
+    CHECK(File_Arena_Create(&file_arena, path, 1 << 16, NULL));
+    table = Arena_Alloc(sizeof(U32)*256, false, 16, &file_arena.arena);
+    CHECK(table != NULL);
+    for (i = 0; i < 256; i++) table[i] = i*i;
+    CHECK(File_Arena_Commit(&file_arena));
+    File_Arena_Close(&file_arena);
+
+    CHECK(File_Arena_Open(&file_arena, path, FILE_ARENA_OPEN_READ_ONLY|FILE_ARENA_OPEN_VERIFY));
+    table = (U32 *)file_arena.arena.buffer;
+    CHECK(table[255] == 255*255);
+    CHECK(Arena_Alloc(1, false, 1, &file_arena.arena) == NULL);
+    File_Arena_Close(&file_arena);
+
+    /* copy on write changes stay in this process */
+    CHECK(File_Arena_Open(&file_arena, path, FILE_ARENA_OPEN_COPY_ON_WRITE));
+    ((U32 *)file_arena.arena.buffer)[0] = 42;
+    CHECK(Arena_Alloc(16, false, 1, &file_arena.arena) != NULL);
+    File_Arena_Close(&file_arena);
+    CHECK(File_Arena_Open(&file_arena, path, FILE_ARENA_OPEN_READ_ONLY|FILE_ARENA_OPEN_VERIFY));
+    CHECK(((U32 *)file_arena.arena.buffer)[0] == 0);
+    File_Arena_Close(&file_arena);
+
+    remove(path);
+    return 0;
+}
+
+int test_profile(void)
+{
+    Dynamic_Arena_Profile profile = {0}, imported;
+    Dynamic_Arena arena;
+    char text[512];
+    int i;
+
+    /* a workload that needs ~10 pools worth every lifetime */
+    CHECK(Dynamic_Arena_Init_Profiled(&arena, &allocator_libc, 1024, false, 16, &profile));
+    for (i = 0; i < 3; i++)
+    {
+        int j;
+        for (j = 0; j < 80; j++) CHECK(Dynamic_Arena_Alloc_Push(128, false, 16, &arena) != NULL);
+        Dynamic_Arena_Free_All(&arena, false);
+    }
+    CHECK(profile.count == 3 && Dynamic_Arena_Profile_Size(&profile) >= 80*128);
+    /* after a reset the arena starts with one pool big enough for all of it */
+    CHECK(arena.pools[0].buffer_size >= 80*128);
+    Dynamic_Arena_Deinit(&arena);
+
+    CHECK(Dynamic_Arena_Profile_Export(&profile, text, sizeof(text)) != 0);
+    CHECK(Dynamic_Arena_Profile_Import(&imported, text, 0));
+    CHECK(Dynamic_Arena_Profile_Size(&imported) == Dynamic_Arena_Profile_Size(&profile));
+    /* a percentile that only wraps to 100 past 64 bits is corrupt */
+    CHECK(!Dynamic_Arena_Profile_Import(&imported, "bun_dynamic_arena_profile 1 18446744073709551716 1 0 1024 1\n", 0));
+
+    /* a fresh process skips the warm up */
+    CHECK(Dynamic_Arena_Init_Profiled(&arena, &allocator_libc, 1024, false, 16, &imported));
+    CHECK(arena.pools[0].buffer_size >= 80*128);
+    Dynamic_Arena_Deinit(&arena);
+    return 0;
+}
+
+typedef struct Test_Node
+{
+    Rel32 next;
+    U32 value;
+} Test_Node;
+
+int test_offset_ptr(void)
+{
+    Arena arena, copy;
+    Test_Node *head = NULL, *node;
+    Off32 head_off;
+    U32 sum = 0;
+    int i;
+
+    Arena_Init_From_Allocator(&arena, &allocator_libc, 4096, true, 16);
+    Arena_Init_From_Allocator(&copy, &allocator_libc, 4096, true, 16);
+
+    for (i = 1; i <= 10; i++)
+    {
+        node = Arena_Alloc(sizeof(Test_Node), true, 4, &arena);
+        CHECK(Rel32_Set(&node->next, head));
+        node->value = i;
+        head = node;
+    }
+    CHECK(sizeof(Test_Node) == 8);
+    CHECK(Arena_Off32_Encode(&arena, head, &head_off));
+
+    /* the list survives a plain memcpy to another buffer */
+    memcpy(copy.buffer, arena.buffer, arena.offset);
+    copy.offset = arena.offset;
+    for (node = Arena_Off32_Decode(&copy, head_off); node; node = REL32_GET(Test_Node, node->next))
+    {
+        CHECK((Byte *)node >= copy.buffer && (Byte *)node < copy.buffer + copy.offset);
+        sum += node->value;
+    }
+    CHECK(sum == 55);
+
+    Arena_Deinit_From_Allocator(&arena, &allocator_libc);
+    Arena_Deinit_From_Allocator(&copy, &allocator_libc);
+    return 0;
+}
+
+int test_shared_arena(void)
+{
+    Shared_Arena shared, view;
+    int sockets[2], status;
+    Off32 *root;
+    U32 *values;
+    pid_t child;
+    int i;
+
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+    CHECK(Shared_Arena_Create(&shared, NULL, 1 << 16));
+    root = Shared_Arena_Alloc(sizeof(Off32), true, 4, &shared);
+    CHECK(root != NULL && (Byte *)root == shared.buffer);
+
+    child = fork();
+    CHECK(child >= 0);
+    if (child == 0)
+    {
+        /* the consumer maps the fd it was handed and allocates into the same arena */
+        if (!Shared_Arena_Open_Fd(&view, Shared_Arena_Receive_Fd(sockets[1]))) _exit(1);
+        values = Shared_Arena_Alloc(sizeof(U32)*64, false, 16, &view);
+        if (values == NULL) _exit(1);
+        for (i = 0; i < 64; i++) values[i] = i*3;
+        Off32_Encode(view.buffer, values, (Off32 *)view.buffer);
+        Shared_Arena_Close(&view, NULL);
+        _exit(0);
+    }
+    CHECK(Shared_Arena_Send_Fd(sockets[0], shared.fd));
+    CHECK(waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    /* the child's data is read in place, no copy */
+    values = Off32_Decode(shared.buffer, *root);
+    CHECK(values != NULL && values[63] == 63*3);
+    CHECK(Shared_Arena_Offset(&shared) >= 4 + sizeof(U32)*64);
+    CHECK(Shared_Arena_Alloc(1 << 16, false, 1, &shared) == NULL);
+
+    Shared_Arena_Close(&shared, NULL);
+    close(sockets[0]);
+    close(sockets[1]);
+    return 0;
+}
+
+int test_snapshot_arena(void)
+{
+    Snapshot_Arena snapshot_arena;
+    U32 *values, *extra;
+    U32 offset;
+    int i;
+
+    CHECK(Snapshot_Arena_Init(&snapshot_arena, 1 << 16));
+    values = Arena_Alloc(sizeof(U32)*4096, false, 16, &snapshot_arena.arena);
+    CHECK(values != NULL);
+    for (i = 0; i < 4096; i++) values[i] = i;
+    offset = snapshot_arena.arena.offset;
+
+    /* speculative changes are dropped on rollback */
+    CHECK(Snapshot_Arena_Snapshot(&snapshot_arena));
+    CHECK(!Snapshot_Arena_Snapshot(&snapshot_arena));
+    values[0] = 100;
+    values[4095] = 100;
+    CHECK(Arena_Alloc(64, false, 16, &snapshot_arena.arena) != NULL);
+    CHECK(Snapshot_Arena_Rollback(&snapshot_arena));
+    CHECK(values[0] == 0 && values[4095] == 4095 && snapshot_arena.arena.offset == offset);
+
+    /* and kept on commit */
+    CHECK(Snapshot_Arena_Snapshot(&snapshot_arena));
+    values[1] = 200;
+    extra = Arena_Alloc(sizeof(U32), false, 4, &snapshot_arena.arena);
+    CHECK(extra != NULL);
+    *extra = 300;
+    CHECK(Snapshot_Arena_Commit(&snapshot_arena));
+    CHECK(!Snapshot_Arena_Rollback(&snapshot_arena));
+    CHECK(values[1] == 200 && values[2] == 2 && *extra == 300);
+
+    /* a later rollback goes back to the committed state */
+    CHECK(Snapshot_Arena_Snapshot(&snapshot_arena));
+    values[1] = 0;
+    *extra = 0;
+    CHECK(Snapshot_Arena_Rollback(&snapshot_arena));
+    CHECK(values[1] == 200 && *extra == 300);
+
+    Snapshot_Arena_Deinit(&snapshot_arena);
+    return 0;
+}
+
+int test_compact_arena(void)
+{
+    static Compact_Handle many[2048];
+    Compact_Arena arena;
+    Compact_Handle handles[64], stale;
+    U32 *value;
+    int i, steps;
+
+    CHECK(Compact_Arena_Init(&arena, &allocator_libc, 256, 8));
+    for (i = 0; i < 64; i++)
+    {
+        handles[i] = Compact_Arena_Alloc(24, false, &arena);
+        value = Compact_Arena_Get(&arena, handles[i]);
+        CHECK(value != NULL);
+        *value = i;
+    }
+    CHECK(arena.arena.pool_offset == 7); /* 8 objects of 32 bytes per pool */
+
+    /* free 3 out of 4 and grow one, leaving most of the pools dead */
+    for (i = 0; i < 64; i++) if (i % 4) Compact_Arena_Free(handles[i], &arena);
+    CHECK(Compact_Arena_Resize(handles[0], 48, true, &arena));
+    stale = handles[1];
+    CHECK(Compact_Arena_Get(&arena, stale) == NULL);
+    CHECK(arena.dead == 48*32 + 32);
+
+    /* compact in one pass, allocating and freeing before it */
+    handles[1] = Compact_Arena_Alloc(24, false, &arena);
+    CHECK(Compact_Arena_Get(&arena, handles[1]) != NULL);
+    Compact_Arena_Free(handles[1], &arena);
+    Compact_Arena_Compact(&arena);
+    /* 15 objects of 32 bytes and the grown one of 56 fit 3 pools, one spare pool is kept */
+    CHECK(arena.dead == 0 && arena.arena.pool_offset == 2);
+    CHECK(arena.arena.pools[3].buffer != NULL && arena.arena.pools[4].buffer == NULL);
+
+    for (i = 0; i < 64; i += 4)
+    {
+        value = Compact_Arena_Get(&arena, handles[i]);
+        CHECK(value != NULL && *value == (U32)i);
+    }
+    /* freed slots are reused under a new generation, old handles stay stale */
+    handles[1] = Compact_Arena_Alloc(8, true, &arena);
+    CHECK(Compact_Arena_Get(&arena, handles[1]) != NULL);
+    CHECK(Compact_Arena_Get(&arena, stale) == NULL);
+    Compact_Arena_Deinit(&arena);
+
+    /* a 1ns budget spreads the work over a step per clock check, handles stay valid in between */
+    CHECK(Compact_Arena_Init(&arena, &allocator_libc, 4096, 64));
+    for (i = 0; i < 2048; i++)
+    {
+        many[i] = Compact_Arena_Alloc(40, false, &arena);
+        value = Compact_Arena_Get(&arena, many[i]);
+        CHECK(value != NULL && (uintptr_t)value % 64 == 0);
+        *value = i;
+    }
+    for (i = 0; i < 2048; i++) if (i % 4) Compact_Arena_Free(many[i], &arena);
+    steps = 0;
+    while (!Compact_Arena_Compact_Step(&arena, 1))
+    {
+        steps++;
+        for (i = 0; i < 2048; i += 4)
+        {
+            value = Compact_Arena_Get(&arena, many[i]);
+            CHECK(value != NULL && (uintptr_t)value % 64 == 0 && *value == (U32)i);
+        }
+        /* allocating between steps lands past the compacted part */
+        handles[1] = Compact_Arena_Alloc(40, false, &arena);
+        CHECK(Compact_Arena_Get(&arena, handles[1]) != NULL);
+        Compact_Arena_Free(handles[1], &arena);
+    }
+    CHECK(steps >= 2048 / 64 - 1);
+    Compact_Arena_Compact(&arena);
+    /* pools are 16 byte aligned by libc, objects keep their 64 byte alignment after moving */
+    for (i = 0; i < 2048; i += 4)
+    {
+        value = Compact_Arena_Get(&arena, many[i]);
+        CHECK(value != NULL && (uintptr_t)value % 64 == 0 && *value == (U32)i);
+    }
+    CHECK(arena.dead == 0 && arena.arena.pool_offset < 2048/4*128/4096 + 1);
+    Compact_Arena_Deinit(&arena);
+    return 0;
+}
+
+void *test_proc32(void *data, Allocator_Error *error, Allocator_Mode mode, U32 size, U32 alignment, void *old_memory, U32 old_size)
+{
+    *error = ALLOCATOR_ERROR_UNKNOWN; /* must not be reached */
+    return NULL;
+}
+
+int test_usize(void)
+{
+    static Byte backing[64];
+    Allocator allocator32 = allocator_libc;
+    Arena arena = {0};
+    USize big;
+
+    CHECK(Align_Formula(USIZE_MAX - 2, 16) == 0);
+    CHECK(Align_Formula(17, 16) == 32);
+    CHECK(Allocator_Alloc_64(USIZE_MAX - 2, false, 16, &allocator_libc) == NULL);
+    CHECK(allocator_libc.error == ALLOCATOR_ERROR_OUT_OF_MEMORY);
+    allocator_libc.error = ALLOCATOR_ERROR_NONE;
+
+    if (sizeof(USize) < 8) return 0;
+    big = (USize)1 << 32;
+
+    /* allocators without a proc64 refuse what their proc can not express */
+    allocator32.proc = &test_proc32;
+    allocator32.proc64 = NULL;
+    CHECK(Allocator_Alloc_64(big, false, 16, &allocator32) == NULL);
+    CHECK(allocator32.error == ALLOCATOR_ERROR_INVALID_ARGUMENT);
+
+    /* an arena over 4GB, bump allocation never touches the memory */
+    arena.buffer = backing;
+    arena.buffer_size = big * 3;
+    CHECK(Arena_Alloc(big + 16, false, 16, &arena) == backing);
+    CHECK(arena.offset == big + 16);
+    CHECK(Arena_Alloc(big * 2, false, 16, &arena) == NULL);
+    CHECK(Arena_Alloc(USIZE_MAX, false, 16, &arena) == NULL);
+
+    /* size headers are 32 bit */
+    Arena_Free_All(&arena);
+    arena.flags = ARENA_FLAG_SIZE_HEADER;
+    CHECK(Arena_Alloc(big, false, 16, &arena) == NULL);
+    return 0;
+}
+
+int test_inline_fast_paths(void)
+{
+    Allocator overridden;
+    Arena arena;
+    Dynamic_Arena dynamic;
+    Byte *a, *b;
+    int i;
+
+    Arena_Init_From_Allocator(&arena, &allocator_libc, 64, false, 16);
+    a = Arena_Alloc_Inline(3, false, 1, &arena);
+    b = Arena_Alloc_Inline(8, false, 8, &arena);
+    CHECK(a == arena.buffer && b == arena.buffer + 8);
+    CHECK(arena.offset == 16 && arena.padding == 5);
+    /* full and zeroed allocations take the slow path */
+    CHECK(Arena_Alloc_Inline(64, false, 8, &arena) == NULL);
+    a = Arena_Alloc_Inline(8, true, 8, &arena);
+    CHECK(a == arena.buffer + 16 && a[0] == 0);
+    Arena_Deinit_From_Allocator(&arena, &allocator_libc);
+
+    /* the dynamic fast path falls back to alloc_push for new pools */
+    CHECK(Dynamic_Arena_Init(&dynamic, &allocator_libc, 256, false, 16));
+    for (i = 0; i < 40; i++) CHECK(Dynamic_Arena_Alloc_Inline(16, false, 16, &dynamic) != NULL);
+    CHECK(dynamic.pool_offset == 2 && dynamic.pools[2].offset == 8*16);
+    Dynamic_Arena_Deinit(&dynamic);
+
+    /* the libc allocator is called through its ops */
+    CHECK(allocator_libc.ops != NULL);
+    a = Allocator_Alloc_Inline(32, true, 16, &allocator_libc);
+    CHECK(a != NULL && a[31] == 0);
+    a = Allocator_Resize_Inline(a, 64, 32, true, 16, &allocator_libc);
+    CHECK(a != NULL && a[63] == 0);
+    CHECK(Allocator_Free_Inline(a, &allocator_libc));
+
+    /* a copy with its own proc or fewer modes does not keep the libc ops */
+    overridden = allocator_libc;
+    overridden.proc = &test_proc32;
+    overridden.proc64 = NULL;
+    CHECK(Allocator_Alloc_Inline(32, true, 16, &overridden) == NULL);
+    CHECK(overridden.error == ALLOCATOR_ERROR_UNKNOWN);
+    overridden = allocator_libc;
+    overridden.implemented_modes &= ~ALLOCATOR_MODE_RESIZE;
+    a = Allocator_Alloc_Inline(32, true, 16, &overridden);
+    CHECK(a != NULL);
+    CHECK(Allocator_Resize_Inline(a, 64, 32, true, 16, &overridden) == NULL);
+    CHECK(overridden.error == ALLOCATOR_ERROR_MODE_NOT_IMPLEMENTED);
+    CHECK(Allocator_Free_Inline(a, &overridden));
+    return 0;
+}
+
+typedef struct { double x, y, z; } Vec3;
+POOL_DEFINE(Vec3)
+ARENA_DEFINE(Vec3)
+
+int test_typed_pool(void)
+{
+    Vec3_Pool pool;
+    Vec3_Pool_Iter iter;
+    Vec3 *objects[200], *v, init = {1, 2, 3};
+    Dynamic_Arena arena;
+    int i, seen;
+
+    CHECK(Vec3_POOL_SIZE == sizeof(Vec3) && Vec3_POOL_ALIGN == ALIGN_OF(double));
+
+    Vec3_Pool_Init(&pool, &allocator_libc);
+    v = Vec3_Pool_Alloc(&pool);
+    CHECK(v != NULL && v->x == 0 && v->z == 0);
+    CHECK(Vec3_Pool_Alloc_Batch(&pool, 199, &init, &objects[1]) == 199);
+    objects[0] = v;
+    CHECK(pool.count == 200 && pool.chunk_count == 4);
+    CHECK(objects[100]->y == 2);
+
+    /* free every other object, the iterator only sees the rest */
+    for (i = 0; i < 200; i += 2) CHECK(Vec3_Pool_Free(&pool, objects[i]));
+    CHECK(!Vec3_Pool_Free(&pool, objects[0]) && !Vec3_Pool_Free(&pool, &init));
+    for (seen = 0, iter = Vec3_Pool_Iter_Begin(&pool); (v = Vec3_Pool_Iter_Next(&iter)) != NULL; seen++)
+        CHECK(v->x == 1);
+    CHECK(seen == 100 && pool.count == 100 && pool.hint == 0);
+
+    /* freed slots are reused before new chunks */
+    for (i = 0; i < 100; i++) CHECK(Vec3_Pool_Alloc(&pool) != NULL);
+    CHECK(pool.chunk_count == 4 && Vec3_Pool_Alloc(&pool) != NULL && pool.chunk_count == 4);
+
+    Vec3_Pool_Free_All(&pool);
+    iter = Vec3_Pool_Iter_Begin(&pool);
+    CHECK(pool.count == 0 && Vec3_Pool_Iter_Next(&iter) == NULL);
+    Vec3_Pool_Deinit(&pool);
+    CHECK(pool.chunks == NULL && pool.chunk_count == 0);
+
+    CHECK(Dynamic_Arena_Init(&arena, &allocator_libc, 1024, false, 16));
+    v = Vec3_Arena_Push(&arena);
+    CHECK(v != NULL && v->x == 0 && (uintptr_t)v % ALIGN_OF(Vec3) == 0);
+    v = Vec3_Arena_Push_Array(10, true, &arena);
+    CHECK(v != NULL && v[9].z == 0);
+    CHECK(Vec3_Arena_Push_Array(USIZE_MAX / 8, false, &arena) == NULL);
+    Dynamic_Arena_Deinit(&arena);
+    return 0;
+}
+
+int test_ring_allocator(void)
+{
+    Ring_Allocator ring;
+    Allocator allocator;
+    Byte *a, *b, *c, *d;
+
+    CHECK(Ring_Allocator_Init(&ring, &allocator_libc, 256));
+    allocator = Ring_Allocator_Interface(&ring);
+
+    /* 16 byte header + 48 bytes per block */
+    a = Allocator_Alloc(48, false, 8, &allocator);
+    b = Allocator_Alloc(48, false, 8, &allocator);
+    c = Allocator_Alloc(48, true, 8, &allocator);
+    CHECK(a == ring.buffer + 16 && b == a + 64 && c == b + 64 && c[47] == 0);
+    CHECK(ring.used == 192 && Allocator_Alloc(100, false, 8, &allocator) == NULL);
+
+    /* out of order frees wait for the older blocks */
+    CHECK(Allocator_Free(b, &allocator) && ring.tail == 0 && ring.used == 192);
+    CHECK(Allocator_Free(a, &allocator) && ring.tail == 128 && ring.used == 64);
+    CHECK(!Allocator_Free(a, &allocator) && allocator.error == ALLOCATOR_ERROR_INVALID_POINTER);
+
+    /* the end of the buffer is skipped to wrap to the front */
+    d = Allocator_Alloc(80, false, 8, &allocator);
+    CHECK(d == ring.buffer + 16 && ring.head == 96 && ring.used == 224);
+    CHECK(Allocator_Free(c, &allocator) && ring.tail == 0 && ring.used == 96);
+
+    /* the newest block grows in place */
+    d[0] = 42;
+    CHECK(Allocator_Resize(d, 200, 80, true, 8, &allocator) == d && d[0] == 42 && d[199] == 0);
+    CHECK(ring.head == 224 && ring.used == 224);
+
+    a = Allocator_Alloc(8, false, 64, &allocator);
+    CHECK(a == NULL);
+    CHECK(Allocator_Free(d, &allocator) && ring.used == 0);
+    a = Allocator_Alloc(8, false, 64, &allocator);
+    CHECK(a != NULL && (uintptr_t)a % 64 == 0);
+    CHECK(Allocator_Free(a, &allocator) && ring.used == 0);
+    /* a block at a non power of two alignment could never be found to free */
+    CHECK(Allocator_Alloc(8, false, 24, &allocator) == NULL && allocator.error == ALLOCATOR_ERROR_INVALID_ARGUMENT);
+    CHECK(ring.used == 0);
+
+    CHECK(Allocator_Alloc(8, false, 8, &allocator) != NULL);
+    CHECK(Allocator_Free_all(&allocator) && ring.used == 0 && ring.head == 0);
+    Ring_Allocator_Deinit(&ring);
+    return 0;
+}
+
+int test_stack_allocator(void)
+{
+    Stack_Allocator stack;
+    Allocator allocator;
+    Byte *a, *b, *c;
+#ifndef NDEBUG
+    pid_t child;
+    int status;
+#endif
+
+    CHECK(Stack_Allocator_Init(&stack, &allocator_libc, 1024));
+    allocator = Stack_Allocator_Interface(&stack);
+
+    a = Allocator_Alloc(100, true, 8, &allocator);
+    b = Allocator_Alloc(100, false, 64, &allocator);
+    CHECK(a != NULL && a[99] == 0 && b > a + 100 && (uintptr_t)b % 64 == 0);
+    CHECK(stack.buffer + stack.top == b && stack.offset == stack.top + 100);
+
+    /* only the top grows in place, the others can only shrink */
+    CHECK(Allocator_Resize(b, 300, 100, true, 64, &allocator) == b && b[299] == 0);
+    CHECK(Allocator_Resize(a, 200, 100, false, 8, &allocator) == NULL);
+    CHECK(Allocator_Resize(a, 50, 100, false, 8, &allocator) == a);
+    CHECK(Allocator_Alloc(1024, false, 8, &allocator) == NULL);
+
+    /* frees pop back to where the stack was */
+    CHECK(Allocator_Free(b, &allocator) && stack.buffer + stack.top == a);
+    c = Allocator_Alloc(8, false, 8, &allocator);
+    CHECK(c != NULL && c < b);
+    CHECK(Allocator_Free(c, &allocator) && Allocator_Free(a, &allocator));
+    CHECK(stack.top == 0 && stack.offset == 0);
+
+#ifndef NDEBUG
+    /* freeing out of order asserts in debug builds */
+    a = Allocator_Alloc(8, false, 8, &allocator);
+    b = Allocator_Alloc(8, false, 8, &allocator);
+    child = fork();
+    CHECK(child >= 0);
+    if (child == 0)
+    {
+        freopen("/dev/null", "w", stderr);
+        Allocator_Free(a, &allocator);
+        _exit(0);
+    }
+    CHECK(waitpid(child, &status, 0) == child && WIFSIGNALED(status));
+#endif
+
+    CHECK(Allocator_Free_all(&allocator) && stack.top == 0);
+    Stack_Allocator_Deinit(&stack);
+    return 0;
+}
+
+typedef struct
+{
+    Allocator *allocator;
+    Byte **blocks;
+    int count;
+} Remote_Free_Job;
+
+static void *remote_free_thread(void *arg)
+{
+    Remote_Free_Job *job = arg;
+    int i;
+    for (i = 0; i < job->count; i++)
+        if (!Allocator_Free(job->blocks[i], job->allocator)) return arg;
+    return NULL;
+}
+
+int test_remote_free(void)
+{
+    Ring_Allocator ring;
+    Allocator ring_allocator, allocator;
+    Remote_Free_Allocator remote;
+    Remote_Free_Job jobs[2];
+    Byte *blocks[200];
+    pthread_t threads[2];
+    void *result;
+    int i;
+
+    CHECK(Ring_Allocator_Init(&ring, &allocator_libc, 1 << 16));
+    ring_allocator = Ring_Allocator_Interface(&ring);
+    Remote_Free_Allocator_Init(&remote, &ring_allocator);
+    allocator = Remote_Free_Allocator_Interface(&remote);
+
+    for (i = 0; i < 200; i++) CHECK((blocks[i] = Allocator_Alloc(48, false, 8, &allocator)) != NULL);
+    CHECK(ring.used == 200*64);
+
+    /* two consumers free into the single threaded ring without touching it */
+    for (i = 0; i < 2; i++)
+    {
+        jobs[i] = (Remote_Free_Job){ .allocator = &allocator, .blocks = &blocks[i*100], .count = 100 };
+        CHECK(pthread_create(&threads[i], NULL, remote_free_thread, &jobs[i]) == 0);
+    }
+    for (i = 0; i < 2; i++) CHECK(pthread_join(threads[i], &result) == 0 && result == NULL);
+    CHECK(ring.used == 200*64 && remote.remote != NULL);
+
+    /* the owner frees them all on its next allocation */
+    blocks[0] = Allocator_Alloc(48, false, 8, &allocator);
+    CHECK(blocks[0] != NULL && remote.remote == NULL && remote.remote_frees == 200);
+    CHECK(ring.used == 64);
+    CHECK(Allocator_Free(blocks[0], &allocator) && ring.used == 0);
+
+    Remote_Free_Allocator_Deinit(&remote);
+    Ring_Allocator_Deinit(&ring);
+    return 0;
+}
+
+int test_allocator_combinators(void)
+{
+    Ring_Allocator ring;
+    Stack_Allocator stack;
+    Allocator ring_allocator, stack_allocator, allocator, *buckets[3];
+    Fallback_Allocator fallback;
+    Segregator_Allocator segregator;
+    Bucketizer_Allocator bucketizer;
+    USize max_sizes[3] = {64, 256, 4096};
+    Byte *a, *b;
+
+    CHECK(Ring_Allocator_Init(&ring, &allocator_libc, 256));
+    CHECK(Stack_Allocator_Init(&stack, &allocator_libc, 1024));
+    ring_allocator  = Ring_Allocator_Interface(&ring);
+    stack_allocator = Stack_Allocator_Interface(&stack);
+
+    /* ring first, libc once it is full, frees go back to the owner */
+    CHECK(!Fallback_Allocator_Init(&fallback, &allocator_libc, &ring_allocator));
+    CHECK(Fallback_Allocator_Init(&fallback, &ring_allocator, &allocator_libc));
+    allocator = Fallback_Allocator_Interface(&fallback);
+    CHECK(!(allocator.implemented_modes & ALLOCATOR_MODE_OWNS));
+    a = Allocator_Alloc(200, false, 8, &allocator);
+    b = Allocator_Alloc(200, true, 8, &allocator);
+    CHECK(Allocator_Owns(a, &ring_allocator) && b != NULL && !Allocator_Owns(b, &ring_allocator) && b[199] == 0);
+    a[0] = 7;
+    a = Allocator_Resize(a, 1000, 200, true, 8, &allocator);
+    CHECK(a != NULL && !Allocator_Owns(a, &ring_allocator) && a[0] == 7 && a[999] == 0 && ring.used == 0);
+    CHECK(Allocator_Free(a, &allocator) && Allocator_Free(b, &allocator));
+
+    /* small sizes from the stack, large ones from libc */
+    CHECK(Segregator_Allocator_Init(&segregator, 64, &stack_allocator, &allocator_libc));
+    allocator = Segregator_Allocator_Interface(&segregator);
+    a = Allocator_Alloc(32, false, 8, &allocator);
+    b = Allocator_Alloc(1000, false, 8, &allocator);
+    CHECK(Allocator_Owns(a, &stack_allocator) && b != NULL && !Allocator_Owns(b, &stack_allocator));
+    CHECK(Allocator_Free(b, &allocator) && Allocator_Free(a, &allocator) && stack.top == 0);
+
+    /* one allocator per size range */
+    buckets[0] = &stack_allocator;
+    buckets[1] = &ring_allocator;
+    buckets[2] = &allocator_libc;
+    CHECK(Bucketizer_Allocator_Init(&bucketizer, 3, max_sizes, buckets));
+    allocator = Bucketizer_Allocator_Interface(&bucketizer);
+    a = Allocator_Alloc(64, false, 8, &allocator);
+    b = Allocator_Alloc(65, false, 8, &allocator);
+    CHECK(Allocator_Owns(a, &stack_allocator) && Allocator_Owns(b, &ring_allocator));
+    CHECK(Allocator_Alloc(5000, false, 8, &allocator) == NULL);
+    b = Allocator_Resize(b, 2000, 65, false, 8, &allocator);
+    CHECK(b != NULL && !Allocator_Owns(b, &ring_allocator) && ring.used == 0);
+    CHECK(Allocator_Free(b, &allocator) && Allocator_Free(a, &allocator) && stack.top == 0);
+
+    Stack_Allocator_Deinit(&stack);
+    Ring_Allocator_Deinit(&ring);
+    return 0;
+}
+
+int test_libc_large_blocks(void)
+{
+    USize size = ALLOCATOR_LIBC_MAP_THRESHOLD * 2;
+    Byte *a, *b;
+
+    /* large blocks are page aligned mappings */
+    a = Allocator_Alloc_64(size, false, 16, &allocator_libc);
+    CHECK(a != NULL);
+#ifdef BUN_ALLOCATOR__MREMAP
+    CHECK((uintptr_t)a % 4096 == 0);
+#endif
+    a[0] = 1;
+    a[size - 1] = 2;
+
+    /* growing remaps, the new pages come zeroed */
+    a = Allocator_Resize_64(a, size * 32, size, true, 16, &allocator_libc);
+    CHECK(a != NULL && a[0] == 1 && a[size - 1] == 2 && a[size] == 0 && a[size * 32 - 1] == 0);
+    a = Allocator_Resize_64(a, 100, size * 32, false, 16, &allocator_libc);
+    CHECK(a != NULL && a[0] == 1);
+    a[99] = 3;
+    a = Allocator_Resize_64(a, 8192, 100, true, 16, &allocator_libc);
+    CHECK(a != NULL && a[99] == 3 && a[100] == 0 && a[8191] == 0);
+    CHECK(Allocator_Free(a, &allocator_libc));
+
+    /* small blocks move to a mapping once they grow past the threshold */
+    b = Allocator_Alloc_64(1000, false, 16, &allocator_libc);
+    CHECK(b != NULL);
+    b[999] = 4;
+    b = Allocator_Resize_64(b, size, 1000, true, 16, &allocator_libc);
+    CHECK(b != NULL && b[999] == 4 && b[1000] == 0);
+#ifdef BUN_ALLOCATOR__MREMAP
+    CHECK((uintptr_t)b % 4096 == 0);
+#endif
+    CHECK(Allocator_Free(b, &allocator_libc));
+
+    /* without an old size the block can not be copied to a mapping, realloc keeps the contents */
+    b = Allocator_Alloc_64(1000, false, 16, &allocator_libc);
+    CHECK(b != NULL);
+    b[999] = 5;
+    b = Allocator_Resize_64(b, size, 0, false, 16, &allocator_libc);
+    CHECK(b != NULL && b[999] == 5);
+    CHECK(Allocator_Free(b, &allocator_libc));
+
+    /* page aligned malloc blocks are not mistaken for mappings */
+    CHECK(posix_memalign((void **)&b, 4096, 8192) == 0);
+    b[0] = 6;
+    b = Allocator_Resize_64(b, 16384, 8192, false, 16, &allocator_libc);
+    CHECK(b != NULL && b[0] == 6);
+    CHECK(Allocator_Free(b, &allocator_libc));
+    return 0;
+}
+
+static void *timed_thread(void *arg)
+{
+    Allocator *allocator = arg;
+    void *ptr;
+    int i;
+    for (i = 0; i < 1000; i++)
+    {
+        if ((ptr = Allocator_Alloc(64, false, 16, allocator)) == NULL) return arg;
+        if (!Allocator_Free(ptr, allocator)) return arg;
+    }
+    return NULL;
+}
+
+int test_timed_allocator(void)
+{
+    static Latency_Histogram a, b, snapshot[TIMED_ALLOCATOR_MODES];
+    static Timed_Allocator timed;
+    Allocator allocator;
+    Dynamic_Arena arena;
+    pthread_t threads[4];
+    void *result;
+    char report[1024];
+    U64 total;
+    U32 i;
+
+    /* exact below 32ns, within 1/16 above */
+    Latency_Histogram_Reset(&a);
+    CHECK(Latency_Histogram_Percentile(&a, 50) == 0);
+    for (i = 1; i <= 1000; i++) Latency_Histogram_Record(&a, i);
+    CHECK(a.count == 1000 && a.min_ns == 1 && a.max_ns == 1000 && a.sum_ns == 500500);
+    CHECK(Latency_Histogram_Percentile(&a, 1) == 10);
+    CHECK(Latency_Histogram_Percentile(&a, 50) >= 500 && Latency_Histogram_Percentile(&a, 50) <= 500 + 500/16);
+    CHECK(Latency_Histogram_Percentile(&a, 99.9) >= 999 && Latency_Histogram_Percentile(&a, 99.9) <= 1000);
+    CHECK(Latency_Histogram_Percentile(&a, 100) == 1000);
+    Latency_Histogram_Record(&a, (U64)1 << 50);
+    CHECK(a.buckets[LATENCY_BUCKETS - 1] == 1 && Latency_Histogram_Percentile(&a, 100) == (U64)1 << 50);
+
+    Latency_Histogram_Reset(&b);
+    Latency_Histogram_Record(&b, 0);
+    Latency_Histogram_Merge(&b, &a);
+    CHECK(b.count == 1002 && b.min_ns == 0 && b.max_ns == (U64)1 << 50 && b.buckets[0] == 1 && b.buckets[10] == 1);
+
+    /* pool creation and pools array growth of a dynamic arena go through the backing allocator */
+    Timed_Allocator_Init(&timed, &allocator_libc, "pools");
+    allocator = Timed_Allocator_Interface(&timed);
+    CHECK(allocator.implemented_modes == allocator_libc.implemented_modes);
+    CHECK(Dynamic_Arena_Init(&arena, &allocator, 4096, false, 8));
+    for (i = 0; i < 100; i++) CHECK(Dynamic_Arena_Alloc_Push(1000, false, 8, &arena) != NULL);
+    Dynamic_Arena_Deinit(&arena);
+    Timed_Allocator_Snapshot(&timed, snapshot, true);
+    CHECK(snapshot[0].count + snapshot[1].count >= 25 && snapshot[2].count >= 25);
+    CHECK(snapshot[2].min_ns <= snapshot[2].max_ns && snapshot[3].count == 0 && snapshot[3].min_ns == (U64)-1);
+    CHECK(timed.histograms[0].count == 0 && timed.histograms[2].count == 0);
+
+    /* threads share one timed allocator */
+    for (i = 0; i < 4; i++) CHECK(pthread_create(&threads[i], NULL, timed_thread, &allocator) == 0);
+    for (i = 0; i < 4; i++) CHECK(pthread_join(threads[i], &result) == 0 && result == NULL);
+    Timed_Allocator_Snapshot(&timed, snapshot, false);
+    CHECK(snapshot[1].count == 4000 && snapshot[2].count == 4000);
+    for (total = 0, i = 0; i < LATENCY_BUCKETS; i++) total += snapshot[1].buckets[i];
+    CHECK(total == 4000);
+
+    CHECK(Timed_Allocator_Report(&timed, report, sizeof(report)) > 0);
+    CHECK(strstr(report, "pools alloc_non_zeroed count=4000 ") != NULL && strstr(report, "pools free count=4000 ") != NULL);
+    CHECK(strstr(report, "p999_ns=") != NULL && strstr(report, "pools owns") == NULL);
+    CHECK(Timed_Allocator_Report(&timed, report, 16) == 0);
+
+    Timed_Allocator_Reset(&timed);
+    Timed_Allocator_Snapshot(&timed, snapshot, false);
+    CHECK(snapshot[1].count == 0 && snapshot[1].max_ns == 0 && snapshot[1].min_ns == (U64)-1);
+    return 0;
+}
+
+#ifdef BUN_PROFILE_CALLSITES
+static Profile_Callsite *find_callsite(Profile_Callsite *sites, U32 count, U32 line)
+{
+    U32 i;
+    for (i = 0; i < count; i++)
+    {
+        if (sites[i].line == line && strcmp(sites[i].file, __FILE__) == 0) return &sites[i];
+    }
+    return NULL;
+}
+
+int test_profile_callsites(void)
+{
+    Profile_Callsite sites[16], *site;
+    Dynamic_Arena arena;
+    char report[4096];
+    char expected[256];
+    void *ptrs[100];
+    U32 count, i, alloc_line, push_line, sampled_line;
+
+    Profile_Reset();
+    CHECK(Dynamic_Arena_Init(&arena, &allocator_libc, 4096, false, 16));
+
+    alloc_line = __LINE__ + 1;
+    for (i = 0; i < 10; i++) ptrs[i] = Allocator_Alloc(100, false, 16, &allocator_libc);
+    for (i = 0; i < 4; i++) Allocator_Free(ptrs[i], &allocator_libc);
+    push_line = __LINE__ + 1;
+    for (i = 0; i < 3; i++) CHECK(Dynamic_Arena_Alloc_Push(1000, false, 16, &arena) != NULL);
+
+    count = Profile_Snapshot(sites, 16);
+    site = find_callsite(sites, count, alloc_line);
+    CHECK(site != NULL && site->kind == PROFILE_ALLOCATOR_ALLOC);
+    CHECK(site->count == 10 && site->bytes == 1000 && site->live_count == 6 && site->live_bytes == 600);
+    site = find_callsite(sites, count, push_line);
+    CHECK(site != NULL && site->kind == PROFILE_DYNAMIC_ARENA_PUSH);
+    CHECK(site->count == 3 && site->bytes == 3000 && site->live_bytes == 3000);
+    CHECK(sites[0].bytes >= sites[count - 1].bytes);
+
+    /* free_all drops everything the arena allocated */
+    Dynamic_Arena_Free_All(&arena, false);
+    count = Profile_Snapshot(sites, 16);
+    site = find_callsite(sites, count, push_line);
+    CHECK(site != NULL && site->live_count == 0 && site->bytes == 3000);
+
+    sprintf(expected, "%s:%u;Bun_Allocator_Alloc 1000\n", __FILE__, alloc_line);
+    CHECK(Profile_Report(PROFILE_REPORT_FOLDED_BYTES, report, sizeof(report)) != 0);
+    CHECK(strstr(report, expected) != NULL);
+    sprintf(expected, "%s:%u;Bun_Allocator_Alloc 600\n", __FILE__, alloc_line);
+    CHECK(Profile_Report(PROFILE_REPORT_FOLDED_LIVE, report, sizeof(report)) != 0);
+    CHECK(strstr(report, expected) != NULL);
+    CHECK(Profile_Report(PROFILE_REPORT_TEXT, report, 8) == 0);
+    for (i = 4; i < 10; i++) Allocator_Free(ptrs[i], &allocator_libc);
+
+    /* sampled, 6400 bytes every 4096 bytes is 2 recorded allocations */
+    profile_config.sample_interval = 4096;
+    sampled_line = __LINE__ + 1;
+    for (i = 0; i < 100; i++) ptrs[i] = Allocator_Alloc(64, false, 16, &allocator_libc);
+    count = Profile_Snapshot(sites, 16);
+    site = find_callsite(sites, count, sampled_line);
+    CHECK(site != NULL && site->bytes == 8192 && site->count == 128 && site->live_bytes == 8192);
+    for (i = 0; i < 100; i++) Allocator_Free(ptrs[i], &allocator_libc);
+    count = Profile_Snapshot(sites, 16);
+    site = find_callsite(sites, count, sampled_line);
+    CHECK(site != NULL && site->live_count == 0);
+    profile_config.sample_interval = 0;
+
+    Dynamic_Arena_Deinit(&arena);
+    return 0;
+}
+#endif
+
 int main(void)
 {
     Arena arena;
@@ -27,5 +1103,30 @@ int main(void)
     printf("ascii range: '%s'\n", str);
 
     Arena_Deinit_From_Allocator(&arena, &allocator_libc);
+
+    if (test_usize()) return 1;
+    if (test_inline_fast_paths()) return 1;
+    if (test_typed_pool()) return 1;
+    if (test_ring_allocator()) return 1;
+    if (test_stack_allocator()) return 1;
+    if (test_remote_free()) return 1;
+    if (test_allocator_combinators()) return 1;
+    if (test_libc_large_blocks()) return 1;
+    if (test_timed_allocator()) return 1;
+#ifdef BUN_PROFILE_CALLSITES
+    if (test_profile_callsites()) return 1;
+#endif
+    if (test_numa()) return 1;
+    if (test_size_header()) return 1;
+    if (test_large_objects()) return 1;
+    if (test_pool_cache()) return 1;
+    if (test_profile()) return 1;
+    if (test_stats()) return 1;
+    if (test_file_arena()) return 1;
+    if (test_offset_ptr()) return 1;
+    if (test_compact_arena()) return 1;
+    if (test_shared_arena()) return 1;
+    if (test_snapshot_arena()) return 1;
+    if (test_memory_zero()) return 1;
     return 0;
 }